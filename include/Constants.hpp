@@ -8,13 +8,9 @@
 
 using uint = unsigned int;
 
-namespace Chassis {
-    inline constexpr float AXLE_LENGTH = 13.35f;
-    inline constexpr float WHEEL_RADIUS = 3.01625f;
-
-    inline constexpr float DOWEL_DISTANCE = 2.314066f;
-
-    inline constexpr float MASS = 0.786f;
+namespace Comms {
+    inline constexpr size_t MAX_PAYLOAD_SIZE = 250u;
+    inline constexpr size_t MAX_FRAME_SIZE = MAX_PAYLOAD_SIZE + 2u + 2u + 1u;
 }
 
 namespace Constants {
@@ -41,6 +37,18 @@ namespace Drivers {
 
         inline constexpr size_t GYRO_CALIBRATION_SAMPLE_COUNT = 131072u;
         inline constexpr size_t DOWN_DIRECTION_SAMPLE_COUNT = 4096u;
+
+        inline constexpr size_t VERIFICATION_BIAS_SAMPLE_COUNT = 4096u;
+        inline constexpr size_t VERIFICATION_DOWN_SAMPLE_COUNT = 256u;
+        inline constexpr float MAX_CACHED_BIAS_ERROR = 0.002f;
+        inline constexpr float MIN_CACHED_DOWN_ALIGNMENT = 0.9995f;
+        inline constexpr float MAX_CACHED_TEMPERATURE_ERROR = 3.0f;
+
+        inline constexpr float TEMPERATURE_SENSITIVITY = 132.48f;
+        inline constexpr float TEMPERATURE_OFFSET = 25.0f;
+
+        // the sensor runs off its own clock, so its 32kHz is measured against ours before a run
+        inline constexpr float SAMPLE_PERIOD_MEASUREMENT_TIME = 0.1f;
     }
 
     namespace LedRGB {
@@ -60,6 +68,11 @@ namespace Drivers {
 
         inline constexpr uint16_t PWM_WRAP = MAX_POWER - 1u;
         inline constexpr uint32_t TARGET_CLK_FREQUENCY = PWM_FREQUENCY * MAX_POWER;
+
+        // Integration::PWM_SYNCHRONOUS_CURRENT_SAMPLING. slices whose pins the rp2350a does not
+        // bond out, counting alongside the motors to start and stop each period's conversions
+        inline constexpr uint SAMPLE_START_SLICE = 10u;
+        inline constexpr uint SAMPLE_STOP_SLICE = 11u;
     }
 }
 
@@ -68,6 +81,35 @@ namespace Integration {
     inline constexpr float TARGET_SLOW_LOOP_HZ = 10.0e3f;
     // inline constexpr float TARGET_SLOW_LOOP_HZ = 2.0e3f;
 
+    // the fast loop runs once per gyroscope sample off its data ready dma, so every sample is used
+    // exactly once. false falls back to a free running timer at FAST_LOOP_US
+    inline constexpr bool DATA_READY_FAST_LOOP = true;
+
+    // times every stage of both loops in cpu cycles for rotour-cli stages and the final report.
+    // false compiles the timers out, leaving the loops exactly as they would be without them
+    inline constexpr bool PROFILE_STAGES = true;
+
+    // the gains in Parameters::TABLE can be set over usb and are kept in flash. false makes every
+    // one of them the robot profile's constant again, for a build that has been tuned
+    inline constexpr bool TUNABLE_PARAMETERS = true;
+
+    // refines the linear velocity feedforward during a run and keeps what it settled on as the
+    // parameters for the next one. needs TUNABLE_PARAMETERS to keep anything
+    inline constexpr bool ADAPTIVE_FEEDFORWARD = false;
+
+    // the battery is sampled with the motor currents and the duty cycles planned against what it
+    // sags to under them. false divides by the voltage it had at boot
+    inline constexpr bool BATTERY_SAG_MODEL = true;
+
+    // the current limit follows a model of each winding's temperature, so a cool motor can take
+    // a burst of PEAK_CURRENT. false holds both at MAX_CURRENT
+    inline constexpr bool THERMAL_CURRENT_LIMIT = true;
+
+    // the motor pwm paces the adc, one round robin centred on every drive pulse, so the currents
+    // are the average through each pulse instead of wherever the ripple was. false leaves the
+    // round robin free running
+    inline constexpr bool PWM_SYNCHRONOUS_CURRENT_SAMPLING = true;
+
     inline constexpr float CALIBRATION_DELAY = 1.0f;
     inline constexpr float FINAL_STATE_MEASUREMENT_DELAY = 1.0f;
 
@@ -85,8 +127,8 @@ namespace Kinematics {
     namespace Forward {
         inline constexpr size_t MA_FILTER_LENGTH = 50u;
 
-        inline constexpr float VELOCITY_CUTOFF_FREQUENCY = 50.0f;
-        inline constexpr float WHEEL_SPEED_CUTOFF_FREQUENCY = 100.0f;
+        // an older state means core1 has stalled, extrapolating further would only add error
+        inline constexpr float MAX_PREDICTION_TIME = 4.0f * Integration::TARGET_FAST_LOOP_DT;
     }
 
     namespace Inverse {
@@ -94,45 +136,6 @@ namespace Kinematics {
     }
 }
 
-namespace Manager {
-    namespace Follower {
-        inline constexpr float DISTANCE_THRESHOLD_ACCURATE = 0.0f;
-        inline constexpr float DISTANCE_THRESHOLD_FAST = 0.0f;
-        inline constexpr float TURNING_RADIUS = 20.0f;
-
-        inline constexpr float ANGLE_THRESHOLD = 0.05f;
-    }
-
-    namespace Straight {
-        inline constexpr float SLOWDOWN_ACCEL = 40.0f;
-        inline constexpr float SLOWDOWN_MIN_SPEED = 4.0f;
-
-        inline constexpr float angularKp = 20.0f;
-        inline constexpr float angularKd = 0.2f;
-
-        inline constexpr float linearKp = 2.0f;
-        inline constexpr float linearKd = 0.1f;
-        inline constexpr float LINEAR_CONTROL_AUTHORITY = 0.3f;
-
-        inline constexpr float FILTER_ALPHA = 1.0f;
-        inline constexpr float CENTRIPETAL_FILTER_CUTOFF = 25.0f;
-
-        inline constexpr float MAX_CENTRIPETAL = 60.0f;
-        inline constexpr float TURN_ANGULAR_SPEED = 3.5f;
-        inline constexpr float MAX_LINEAR_SPEED = 500.0f;
-    }
-
-    namespace Rotation {
-        inline constexpr float kS = 2.0f;
-        inline constexpr float kP = 3.5f;
-
-        inline constexpr float GRABBING_SPEED = 2.0f;
-
-        inline constexpr float MAX_SPEED = 2.0f;
-        inline constexpr float TURN_TIME_OFFSET = 1.0f;
-    }
-}
-
 namespace Pins {
     namespace Battery {
         inline constexpr uint VOLTAGE_SENSE = 27u;
@@ -177,53 +180,14 @@ namespace Pins {
     }
 }
 
-namespace Regulators {
-    namespace Current {
-        inline constexpr float MAX_CURRENT = 0.40f;
-
-        inline constexpr Vec2 RESISTANCE{ 3.30982f, 3.33778f };
-        inline constexpr Vec2 FREE_ANGULAR_VEL{ 91.0553f, 90.0371f };
-        inline constexpr Vec2 FREE_VOLTAGE{ 10.5f, 10.5f };
-        inline constexpr Vec2 FREE_CURRENT{ 0.0576f, 0.0608f };
-
-        inline constexpr Vec2 KV = FREE_ANGULAR_VEL / (FREE_VOLTAGE - FREE_CURRENT * RESISTANCE);
-    }
-
-    namespace Velocity {
-        inline constexpr float ANGLE_CONTROL_MIN_VOLTAGE_BUDGET = 0.3f;
-        inline constexpr float LINEAR_VELOCITY_VOLTAGE_BUDGET = 1.0f -
-                                                                ANGLE_CONTROL_MIN_VOLTAGE_BUDGET;
-        inline constexpr float OFFSET = 0.85f;
-
-        namespace Linear {
-            inline constexpr float kS = 0.4f;
-            inline constexpr float kV = 0.037f;
-            inline constexpr float kA = 0.001f;
-            inline constexpr float kP = 0.08f;
-            inline constexpr float kI = 0.08f;
-
-            inline constexpr float MIN_INT = -1.0f;
-            inline constexpr float MAX_INT = 1.0f;
-
-            inline constexpr float FILTER_ALPHA = 1.0f;
-            inline constexpr float LAG_FILTER_K = 0.05f;
-        }
+namespace Recording {
+    // the run is recorded from the start, the sample buffers fill most of the ram
+    inline constexpr float DURATION = 0.6f;
 
-        namespace Angular {
-            inline constexpr float kS = 0.0f;
-            inline constexpr float kV = 0.7f;
-            inline constexpr float kA = 0.0f;
-            inline constexpr float kP = 1.0f;
-            inline constexpr float kI = 0.0f;
-
-            inline constexpr float MIN_INT = -10.0f;
-            inline constexpr float MAX_INT = 10.0f;
-
-            inline constexpr float FILTER_ALPHA = 1.0f;
-
-            inline constexpr float LAG_FILTER_K = 0.05f;
-        }
-    }
+    inline constexpr size_t FAST_SAMPLE_CAPACITY = static_cast<size_t>(
+        DURATION * Integration::TARGET_FAST_LOOP_HZ);
+    inline constexpr size_t SLOW_SAMPLE_CAPACITY = static_cast<size_t>(
+        DURATION * Integration::TARGET_SLOW_LOOP_HZ);
 }
 
 namespace Status {
@@ -239,8 +203,33 @@ namespace Status {
     inline constexpr Vec3 FINISHED{ 0.0f, 1.0f, 0.0f };
 }
 
+namespace Storage {
+    inline constexpr uint32_t PAGE_SIZE = 256u;
+    inline constexpr uint32_t SECTOR_SIZE = 4096u;
+    inline constexpr uint32_t SECTOR_COUNT = 16u;
+    inline constexpr uint32_t REGION_SIZE = SECTOR_SIZE * SECTOR_COUNT;
+
+    inline constexpr size_t MAX_KEYS = 32u;
+    inline constexpr uint32_t RESERVE_SECTORS = 1u;
+    inline constexpr uint32_t WEAR_LEVELLING_THRESHOLD = 32u;
+
+    inline constexpr uint32_t LOCKOUT_TIMEOUT_MS = 100u;
+}
+
+namespace Telemetry {
+    // every slow loop iteration would be more than usb full speed carries, so only every
+    // DECIMATION-th is streamed
+    inline constexpr float SAMPLE_HZ = 1.0e3f;
+    inline constexpr size_t DECIMATION = static_cast<size_t>(Integration::TARGET_SLOW_LOOP_HZ /
+                                                             SAMPLE_HZ);
+
+    // samples waiting for the link, a power of two so the indices can wrap
+    inline constexpr size_t QUEUE_CAPACITY = 128u;
+}
+
 namespace Track {
     inline constexpr float SQUARE_SIZE = 50.0f;
+    inline constexpr size_t MAX_ROUTE_LENGTH = 128u;
 
     inline constexpr float FAILED_RUN_DELAY = 2.5f;
     inline constexpr float FAILED_RUN_MOTOR_SPEED = 0.1f;
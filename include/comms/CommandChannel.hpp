@@ -0,0 +1,263 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "comms/Frame.hpp"
+#include "comms/Protocol.hpp"
+#include "comms/Transport.hpp"
+
+#include "path/Compiler.hpp"
+#include "path/Route.hpp"
+
+#include "profiling/Stages.hpp"
+
+#include "recording/Recorder.hpp"
+
+#include "startup/Startup.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+template <TransportType Transport>
+class CommandChannel {
+public:
+    CommandChannel(Transport& transport, Route& route, Startup const& startup,
+                   Recorder const& recorder, Stages::Profile const& profile)
+        : m_transport{ transport },
+          m_route{ route },
+          m_startup{ startup },
+          m_recorder{ recorder },
+          m_profile{ profile } {}
+
+    CommandChannel(CommandChannel const&) = delete;
+    CommandChannel& operator=(CommandChannel const&) = delete;
+    CommandChannel(CommandChannel&&) = delete;
+    CommandChannel& operator=(CommandChannel&&) = delete;
+
+    // the route is only modified while unlocked so nothing changes under a running follower
+    void lock() { m_locked = true; }
+    void unlock() { m_locked = false; }
+
+    // set whenever an upload or target time change has been applied to the route
+    bool takeRouteChanged() {
+        bool const changed = m_routeChanged;
+        m_routeChanged = false;
+        return changed;
+    }
+
+    // set whenever a parameter has been changed
+    bool takeParametersChanged() {
+        bool const changed = m_parametersChanged;
+        m_parametersChanged = false;
+        return changed;
+    }
+
+    void poll() {
+        while (auto const byte = m_transport.read())
+            if (auto const payload = m_decoder.push(*byte)) handle(*payload);
+    }
+
+private:
+    using Message = Protocol::Message;
+    using Error = Protocol::Error;
+
+    void handle(std::span<uint8_t const> payload) {
+        Protocol::Reader reader{ payload };
+        auto const type = reader.read<uint8_t>();
+        auto const sequence = reader.read<uint8_t>();
+        if (!sequence) return;
+
+        m_sequence = *sequence;
+
+        switch (static_cast<Message>(*type)) {
+        case Message::PING: return acknowledge();
+        case Message::UPLOAD_COMMANDS: return uploadCommands(reader);
+        case Message::SET_TARGET_TIME: return setTargetTime(reader);
+        case Message::SET_PARAMETER: return setParameter(reader);
+        case Message::GET_ROUTE_INFO: return sendRouteInfo();
+        case Message::GET_ROUTE: return sendRoute(reader);
+        case Message::GET_STARTUP_TIMES: return sendStartupTimes();
+        case Message::GET_RECORDING: return sendRecording(reader);
+        case Message::GET_STAGE_TIMES: return sendStageTimes(reader);
+        case Message::GET_PARAMETERS: return sendParameters();
+        default: return reject(Error::UNKNOWN_MESSAGE);
+        }
+    }
+
+    void uploadCommands(Protocol::Reader& reader) {
+        auto const index = reader.read<uint16_t>();
+        auto const total = reader.read<uint16_t>();
+        if (!total) return reject(Error::MALFORMED);
+        if (m_locked) return reject(Error::BUSY);
+        if (*total == 0u || *total > Route::CAPACITY) return reject(Error::TOO_LONG);
+
+        bool const restarting = *index == 0u;
+        if (!restarting && (*index != m_pendingSize || *total != m_pendingTotal))
+            return reject(Error::OUT_OF_ORDER);
+
+        if (restarting) {
+            m_pendingSize = 0u;
+            m_pendingTotal = *total;
+        }
+
+        while (reader.remaining() > 0u) {
+            auto const command = reader.readCommand();
+            if (!command) return reject(Error::MALFORMED);
+            if (m_pendingSize == m_pendingTotal) return reject(Error::TOO_LONG);
+
+            m_pendingCommands[m_pendingSize++] = *command;
+        }
+
+        if (m_pendingSize == m_pendingTotal) {
+            // the pending buffer takes the old commands in exchange, and is not read again
+            // until the next upload starts over
+            if (!m_route.setIfFeasible(m_pendingCommands, m_pendingSize, m_route.targetTime()))
+                return reject(Error::INVALID_ROUTE);
+            m_routeChanged = true;
+        }
+
+        acknowledge();
+    }
+
+    void setTargetTime(Protocol::Reader& reader) {
+        auto const targetTime = reader.read<float>();
+        if (!targetTime) return reject(Error::MALFORMED);
+        if (m_locked) return reject(Error::BUSY);
+        if (!m_route.setTargetTimeIfFeasible(*targetTime)) return reject(Error::INVALID_ROUTE);
+        m_routeChanged = true;
+
+        acknowledge();
+    }
+
+    // the fast loop is built from the parameters as soon as the robot starts calibrating, so they
+    // are fixed from the calibration click on
+    void setParameter(Protocol::Reader& reader) {
+        auto const id = reader.read<uint8_t>();
+        auto const value = reader.read<float>();
+        if (!value) return reject(Error::MALFORMED);
+        if (m_locked || m_startup.completed(Startup::Phase::CALIBRATION_CLICK))
+            return reject(Error::BUSY);
+        if (!Parameters::set(*id, *value)) return reject(Error::INVALID_PARAMETER);
+        m_parametersChanged = true;
+
+        acknowledge();
+    }
+
+    void sendRouteInfo() {
+        auto writer = beginReply(Message::ROUTE_INFO);
+        writer.write(Protocol::RouteInfo{ static_cast<uint16_t>(m_route.size()),
+                                          m_route.targetTime(), m_route.destination() });
+        send(writer);
+    }
+
+    void sendRoute(Protocol::Reader& reader) {
+        auto const index = reader.read<uint16_t>();
+        auto const count = reader.read<uint16_t>();
+        if (!count) return reject(Error::MALFORMED);
+
+        size_t const start = std::min<size_t>(*index, m_route.size());
+        size_t const end = std::min({ m_route.size(), start + *count,
+                                      start + Protocol::SEGMENTS_PER_FRAME });
+
+        auto writer = beginReply(Message::ROUTE_SEGMENTS);
+        writer.write(static_cast<uint16_t>(start));
+        for (size_t i = start; i < end; ++i)
+            writer.write(Protocol::Segment{ m_route.path()[i], m_route.targetTimes()[i],
+                                            m_route.turnTimes()[i] });
+        send(writer);
+    }
+
+    void sendStartupTimes() {
+        auto writer = beginReply(Message::STARTUP_TIMES);
+        writer.write(static_cast<uint8_t>(Startup::PHASE_COUNT));
+        for (Startup::Timing const& timing : m_startup.timings())
+            writer.write(timing.start).write(timing.end);
+        send(writer);
+    }
+
+    void sendRecording(Protocol::Reader& reader) {
+        auto const offset = reader.read<uint32_t>();
+        auto const length = reader.read<uint16_t>();
+        if (!length) return reject(Error::MALFORMED);
+
+        std::array<uint8_t, Protocol::RECORDING_BYTES_PER_FRAME> bytes{};
+        size_t const count = m_recorder.read(
+            *offset, { bytes.data(), std::min<size_t>(*length, bytes.size()) });
+
+        auto writer = beginReply(Message::RECORDING_DATA);
+        writer.write(static_cast<uint32_t>(m_recorder.size())).write(*offset);
+        for (size_t i = 0u; i < count; ++i) writer.write(bytes[i]);
+        send(writer);
+    }
+
+    void sendStageTimes(Protocol::Reader& reader) {
+        auto const first = reader.read<uint8_t>();
+        if (!first) return reject(Error::MALFORMED);
+
+        size_t const start = std::min<size_t>(*first, Stages::COUNT);
+        size_t const end = std::min<size_t>(Stages::COUNT, start + Protocol::STAGES_PER_FRAME);
+
+        auto writer = beginReply(Message::STAGE_TIMES);
+        writer.write(m_profile.frequency)
+            .write(static_cast<uint8_t>(Stages::COUNT))
+            .write(static_cast<uint8_t>(start));
+        for (size_t i = start; i < end; ++i) writer.write(m_profile.stats[i]);
+        send(writer);
+    }
+
+    void sendParameters() {
+        auto writer = beginReply(Message::PARAMETERS);
+        writer.write(Parameters::fingerprint()).write(static_cast<uint8_t>(Parameters::COUNT));
+        for (float const value : Parameters::values) writer.write(value);
+        send(writer);
+    }
+
+    void acknowledge() {
+        auto writer = beginReply(Message::ACK);
+        send(writer);
+    }
+
+    void reject(Error error) {
+        auto writer = beginReply(Message::NACK);
+        writer.write(static_cast<uint8_t>(error));
+        send(writer);
+    }
+
+    Protocol::Writer beginReply(Message message) {
+        Protocol::Writer writer{ m_reply };
+        writer.write(static_cast<uint8_t>(message)).write(m_sequence);
+        return writer;
+    }
+
+    // a leading delimiter as well, so text the robot printed before cannot run into the reply
+    void send(Protocol::Writer const& writer) {
+        m_frame[0] = Frame::DELIMITER;
+        size_t const size = 1u + Frame::encode(writer.data(), std::span{ m_frame }.subspan(1u));
+        m_transport.write({ m_frame.data(), size });
+    }
+
+    Transport& m_transport;
+    Route& m_route;
+    Startup const& m_startup;
+    Recorder const& m_recorder;
+    Stages::Profile const& m_profile;
+
+    Frame::Decoder m_decoder{};
+
+    std::array<uint8_t, Comms::MAX_PAYLOAD_SIZE> m_reply{};
+    std::array<uint8_t, Comms::MAX_FRAME_SIZE + 1u> m_frame{};
+
+    std::array<Compiler::Command, Route::CAPACITY> m_pendingCommands{};
+    size_t m_pendingSize{ 0u };
+    size_t m_pendingTotal{ 0u };
+
+    uint8_t m_sequence{ 0u };
+    bool m_locked{ false };
+    bool m_routeChanged{ false };
+    bool m_parametersChanged{ false };
+};
@@ -0,0 +1,117 @@
+// https://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
+
+#pragma once
+
+#include "Constants.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Frame {
+    inline constexpr uint8_t DELIMITER = 0x00;
+
+    constexpr uint16_t crc16(std::span<uint8_t const> data) {
+        uint16_t crc = 0xffff;
+        for (uint8_t const byte : data) {
+            crc ^= static_cast<uint16_t>(byte) << 8u;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1u) ^ 0x1021)
+                                     : static_cast<uint16_t>(crc << 1u);
+        }
+        return crc;
+    }
+
+    constexpr size_t cobsEncode(std::span<uint8_t const> input, std::span<uint8_t> output) {
+        size_t codeIndex = 0u;
+        size_t outputIndex = 1u;
+        uint8_t code = 1u;
+
+        for (uint8_t const byte : input) {
+            if (byte != DELIMITER) {
+                output[outputIndex++] = byte;
+                ++code;
+            }
+
+            if (byte == DELIMITER || code == 0xff) {
+                output[codeIndex] = code;
+                code = 1u;
+                codeIndex = outputIndex++;
+            }
+        }
+        output[codeIndex] = code;
+
+        return outputIndex;
+    }
+
+    constexpr std::optional<size_t> cobsDecode(std::span<uint8_t const> input,
+                                               std::span<uint8_t> output) {
+        size_t inputIndex = 0u;
+        size_t outputIndex = 0u;
+
+        while (inputIndex < input.size()) {
+            uint8_t const code = input[inputIndex++];
+            if (code == DELIMITER || inputIndex + code - 1u > input.size()) return std::nullopt;
+
+            for (uint8_t i = 1u; i < code; ++i) output[outputIndex++] = input[inputIndex++];
+            if (code != 0xff && inputIndex < input.size()) output[outputIndex++] = DELIMITER;
+        }
+
+        return outputIndex;
+    }
+
+    // payload, then its crc, cobs encoded and terminated with a single delimiter
+    constexpr size_t encode(std::span<uint8_t const> payload, std::span<uint8_t> output) {
+        std::array<uint8_t, Comms::MAX_PAYLOAD_SIZE + 2u> raw{};
+        if (payload.size() > Comms::MAX_PAYLOAD_SIZE) return 0u;
+
+        uint16_t const crc = crc16(payload);
+        std::copy(payload.begin(), payload.end(), raw.begin());
+        raw[payload.size()] = static_cast<uint8_t>(crc);
+        raw[payload.size() + 1u] = static_cast<uint8_t>(crc >> 8u);
+
+        size_t const size = cobsEncode({ raw.data(), payload.size() + 2u }, output);
+        output[size] = DELIMITER;
+
+        return size + 1u;
+    }
+
+    class Decoder {
+    public:
+        Decoder() = default;
+
+        std::optional<std::span<uint8_t const>> push(uint8_t byte) {
+            if (byte != DELIMITER) {
+                if (m_size < m_encoded.size()) m_encoded[m_size++] = byte;
+                else m_overflowed = true;
+                return std::nullopt;
+            }
+
+            size_t const size = m_size;
+            bool const overflowed = m_overflowed;
+            m_size = 0u;
+            m_overflowed = false;
+
+            if (size == 0u || overflowed) return std::nullopt;
+
+            auto const decodedSize = cobsDecode({ m_encoded.data(), size }, m_decoded);
+            if (!decodedSize || *decodedSize < 2u) return std::nullopt;
+
+            size_t const payloadSize = *decodedSize - 2u;
+            uint16_t const crc = static_cast<uint16_t>(m_decoded[payloadSize] |
+                                                       m_decoded[payloadSize + 1u] << 8u);
+            if (crc != crc16({ m_decoded.data(), payloadSize })) return std::nullopt;
+
+            return std::span<uint8_t const>{ m_decoded.data(), payloadSize };
+        }
+
+    private:
+        std::array<uint8_t, Comms::MAX_FRAME_SIZE> m_encoded{};
+        std::array<uint8_t, Comms::MAX_FRAME_SIZE> m_decoded{};
+        size_t m_size{ 0u };
+        bool m_overflowed{ false };
+    };
+}
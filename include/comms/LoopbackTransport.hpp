@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+
+// in memory link between two endpoints so the protocol can run without a robot attached
+class LoopbackTransport {
+public:
+    class Link {
+    public:
+        Link() = default;
+
+        Link(Link const&) = delete;
+        Link& operator=(Link const&) = delete;
+        Link(Link&&) = delete;
+        Link& operator=(Link&&) = delete;
+
+        LoopbackTransport host() { return { m_deviceToHost, m_hostToDevice }; }
+        LoopbackTransport device() { return { m_hostToDevice, m_deviceToHost }; }
+
+    private:
+        std::deque<uint8_t> m_hostToDevice{};
+        std::deque<uint8_t> m_deviceToHost{};
+    };
+
+    std::optional<uint8_t> read() {
+        if (m_incoming.empty()) return std::nullopt;
+
+        uint8_t const byte = m_incoming.front();
+        m_incoming.pop_front();
+        return byte;
+    }
+
+    void write(std::span<uint8_t const> data) {
+        m_outgoing.insert(m_outgoing.end(), data.begin(), data.end());
+    }
+
+private:
+    LoopbackTransport(std::deque<uint8_t>& incoming, std::deque<uint8_t>& outgoing)
+        : m_incoming{ incoming }, m_outgoing{ outgoing } {}
+
+    std::deque<uint8_t>& m_incoming;
+    std::deque<uint8_t>& m_outgoing;
+};
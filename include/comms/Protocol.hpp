@@ -0,0 +1,313 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "path/Compiler.hpp"
+#include "path/Path.hpp"
+
+#include "profiling/Stages.hpp"
+
+#include "state/Vector.hpp"
+
+#include "telemetry/Telemetry.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+namespace Protocol {
+    enum class Message : uint8_t {
+        PING = 0x01,
+
+        UPLOAD_COMMANDS = 0x10,
+        SET_TARGET_TIME = 0x11,
+        SET_PARAMETER = 0x12,
+
+        GET_ROUTE_INFO = 0x20,
+        GET_ROUTE = 0x21,
+        GET_STARTUP_TIMES = 0x22,
+        GET_RECORDING = 0x23,
+        GET_STAGE_TIMES = 0x24,
+        GET_PARAMETERS = 0x25,
+
+        ACK = 0x80,
+        NACK = 0x81,
+        ROUTE_INFO = 0x82,
+        ROUTE_SEGMENTS = 0x83,
+        STARTUP_TIMES = 0x84,
+        RECORDING_DATA = 0x85,
+        STAGE_TIMES = 0x86,
+        PARAMETERS = 0x88,
+
+        // sent unasked while the robot drives, with a sequence of 0
+        TELEMETRY = 0x87,
+    };
+
+    enum class Error : uint8_t {
+        NONE = 0x00,
+        MALFORMED = 0x01,
+        UNKNOWN_MESSAGE = 0x02,
+        OUT_OF_ORDER = 0x03,
+        TOO_LONG = 0x04,
+        // a value that is not finite, or a route the straight manager cannot keep to
+        INVALID_ROUTE = 0x05,
+        BUSY = 0x06,
+        INVALID_PARAMETER = 0x07,
+    };
+
+    // every payload starts with the message type and a sequence number that replies echo
+    inline constexpr size_t HEADER_SIZE = 2u;
+
+    // f32 amount.x, amount.y, offset.x, offset.y, targetTime (nan for none), units, u8 flags,
+    // u8 relative
+    inline constexpr size_t COMMAND_SIZE = 6u * sizeof(float) + 2u;
+    // u16 index, u16 total
+    inline constexpr size_t UPLOAD_HEADER_SIZE = 4u;
+    inline constexpr size_t COMMANDS_PER_FRAME = (Comms::MAX_PAYLOAD_SIZE - HEADER_SIZE -
+                                                  UPLOAD_HEADER_SIZE) /
+                                                 COMMAND_SIZE;
+
+    // f32 position.x, position.y, u8 flags, f32 targetTime, turnTime
+    inline constexpr size_t SEGMENT_SIZE = 4u * sizeof(float) + 1u;
+    // u16 index
+    inline constexpr size_t SEGMENTS_HEADER_SIZE = 2u;
+    inline constexpr size_t SEGMENTS_PER_FRAME = (Comms::MAX_PAYLOAD_SIZE - HEADER_SIZE -
+                                                  SEGMENTS_HEADER_SIZE) /
+                                                 SEGMENT_SIZE;
+
+    // u8 count, then u32 start and end in microseconds since boot for each phase
+    inline constexpr size_t STARTUP_TIMING_SIZE = 2u * sizeof(uint32_t);
+
+    // requested with u32 offset, u16 length, answered with u32 total size (0 until the run has
+    // finished), u32 offset, then the bytes
+    inline constexpr size_t RECORDING_HEADER_SIZE = 2u * sizeof(uint32_t);
+    inline constexpr size_t RECORDING_BYTES_PER_FRAME = Comms::MAX_PAYLOAD_SIZE - HEADER_SIZE -
+                                                        RECORDING_HEADER_SIZE;
+
+    // set with u8 id, f32 value (nan for the default), answered with u32 Parameters::fingerprint,
+    // u8 count, then f32 value for each parameter
+    static_assert(HEADER_SIZE + sizeof(uint32_t) + 1u + Parameters::COUNT * sizeof(float) <=
+                      Comms::MAX_PAYLOAD_SIZE,
+                  "every parameter has to fit in one PARAMETERS reply");
+
+    // requested with u8 first, answered with u32 clock frequency, u8 count, u8 first, then u32
+    // runs, min, max and u64 total cycles for as many stages from first as fit
+    inline constexpr size_t STAGE_STATS_SIZE = 3u * sizeof(uint32_t) + sizeof(uint64_t);
+    inline constexpr size_t STAGE_TIMES_HEADER_SIZE = sizeof(uint32_t) + 2u;
+    inline constexpr size_t STAGES_PER_FRAME = (Comms::MAX_PAYLOAD_SIZE - HEADER_SIZE -
+                                                STAGE_TIMES_HEADER_SIZE) /
+                                               STAGE_STATS_SIZE;
+
+    // u32 index, dropped, f32 elapsed, position.x, position.y, velocity.x, velocity.y, angle,
+    // angularVelocity, targetSpeeds.x, targetSpeeds.y, targetVoltages.x, targetVoltages.y,
+    // u16 segment
+    inline constexpr size_t TELEMETRY_SAMPLE_SIZE = 2u * sizeof(uint32_t) + 11u * sizeof(float) +
+                                                    sizeof(uint16_t);
+    static_assert(HEADER_SIZE + TELEMETRY_SAMPLE_SIZE <= Comms::MAX_PAYLOAD_SIZE);
+
+    struct Segment {
+        Path path{};
+        float targetTime{};
+        float turnTime{};
+    };
+
+    struct RouteInfo {
+        uint16_t size{};
+        float targetTime{};
+        Vec2 destination{};
+    };
+
+    class Writer {
+    public:
+        Writer(std::span<uint8_t> buffer) : m_buffer{ buffer } {}
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        Writer& write(T const& value) {
+            if (m_size + sizeof(T) > m_buffer.size()) {
+                m_overflowed = true;
+                return *this;
+            }
+
+            auto const bytes = std::bit_cast<std::array<uint8_t, sizeof(T)>>(value);
+            std::copy(bytes.begin(), bytes.end(), m_buffer.begin() + m_size);
+            m_size += sizeof(T);
+            return *this;
+        }
+
+        Writer& write(Compiler::Command const& command) {
+            return write(command.amount.x)
+                .write(command.amount.y)
+                .write(command.offset.x)
+                .write(command.offset.y)
+                .write(command.targetTime.value_or(std::numeric_limits<float>::quiet_NaN()))
+                .write(command.units)
+                .write(static_cast<uint8_t>(command.flags))
+                .write(static_cast<uint8_t>(command.relative));
+        }
+
+        Writer& write(Segment const& segment) {
+            return write(segment.path.position.x)
+                .write(segment.path.position.y)
+                .write(static_cast<uint8_t>(segment.path.flags))
+                .write(segment.targetTime)
+                .write(segment.turnTime);
+        }
+
+        Writer& write(RouteInfo const& info) {
+            return write(info.size)
+                .write(info.targetTime)
+                .write(info.destination.x)
+                .write(info.destination.y);
+        }
+
+        Writer& write(Stages::Stats const& stats) {
+            return write(stats.runs)
+                .write(stats.minCycles)
+                .write(stats.maxCycles)
+                .write(stats.totalCycles);
+        }
+
+        Writer& write(Telemetry::Sample const& sample) {
+            return write(sample.index)
+                .write(sample.dropped)
+                .write(sample.elapsed)
+                .write(sample.position.x)
+                .write(sample.position.y)
+                .write(sample.velocity.x)
+                .write(sample.velocity.y)
+                .write(sample.angle)
+                .write(sample.angularVelocity)
+                .write(sample.targetSpeeds.x)
+                .write(sample.targetSpeeds.y)
+                .write(sample.targetVoltages.x)
+                .write(sample.targetVoltages.y)
+                .write(sample.segment);
+        }
+
+        bool overflowed() const { return m_overflowed; }
+        std::span<uint8_t const> data() const { return { m_buffer.data(), m_size }; }
+
+    private:
+        std::span<uint8_t> m_buffer{};
+        size_t m_size{ 0u };
+        bool m_overflowed{ false };
+    };
+
+    class Reader {
+    public:
+        Reader(std::span<uint8_t const> buffer) : m_buffer{ buffer } {}
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::optional<T> read() {
+            // a failed read poisons the rest so a short payload cannot half succeed
+            if (m_failed || m_offset + sizeof(T) > m_buffer.size()) {
+                m_failed = true;
+                return std::nullopt;
+            }
+
+            std::array<uint8_t, sizeof(T)> bytes{};
+            std::copy_n(m_buffer.begin() + m_offset, sizeof(T), bytes.begin());
+            m_offset += sizeof(T);
+            return std::bit_cast<T>(bytes);
+        }
+
+        std::optional<Compiler::Command> readCommand() {
+            auto const amountX = read<float>();
+            auto const amountY = read<float>();
+            auto const offsetX = read<float>();
+            auto const offsetY = read<float>();
+            auto const targetTime = read<float>();
+            auto const units = read<float>();
+            auto const flags = read<uint8_t>();
+            auto const relative = read<uint8_t>();
+            if (!relative) return std::nullopt;
+
+            Compiler::Command command{};
+            command.amount = { *amountX, *amountY };
+            command.offset = { *offsetX, *offsetY };
+            if (!std::isnan(*targetTime)) command.targetTime = *targetTime;
+            command.units = *units;
+            command.flags = *flags;
+            command.relative = *relative != 0u;
+            return command;
+        }
+
+        std::optional<Segment> readSegment() {
+            auto const x = read<float>();
+            auto const y = read<float>();
+            auto const flags = read<uint8_t>();
+            auto const targetTime = read<float>();
+            auto const turnTime = read<float>();
+            if (!turnTime) return std::nullopt;
+
+            return Segment{ { { *x, *y }, *flags }, *targetTime, *turnTime };
+        }
+
+        std::optional<RouteInfo> readRouteInfo() {
+            auto const size = read<uint16_t>();
+            auto const targetTime = read<float>();
+            auto const x = read<float>();
+            auto const y = read<float>();
+            if (!y) return std::nullopt;
+
+            return RouteInfo{ *size, *targetTime, { *x, *y } };
+        }
+
+        std::optional<Stages::Stats> readStageStats() {
+            auto const runs = read<uint32_t>();
+            auto const minCycles = read<uint32_t>();
+            auto const maxCycles = read<uint32_t>();
+            auto const totalCycles = read<uint64_t>();
+            if (!totalCycles) return std::nullopt;
+
+            return Stages::Stats{ *runs, *minCycles, *maxCycles, *totalCycles };
+        }
+
+        std::optional<Telemetry::Sample> readTelemetrySample() {
+            auto const index = read<uint32_t>();
+            auto const dropped = read<uint32_t>();
+            auto const elapsed = read<float>();
+            auto const x = read<float>();
+            auto const y = read<float>();
+            auto const velocityX = read<float>();
+            auto const velocityY = read<float>();
+            auto const angle = read<float>();
+            auto const angularVelocity = read<float>();
+            auto const targetSpeedLeft = read<float>();
+            auto const targetSpeedRight = read<float>();
+            auto const targetVoltageLeft = read<float>();
+            auto const targetVoltageRight = read<float>();
+            auto const segment = read<uint16_t>();
+            if (!segment) return std::nullopt;
+
+            return Telemetry::Sample{ *index,
+                                      *dropped,
+                                      *elapsed,
+                                      { *x, *y },
+                                      { *velocityX, *velocityY },
+                                      *angle,
+                                      *angularVelocity,
+                                      { *targetSpeedLeft, *targetSpeedRight },
+                                      { *targetVoltageLeft, *targetVoltageRight },
+                                      *segment };
+        }
+
+        size_t remaining() const { return m_buffer.size() - m_offset; }
+
+    private:
+        std::span<uint8_t const> m_buffer{};
+        size_t m_offset{ 0u };
+        bool m_failed{ false };
+    };
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+template <typename T>
+concept TransportType = requires(T transport, std::span<uint8_t const> data) {
+    { transport.read() } -> std::same_as<std::optional<uint8_t>>;
+    transport.write(data);
+};
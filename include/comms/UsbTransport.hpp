@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+class UsbTransport {
+public:
+    UsbTransport() = default;
+
+    std::optional<uint8_t> read();
+    void write(std::span<uint8_t const> data);
+
+    // writes only if all of data fits in the cdc buffer now, so it never waits on the host
+    bool tryWrite(std::span<uint8_t const> data);
+};
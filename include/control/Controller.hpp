@@ -18,6 +18,11 @@ public:
         return (std::get<ControllerTypes>(m_controllers).update(setpoint, measurement) + ...);
     }
 
+    template <ControllerType T>
+    T& get() {
+        return std::get<T>(m_controllers);
+    }
+
 private:
     std::tuple<ControllerTypes...> m_controllers;
 };
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// fits y = phi . theta one sample at a time, forgetting old samples by a factor of forgetting per
+// update so the estimate follows a slowly drifting system. the estimate is kept inside [min, max].
+// a well and a poorly excited parameter put orders of magnitude between the covariance's terms,
+// so it is updated in joseph form, symmetric by construction and with the rounding of the gain
+// only entering to second order. forgetting winds up the variances of anything not being excited,
+// and the next sample would throw its estimate anywhere, so the sum of the variances each over
+// where it started is held to N, the whole covariance scaled down when it goes over. whatever
+// rounding and scaling leave cannot take a variance under MIN_VARIANCE of where it started or a
+// correlation past 1, the ways it would first go indefinite in float
+template <size_t N>
+class RecursiveLeastSquares {
+public:
+    using Vector = std::array<float, N>;
+
+    RecursiveLeastSquares(Vector const& initial, Vector const& variances, Vector const& min,
+                          Vector const& max, float forgetting)
+        : m_estimate{ initial },
+          m_variances{ variances },
+          m_min{ min },
+          m_max{ max },
+          m_forgetting{ forgetting } {
+        for (size_t i = 0u; i < N; ++i) m_covariance[i][i] = variances[i];
+    }
+
+    void update(Vector const& phi, float y) {
+        Vector covariancePhi{};
+        for (size_t i = 0u; i < N; ++i) covariancePhi[i] = dot(m_covariance[i], phi);
+
+        float const denominator = m_forgetting + dot(phi, covariancePhi);
+        float const error = y - dot(phi, m_estimate);
+
+        Vector gain{};
+        for (size_t i = 0u; i < N; ++i) gain[i] = covariancePhi[i] / denominator;
+
+        for (size_t i = 0u; i < N; ++i)
+            m_estimate[i] = std::clamp(m_estimate[i] + gain[i] * error, m_min[i], m_max[i]);
+
+        // (I - gain phi^T) P (I - gain phi^T)^T + forgetting gain gain^T over the forgetting,
+        // which with P phi = covariancePhi comes to the terms below
+        for (size_t i = 0u; i < N; ++i) {
+            for (size_t j = i; j < N; ++j) {
+                float const value = m_covariance[i][j] - gain[i] * covariancePhi[j] -
+                                    covariancePhi[i] * gain[j] +
+                                    denominator * gain[i] * gain[j];
+                m_covariance[i][j] = value / m_forgetting;
+                m_covariance[j][i] = m_covariance[i][j];
+            }
+        }
+
+        float trace = 0.0f;
+        for (size_t i = 0u; i < N; ++i) trace += m_covariance[i][i] / m_variances[i];
+        if (trace > static_cast<float>(N)) {
+            float const scale = static_cast<float>(N) / trace;
+            for (Vector& row : m_covariance)
+                for (float& value : row) value *= scale;
+        }
+
+        for (size_t i = 0u; i < N; ++i)
+            m_covariance[i][i] = std::max(m_covariance[i][i], MIN_VARIANCE * m_variances[i]);
+
+        for (size_t i = 0u; i < N; ++i) {
+            for (size_t j = i + 1u; j < N; ++j) {
+                float const bound = std::sqrt(m_covariance[i][i] * m_covariance[j][j]);
+                m_covariance[i][j] = std::clamp(m_covariance[i][j], -bound, bound);
+                m_covariance[j][i] = m_covariance[i][j];
+            }
+        }
+    }
+
+    Vector const& estimate() const { return m_estimate; }
+    float variance(size_t i) const { return m_covariance[i][i]; }
+
+private:
+    // of the initial variance, well under where a parameter settles but far above the rounding
+    static constexpr float MIN_VARIANCE = 1.0e-6f;
+
+    static float dot(Vector const& u, Vector const& v) {
+        float sum = 0.0f;
+        for (size_t i = 0u; i < N; ++i) sum += u[i] * v[i];
+        return sum;
+    }
+
+    Vector m_estimate{};
+    std::array<Vector, N> m_covariance{};
+
+    Vector const m_variances{};
+    Vector const m_min{};
+    Vector const m_max{};
+
+    float const m_forgetting{};
+};
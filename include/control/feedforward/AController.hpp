@@ -6,7 +6,7 @@
 
 class AController {
 public:
-    AController(float kA, float alpha, float dt) : m_filter{ alpha }, m_k{ kA / dt } {}
+    AController(float kA, float alpha, float dt) : m_filter{ alpha }, m_k{ kA / dt }, m_dt{ dt } {}
 
     float update(float setpoint, float) {
         float const filteredSetpoint = m_filter.update(setpoint);
@@ -16,9 +16,12 @@ public:
         return output;
     }
 
+    void setGain(float kA) { m_k = kA / m_dt; }
+
 private:
     LagFilter m_filter;
-    float const m_k{};
+    float m_k{};
+    float const m_dt{};
 
     float m_prevSetpoint = 0.0f;
 };
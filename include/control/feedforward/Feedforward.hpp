@@ -0,0 +1,9 @@
+#pragma once
+
+// the feedforward gains of one axis of the velocity regulator, volts per unit of speed and
+// acceleration on top of the static voltage
+struct Feedforward {
+    float kS{};
+    float kV{};
+    float kA{};
+};
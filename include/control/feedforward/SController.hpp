@@ -10,6 +10,8 @@ public:
         return (setpoint != 0.0f) * std::copysignf(m_kS, setpoint);
     }
 
+    void setGain(float kS) { m_kS = kS; }
+
 private:
     float m_kS{};
 };
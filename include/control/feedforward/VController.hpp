@@ -6,6 +6,8 @@ public:
 
     float update(float setpoint, float) { return m_kV * setpoint; }
 
+    void setGain(float kV) { m_kV = kV; }
+
 private:
     float m_kV{};
 };
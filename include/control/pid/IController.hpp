@@ -1,24 +1,25 @@
 #pragma once
 
-#include <algorithm>
+#include "dsp/Kernels.hpp"
 
 class IController {
 public:
     IController(float kI, float minInt, float maxInt, float dt)
-        : m_k{ kI * dt }, m_minInt{ minInt }, m_maxInt{ maxInt } {}
+        : m_halfK{ 0.5f * kI * dt }, m_minInt{ minInt }, m_maxInt{ maxInt } {}
 
     float update(float setpoint, float measurement) {
         float const error = setpoint - measurement;
 
-        m_integrator += 0.5f * m_k * (error + m_prevError);
-        m_integrator = std::clamp(m_integrator, m_minInt, m_maxInt);
+        // trapezoidal
+        m_integrator = Dsp::clamp(Dsp::mac(m_integrator, m_halfK, error + m_prevError), m_minInt,
+                                  m_maxInt);
         m_prevError = error;
 
         return m_integrator;
     }
 
 private:
-    float const m_k{};
+    float const m_halfK{};
     float const m_minInt{};
     float const m_maxInt{};
 
@@ -13,6 +13,13 @@ public:
 
     void waitForClick() const;
 
+    template <typename F>
+    void waitForClick(F const& whileWaiting) const {
+        while (isPressed()) whileWaiting();
+        while (!isPressed()) whileWaiting();
+        while (isPressed()) whileWaiting();
+    }
+
 private:
     uint const m_pin{};
 };
@@ -1,9 +1,15 @@
 #pragma once
 
+#include "drivers/SensorConversion.hpp"
+#include "drivers/Snapshot.hpp"
+
 #include "state/Vector.hpp"
 
 #include "hardware/pio.h"
 
+#include <array>
+#include <cstdint>
+
 class Encoders {
 public:
     Encoders(PIO pio, uint csLeftPin, uint csRightPin, uint sckPin, uint misoPin);
@@ -13,8 +19,17 @@ public:
     Encoders(Encoders&&) = delete;
     Encoders& operator=(Encoders&&) = delete;
 
-    Vec2 data() const;
+    using Sample = std::array<uint16_t, 2>;
+
+    Sample sample() const {
+        auto const rawData = m_snapshot.read();
+        return { static_cast<uint16_t>(rawData[0] >> 10u),
+                 static_cast<uint16_t>(rawData[1] >> 10u) };
+    }
+
+    static Vec2 data(Sample const& sample) { return SensorConversion::wheelAngles(sample); }
+    Vec2 data() const { return data(sample()); }
 
 private:
-    uint32_t volatile m_rawData[2]{ 0u, 0u };
+    Snapshot<2> m_snapshot{};
 };
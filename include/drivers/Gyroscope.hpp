@@ -4,18 +4,31 @@
 
 #include "Constants.hpp"
 
+#include "drivers/SensorConversion.hpp"
+#include "drivers/Snapshot.hpp"
+
 #include "state/Vector.hpp"
 
 #include "hardware/gpio.h"
 #include "hardware/pio.h"
 #include "hardware/spi.h"
 
+#include <array>
 #include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 class Gyroscope {
 public:
+    struct Calibration {
+        Vec3 bias{};
+        Vec3 down{};
+        float temperature{};
+    };
+
+    // configures the sensor, then either calibrate() or a successful verify() has to come before
+    // start() hands the bus over to the pio
     Gyroscope(PIO pio, uint csPin, uint sckPin, uint misoPin, uint mosiPin, uint intPin);
 
     Gyroscope(Gyroscope const&) = delete;
@@ -23,20 +36,35 @@ public:
     Gyroscope(Gyroscope&&) = delete;
     Gyroscope& operator=(Gyroscope&&) = delete;
 
-    float angularVelocity() const {
-        uint16_t x = static_cast<uint16_t>(m_rawData[0]);
-        uint16_t y = static_cast<uint16_t>(m_rawData[1]);
-        uint16_t z = static_cast<uint16_t>(m_rawData[2]);
+    using Sample = std::array<uint16_t, 3>;
 
-        Vec3 const direction{ static_cast<float>(std::bit_cast<int16_t>(x)),
-                              static_cast<float>(std::bit_cast<int16_t>(y)),
-                              static_cast<float>(std::bit_cast<int16_t>(z)) };
+    Sample sample() const {
+        auto const rawData = m_snapshot.read();
+        return { static_cast<uint16_t>(rawData[0]), static_cast<uint16_t>(rawData[1]),
+                 static_cast<uint16_t>(rawData[2]) };
+    }
 
-        return Vec3::dot(direction / Drivers::Gyroscope::RESOLUTION - m_bias, m_down);
+    float angularVelocity(Sample const& sample) const {
+        return SensorConversion::angularVelocity(sample, m_bias, m_down);
     }
+    float angularVelocity() const { return angularVelocity(sample()); }
 
     Vec3 const& down() const { return m_down; }
 
+    void calibrate();
+    // a short stillness test against an earlier calibration, adopting it if it still holds
+    bool verify(Calibration const& calibration);
+    void start();
+
+    // called from the dma interrupt on the calling core as each sample lands, only after start()
+    using SampleCallback = void (*)(void*);
+    void setSampleCallback(SampleCallback callback, void* context, uint8_t priority);
+    // seconds between samples by our clock, blocks for SAMPLE_PERIOD_MEASUREMENT_TIME and replaces
+    // the sample callback
+    float measureSamplePeriod();
+
+    Calibration calibration() const { return { m_bias, m_down, m_temperature }; }
+
 private:
     static constexpr uint8_t REG_BANK_SEL = 0x76;
     enum class Bank0 : uint8_t {
@@ -161,8 +189,9 @@ private:
     spi_inst_t* setupRegisterReadWrite(uint csPin, uint sckPin, uint misoPin, uint mosiPin) const;
     void setupRegisters(spi_inst_t* spi, uint csPin) const;
 
-    void getBias(spi_inst_t* spi, uint csPin);
-    void getDown(spi_inst_t* spi, uint csPin);
+    Vec3 getBias(spi_inst_t* spi, uint csPin, size_t sampleCount) const;
+    Vec3 getDown(spi_inst_t* spi, uint csPin, size_t sampleCount) const;
+    float getTemperature(spi_inst_t* spi, uint csPin) const;
 
     void endSetup(spi_inst_t* spi) const;
     void setupPIORead(PIO pio, uint csPin, uint sckPin, uint misoPin, uint mosiPin, uint intPin);
@@ -216,9 +245,18 @@ private:
         gpio_put(csPin, true);
     }
 
+    PIO const m_pio{};
+    uint const m_csPin{};
+    uint const m_sckPin{};
+    uint const m_misoPin{};
+    uint const m_mosiPin{};
+    uint const m_intPin{};
+    spi_inst_t* m_spi{};
+
     Vec3 m_down{};
     Vec3 m_bias{};
+    float m_temperature{};
 
-    uint32_t volatile m_rawData[3]{ 0u, 0u, 0u };
-    uint32_t const m_rawDataPtr{};
+    Snapshot<3> m_snapshot{};
+    uint m_sampleChannel{};
 };
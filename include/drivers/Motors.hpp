@@ -2,9 +2,15 @@
 
 #include "Constants.hpp"
 
+#include "drivers/Snapshot.hpp"
+#include "drivers/SnapshotDma.hpp"
+
 #include "state/Vector.hpp"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <utility>
 
 using uint = unsigned int;
@@ -21,6 +27,9 @@ public:
             return static_cast<float>(m_power) / static_cast<float>(Drivers::Motors::MAX_POWER);
         }
 
+        // the slices it drives, left stopped for Motors to start together
+        uint32_t sliceMask() const { return (1u << m_in1Slice) | (1u << m_in2Slice); }
+
     private:
         uint const m_in1Channel{};
         uint const m_in2Channel{};
@@ -31,27 +40,62 @@ public:
         int m_power{};
     };
 
+    // the battery divider runs in the same round robin as the currents, so the voltage is read
+    // under the load they are. with Integration::PWM_SYNCHRONOUS_CURRENT_SAMPLING the motor pwm
+    // paces the round robin, once a period, and each sample is the whole of one period. a period
+    // that lost or gained a conversion would shift every sample after it by a word, so one that
+    // starts with the dma part way through a sample is dropped and the dma put back in step
     class CurrentSensor {
     public:
-        CurrentSensor(uint leftCurrentPin, uint rightCurrentPin);
+        struct Sample {
+            Vec2 currents{};
+            float voltage{};
+            // one more every pwm period, staying at 0 while free running
+            uint8_t period{};
+        };
+
+        CurrentSensor(uint leftCurrentPin, uint rightCurrentPin, uint voltagePin);
 
         CurrentSensor(CurrentSensor const&) = delete;
         CurrentSensor& operator=(CurrentSensor const&) = delete;
         CurrentSensor(CurrentSensor&&) = delete;
         CurrentSensor& operator=(CurrentSensor&&) = delete;
 
-        Vec2 data() const;
+        // while the paced dma is being put back in step, the last sample that was in step
+        Sample sample();
+        Vec2 data() { return sample().currents; }
+        float voltage() { return sample().voltage; }
+
+        // the pacing slices for Motors to start with its own, none while free running
+        uint32_t sampleSlices() const { return m_sampleSlices; }
 
     private:
         float getBias(uint currentPin);
-        void setupRead(uint leftCurrentPin, uint rightCurrentPin);
+        void setupRead(uint leftCurrentPin, uint rightCurrentPin, uint voltagePin);
+        bool setupPacedRead(uint leftCurrentPin, uint rightCurrentPin, uint voltagePin);
+        Sample convert(std::array<uint32_t, 3> const& raw, uint8_t period) const;
+        void realign();
 
-        uint16_t volatile m_rawData[2]{ 0u, 0u };
+        uint16_t volatile m_rawData[3]{ 0u, 0u, 0u };
         Vec2 m_bias{};
+
+        Snapshot<3> m_snapshot{};
+        SnapshotDma::Channels m_channels{};
+        // the adc control words the pacing channels write, kept here for the dma to read
+        uint32_t m_startControl{};
+        uint32_t m_stopControl{};
+        // the words the data channel still wanted as each period started, 3 when in step
+        uint32_t volatile m_remaining{ 3u };
+        // the period that was published when the dma was last put back in step
+        std::optional<uint8_t> m_outOfStep{};
+        Sample m_lastSample{};
+        // where the left and right currents and the voltage land in a paced sample
+        std::array<size_t, 3> m_slots{};
+        uint32_t m_sampleSlices{};
     };
 
     Motors(uint leftIn1Pin, uint leftIn2Pin, uint rightIn1Pin, uint rightIn2Pin,
-           uint leftCurrentPin, uint rightCurrentPin);
+           uint leftCurrentPin, uint rightCurrentPin, uint voltagePin);
 
     constexpr decltype(auto) left(this auto&& self) {
         return std::forward_like<decltype(self)>(self.m_left);
@@ -67,7 +111,9 @@ public:
     }
 
     Vec2 power() const { return { m_left.power(), m_right.power() }; }
-    Vec2 current() const { return m_currentSensor.data(); }
+    Vec2 current() { return m_currentSensor.data(); }
+    float supplyVoltage() { return m_currentSensor.voltage(); }
+    CurrentSensor::Sample currentSample() { return m_currentSensor.sample(); }
 
 private:
     Controller m_left;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+// pacing the current samples off the motor pwm, kept free of hardware headers so rotour-schedule
+// can check the arithmetic for other frequencies and wraps. the motor slices count phase correct,
+// up to their wrap and back down, so from the moment they are enabled every drive pulse is
+// centred wrap + 1 counts into its period, to within a count. two pinless slices count freely
+// over the same period from presets: the start slice wraps half a conversion before that centre
+// and starts the round robin, the stop slice wraps halfway through the last conversion and ends
+// it, so each period converts every input once with the two currents either side of the centre
+namespace PwmTiming {
+    // the adc runs off the 48 MHz usb pll whatever clk_sys is, 96 cycles a conversion
+    inline constexpr uint32_t ADC_CLOCK_HZ = 48'000'000u;
+    inline constexpr uint32_t CONVERSION_CYCLES = 96u;
+
+    // the sdk truncates a float divider to 8.4 fixed point, so this is in sixteenths and 0 when
+    // the counter cannot be that slow or that fast
+    constexpr uint32_t divider(uint32_t sysClockHz, uint32_t counterHz) {
+        float const exact = static_cast<float>(sysClockHz) / static_cast<float>(counterHz);
+        if (exact < 1.0f || exact >= 256.0f) return 0u;
+        return static_cast<uint32_t>(exact * 16.0f);
+    }
+
+    struct Timing {
+        uint32_t periodCounts{};
+        // of both free running slices
+        uint16_t sampleWrap{};
+        uint16_t startCounter{};
+        uint16_t stopCounter{};
+        // counts from the centre to the first conversion, and from there to the stop
+        uint32_t lead{};
+        uint32_t window{};
+    };
+
+    // of slices counting at clk_sys * 16 / divider. empty if the period is too long for a free
+    // running slice or the conversions do not fit either side of the centre
+    constexpr std::optional<Timing> timing(uint32_t sysClockHz, uint32_t divider, uint16_t wrap,
+                                           uint32_t conversions) {
+        uint32_t const periodCounts = 2u * (static_cast<uint32_t>(wrap) + 1u);
+        if (divider == 0u || conversions == 0u || periodCounts - 1u > UINT16_MAX)
+            return std::nullopt;
+
+        // adc cycles to pwm counts, rounded to the nearest
+        auto const counts = [&](uint64_t adcCycles) {
+            uint64_t const numerator = adcCycles * sysClockHz * 16u;
+            uint64_t const denominator = uint64_t{ ADC_CLOCK_HZ } * divider;
+            return static_cast<uint32_t>((numerator + denominator / 2u) / denominator);
+        };
+
+        uint32_t const lead = counts(CONVERSION_CYCLES / 2u);
+        uint32_t const window = counts((2u * conversions - 1u) * CONVERSION_CYCLES / 2u);
+        if (lead > wrap || window - lead > static_cast<uint32_t>(wrap) + 1u) return std::nullopt;
+
+        // a free running slice first wraps periodCounts - counter counts after it is enabled
+        uint32_t const centre = static_cast<uint32_t>(wrap) + 1u;
+        return Timing{ periodCounts, static_cast<uint16_t>(periodCounts - 1u),
+                       static_cast<uint16_t>(centre + lead),
+                       static_cast<uint16_t>(centre + lead - window), lead, window };
+    }
+}
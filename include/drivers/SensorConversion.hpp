@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "state/Vector.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// raw sensor words to physical units, kept free of hardware headers so a replay on the host runs
+// exactly the arithmetic the robot did
+namespace SensorConversion {
+    inline float angularVelocity(std::array<uint16_t, 3> const& raw, Vec3 const& bias,
+                                 Vec3 const& down) {
+        Vec3 const direction{ static_cast<float>(std::bit_cast<int16_t>(raw[0])),
+                              static_cast<float>(std::bit_cast<int16_t>(raw[1])),
+                              static_cast<float>(std::bit_cast<int16_t>(raw[2])) };
+
+        return Vec3::dot(direction / Drivers::Gyroscope::RESOLUTION - bias, down);
+    }
+
+    // the encoders shift out 24 bit frames with the 14 bit angle on top
+    inline Vec2 wheelAngles(std::array<uint16_t, 2> const& raw) {
+        return { -static_cast<float>(raw[0]) / 16384.0f * 2.0f * Constants::PI,
+                 static_cast<float>(raw[1]) / 16384.0f * 2.0f * Constants::PI };
+    }
+
+    // the current sensors read how much each winding draws but not which way, so the pack is
+    // taken to give each motor its duty cycle's share of that in either direction
+    inline float batteryCurrent(Vec2 const& duties, Vec2 const& currents) {
+        return std::fabsf(duties.x) * currents.x + std::fabsf(duties.y) * currents.y;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// two buffers the dma fills in turn, then the dma writes the sequence number of the sample it
+// just finished. a reader copies the buffer the sequence points at and retries if the sequence
+// moved meanwhile, so it always gets one whole sample without stopping the dma or masking
+// interrupts. only a reader stalled for 256 samples could miss the wrap
+template <size_t Words>
+class Snapshot {
+public:
+    Snapshot() : m_addresses{ m_buffers[0], m_buffers[1] } {}
+
+    Snapshot(Snapshot const&) = delete;
+    Snapshot& operator=(Snapshot const&) = delete;
+    Snapshot(Snapshot&&) = delete;
+    Snapshot& operator=(Snapshot&&) = delete;
+
+    // zeros until the first sample is complete
+    std::array<uint32_t, Words> read() const {
+        uint8_t sequence{};
+        return read(sequence);
+    }
+
+    // with the sequence number the sample was published under, one more for every sample
+    std::array<uint32_t, Words> read(uint8_t& sequence) const {
+        std::array<uint32_t, Words> sample{};
+
+        do {
+            sequence = m_sequence;
+            for (size_t i = 0u; i < Words; ++i) sample[i] = m_buffers[sequence & 1u][i];
+        } while (sequence != m_sequence);
+
+        return sample;
+    }
+
+    // what SnapshotDma points its channels at
+    uint32_t volatile* buffer(size_t index) { return m_buffers[index]; }
+    uint32_t volatile* const* addresses() const { return m_addresses.data(); }
+    uint8_t volatile* sequence() { return &m_sequence; }
+
+private:
+    uint32_t volatile m_buffers[2][Words]{};
+
+    // read in a ring by the dma, so aligned to its own size
+    alignas(2u * sizeof(uint32_t volatile*)) std::array<uint32_t volatile*, 2> const m_addresses;
+
+    // starts on buffer 1 so the untouched zeros are what a reader gets before the first sample
+    uint8_t volatile m_sequence{ 0xff };
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "drivers/Snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+using uint = unsigned int;
+
+// keeps a Snapshot filled from a paced source with three chained channels: the data channel
+// copies one sample into the next buffer, the sequence channel publishes it, and the select
+// channel points the data channel at the other buffer and restarts it
+namespace SnapshotDma {
+    // the sequence channel's completion means a whole new sample is readable
+    struct Channels {
+        uint data{};
+        uint sequence{};
+        uint select{};
+    };
+
+    Channels start(uint32_t volatile* firstBuffer, uint32_t volatile* const* addresses,
+                   uint8_t volatile* sequence, size_t words, void const volatile* source,
+                   uint dreq);
+
+    // drops the sample under way and starts it again from its first word, for a source that
+    // lost or gained a word. only safe while the source is idle. returns the sequence number
+    // that stays published until the restarted sample is complete
+    uint8_t restart(Channels const& channels, uint32_t volatile* const* addresses,
+                    uint8_t volatile const* sequence, size_t words);
+
+    template <size_t Words>
+    Channels start(Snapshot<Words>& snapshot, void const volatile* source, uint dreq) {
+        return start(snapshot.buffer(0u), snapshot.addresses(), snapshot.sequence(), Words, source,
+                     dreq);
+    }
+
+    template <size_t Words>
+    uint8_t restart(Snapshot<Words>& snapshot, Channels const& channels) {
+        return restart(channels, snapshot.addresses(), snapshot.sequence(), Words);
+    }
+}
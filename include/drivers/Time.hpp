@@ -8,6 +8,7 @@ public:
 
     void reset();
     void update();
+    void update(uint32_t currentTime);
 
     float elapsed() const { return m_elapsedTime; }
 
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <optional>
+
+// the arithmetic the filters and regulators are built from. every kernel is one correctly rounded
+// ieee operation, so the cortex-m33 backend and the host reference give the same bits and a
+// replay on the host stays exact
+namespace Dsp {
+    // plain c++, what the host tools use. min and max order -0 below +0 and ignore a single nan
+    // to match vminnm and vmaxnm, fminf and fmaxf leave both unspecified
+    namespace Reference {
+        inline float mac(float accumulator, float a, float b) {
+            return std::fmaf(a, b, accumulator);
+        }
+
+        inline float min(float a, float b) {
+            if (std::isnan(a)) return b;
+            if (std::isnan(b)) return a;
+            return a < b || (a == b && std::signbit(a)) ? a : b;
+        }
+
+        inline float max(float a, float b) {
+            if (std::isnan(a)) return b;
+            if (std::isnan(b)) return a;
+            return a > b || (a == b && !std::signbit(a)) ? a : b;
+        }
+
+        inline float divide(float a, float b) { return a / b; }
+    }
+
+#if defined(__ARM_ARCH_8M_MAIN__) && defined(__ARM_FP) && defined(__ARM_FEATURE_FMA)
+    // the sdk's float library wraps the libm entry points with its own routines, so the single
+    // instructions are pinned here rather than left to fmaf and friends
+    namespace Hardware {
+        inline float mac(float accumulator, float a, float b) {
+            asm("vfma.f32 %0, %1, %2" : "+t"(accumulator) : "t"(a), "t"(b));
+            return accumulator;
+        }
+
+        inline float min(float a, float b) {
+            float result;
+            asm("vminnm.f32 %0, %1, %2" : "=t"(result) : "t"(a), "t"(b));
+            return result;
+        }
+
+        inline float max(float a, float b) {
+            float result;
+            asm("vmaxnm.f32 %0, %1, %2" : "=t"(result) : "t"(a), "t"(b));
+            return result;
+        }
+
+        inline float divide(float a, float b) {
+            float result;
+            asm("vdiv.f32 %0, %1, %2" : "=t"(result) : "t"(a), "t"(b));
+            return result;
+        }
+    }
+
+    namespace Backend = Hardware;
+#else
+    namespace Backend = Reference;
+#endif
+
+    // accumulator + a * b, rounded once
+    inline float mac(float accumulator, float a, float b) {
+        return Backend::mac(accumulator, a, b);
+    }
+
+    // sum of a[i] * b[i] on top of the accumulator
+    inline float dot(float const* a, float const* b, size_t count, float accumulator = 0.0f) {
+        for (size_t i = 0u; i < count; ++i) accumulator = Backend::mac(accumulator, a[i], b[i]);
+        return accumulator;
+    }
+
+    inline float min(float a, float b) { return Backend::min(a, b); }
+    inline float max(float a, float b) { return Backend::max(a, b); }
+
+    // a nan comes out as min, so a poisoned integrator recovers instead of sticking
+    inline float clamp(float x, float min, float max) {
+        return Backend::min(Backend::max(x, min), max);
+    }
+
+    inline float saturate(float x, float limit) { return clamp(x, -limit, limit); }
+
+    // from at t = 0, to at t = 1
+    inline float lerp(float from, float to, float t) { return Backend::mac(from, t, to - from); }
+
+    inline std::optional<float> divide(float a, float b) {
+        if (b == 0.0f) return std::nullopt;
+        else return Backend::divide(a, b);
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// constexpr versions for filter design, where the std functions cannot run at compile time. good
+// to a few ulp of double, far below the float the coefficients end up as
+namespace Dsp {
+    inline constexpr double PI = 3.14159265358979323846;
+
+    // taylor series after folding into [-pi, pi]
+    constexpr double sine(double x) {
+        double const turns = x / (2.0 * PI);
+        long long const whole = static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5);
+        x -= static_cast<double>(whole) * 2.0 * PI;
+
+        double term = x;
+        double sum = x;
+        for (int i = 1; i < 24; ++i) {
+            term *= -x * x / static_cast<double>((2 * i) * (2 * i + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cosine(double x) { return sine(x + PI / 2.0); }
+
+    constexpr double tangent(double x) { return sine(x) / cosine(x); }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "dsp/Kernels.hpp"
+
+#include <array>
+#include <cstddef>
+
+// one second order low pass section as a trapezoidal state variable filter, the same bilinear
+// transfer function as the textbook direct forms. at the fast loop rate the cutoffs are a
+// thousandth of the sample rate, where a direct form in float rounds its states into noise a
+// hundred times the encoder quantisation. here the states are integrators fed by small
+// differences, and the gain at dc is exactly 1 whatever the coefficients round to
+class Biquad {
+public:
+    // g = tan(pi cutoff dt) and k = 1 / q give a1 = 1 / (1 + g (g + k)), a2 = g a1, a3 = g a2
+    struct Coefficients {
+        float a1{};
+        float a2{};
+        float a3{};
+    };
+
+    constexpr Biquad() = default;
+    constexpr Biquad(Coefficients const& coefficients) : m_coefficients{ coefficients } {}
+
+    float update(float input) {
+        float const v3 = input - m_state2;
+        float const v1 = Dsp::mac(m_coefficients.a1 * m_state1, m_coefficients.a2, v3);
+        float const v2 = Dsp::mac(Dsp::mac(m_state2, m_coefficients.a2, m_state1),
+                                  m_coefficients.a3, v3);
+
+        m_state1 = Dsp::mac(-m_state1, 2.0f, v1);
+        m_state2 = Dsp::mac(-m_state2, 2.0f, v2);
+        return v2;
+    }
+
+private:
+    Coefficients m_coefficients{};
+
+    float m_state1{ 0.0f };
+    float m_state2{ 0.0f };
+};
+
+template <size_t Sections>
+class BiquadCascade {
+public:
+    constexpr BiquadCascade(std::array<Biquad::Coefficients, Sections> const& coefficients) {
+        for (size_t i = 0u; i < Sections; ++i) m_sections[i] = coefficients[i];
+    }
+
+    float update(float input) {
+        for (Biquad& section : m_sections) input = section.update(input);
+        return input;
+    }
+
+private:
+    std::array<Biquad, Sections> m_sections{};
+};
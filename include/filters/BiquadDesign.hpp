@@ -0,0 +1,81 @@
+#pragma once
+
+#include "dsp/Trigonometry.hpp"
+
+#include "filters/Biquad.hpp"
+
+#include <array>
+#include <cstddef>
+
+// low pass cascades through the bilinear transform, prewarped so the cutoff lands where asked.
+// constexpr so they fold when dt is known at compile time, the fast loop measures its dt and
+// designs at start up instead
+namespace BiquadDesign {
+    // butterworth is as flat as possible in the pass band, bessel gives up roll off to keep the
+    // delay the same at every frequency so shapes like a velocity ramp come through undistorted
+    enum class Response { BUTTERWORTH, BESSEL };
+
+    namespace Detail {
+        // frequency relative to the cutoff and quality factor of one section
+        struct Section {
+            double frequencyScale{};
+            double q{};
+        };
+
+        // bessel poles have no closed form, these are the usual tables normalised to -3 db at
+        // the cutoff
+        inline constexpr std::array<Section, 1> BESSEL_2{ { { 1.2736, 0.5773 } } };
+        inline constexpr std::array<Section, 2> BESSEL_4{ { { 1.4192, 0.5219 },
+                                                            { 1.5912, 0.8055 } } };
+        inline constexpr std::array<Section, 3> BESSEL_6{ { { 1.6060, 0.5103 },
+                                                            { 1.6913, 0.6112 },
+                                                            { 1.9071, 1.0234 } } };
+
+        template <Response R, size_t Order>
+        constexpr Section section(size_t index) {
+            if constexpr (R == Response::BUTTERWORTH) {
+                // the analog pole pairs sit evenly around a circle in the s plane
+                double const angle = static_cast<double>(2u * index + 1u) * Dsp::PI /
+                                     static_cast<double>(2u * Order);
+                return { 1.0, 1.0 / (2.0 * Dsp::sine(angle)) };
+            } else if constexpr (Order == 2u) return BESSEL_2[index];
+            else if constexpr (Order == 4u) return BESSEL_4[index];
+            else return BESSEL_6[index];
+        }
+
+        constexpr Biquad::Coefficients lowPass(double frequency, double q, double dt) {
+            double const g = Dsp::tangent(Dsp::PI * frequency * dt);
+            double const a1 = 1.0 / (1.0 + g * (g + 1.0 / q));
+            return { static_cast<float>(a1), static_cast<float>(g * a1),
+                     static_cast<float>(g * g * a1) };
+        }
+    }
+
+    // cutoff in hz at -3 db, dt in seconds, unity gain at dc
+    template <Response R, size_t Order>
+    constexpr std::array<Biquad::Coefficients, Order / 2u> lowPass(double cutoff, double dt) {
+        // whole sections, and bessel is only tabulated up to 6
+        static_assert(Order > 0u && Order % 2u == 0u);
+        static_assert(R != Response::BESSEL || Order <= 6u);
+
+        std::array<Biquad::Coefficients, Order / 2u> coefficients{};
+        for (size_t i = 0u; i < Order / 2u; ++i) {
+            Detail::Section const section = Detail::section<R, Order>(i);
+            coefficients[i] = Detail::lowPass(cutoff * section.frequencyScale, section.q, dt);
+        }
+        return coefficients;
+    }
+}
+
+// takes the same cutoff and dt as RCFilter so either can smooth a signal
+template <BiquadDesign::Response R, size_t Order>
+class BiquadFilter {
+public:
+    BiquadFilter(float cutoff, float dt)
+        : m_cascade{ BiquadDesign::lowPass<R, Order>(cutoff, dt) } {}
+
+    float update(float input) { return m_cascade.update(input); }
+
+private:
+    BiquadCascade<Order / 2u> m_cascade;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "dsp/Trigonometry.hpp"
+
+#include <array>
+#include <cstddef>
+
+// windowed-sinc designs for FIRFilter, evaluated at compile time. impulse responses are in the
+// order FIRFilter takes them, the tap for the newest sample first
+namespace FIRDesign {
+    namespace Detail {
+        // tap i of N relative to the centre, a half integer when N is even
+        constexpr double offset(size_t i, size_t N) {
+            return static_cast<double>(i) - static_cast<double>(N - 1u) / 2.0;
+        }
+
+        constexpr double hamming(size_t i, size_t N) {
+            if (N == 1u) return 1.0;
+            return 0.54 - 0.46 * Dsp::cosine(2.0 * Dsp::PI * static_cast<double>(i) /
+                                             static_cast<double>(N - 1u));
+        }
+    }
+
+    // cutoff and sampleRate in hz, normalised to unity gain at dc. the delay is (N - 1) / 2
+    // samples
+    template <size_t N>
+    constexpr std::array<float, N> lowPass(double cutoff, double sampleRate) {
+        static_assert(N > 0u);
+
+        double const fc = cutoff / sampleRate;
+
+        std::array<double, N> taps{};
+        double sum = 0.0;
+        for (size_t i = 0u; i < N; ++i) {
+            double const t = Detail::offset(i, N);
+            double const sinc = t == 0.0 ? 2.0 * fc
+                                         : Dsp::sine(2.0 * Dsp::PI * fc * t) / (Dsp::PI * t);
+            taps[i] = sinc * Detail::hamming(i, N);
+            sum += taps[i];
+        }
+
+        std::array<float, N> impulseResponse{};
+        for (size_t i = 0u; i < N; ++i) impulseResponse[i] = static_cast<float>(taps[i] / sum);
+        return impulseResponse;
+    }
+
+    // derivative per second of a signal sampled every dt, scaled so a ramp comes out exactly.
+    // the delay is (N - 1) / 2 samples, an odd N keeps it whole
+    template <size_t N>
+    constexpr std::array<float, N> differentiator(double dt) {
+        static_assert(N > 1u);
+
+        // the ideal response cos(pi t) / t - sin(pi t) / (pi t^2), zero at the centre
+        std::array<double, N> taps{};
+        double slope = 0.0;
+        for (size_t i = 0u; i < N; ++i) {
+            double const t = Detail::offset(i, N);
+            double const ideal = t == 0.0 ? 0.0
+                                          : Dsp::cosine(Dsp::PI * t) / t -
+                                                Dsp::sine(Dsp::PI * t) / (Dsp::PI * t * t);
+            taps[i] = ideal * Detail::hamming(i, N);
+
+            // a unit ramp gives sum(taps[i] * (n - i)) and the taps sum to zero
+            slope -= taps[i] * static_cast<double>(i);
+        }
+
+        std::array<float, N> impulseResponse{};
+        for (size_t i = 0u; i < N; ++i)
+            impulseResponse[i] = static_cast<float>(taps[i] / (slope * dt));
+        return impulseResponse;
+    }
+}
@@ -1,33 +1,33 @@
 #pragma once
 
+#include "dsp/Kernels.hpp"
+
 #include <array>
 #include <cstddef>
 
+// impulseResponse starts with the tap for the newest sample, see FIRDesign
 template <size_t N>
 class FIRFilter {
 public:
-    FIRFilter() = default;
+    constexpr FIRFilter(std::array<float, N> const& impulseResponse) {
+        for (size_t i = 0u; i < N; ++i) m_taps[i] = impulseResponse[N - 1u - i];
+    }
 
     float update(float input) {
+        // every sample is written twice, N apart, so the last N always sit in one unbroken run
+        // from m_bufferIndex + 1 and the taps are a straight dot product over it
         m_buffer[m_bufferIndex] = input;
+        m_buffer[m_bufferIndex + N] = input;
 
-        ++m_bufferIndex;
-        m_bufferIndex %= N;
-
-        float output = 0.0f;
-        size_t sumIndex = m_bufferIndex;
-        for (size_t i = 0; i < N; ++i) {
-            if (sumIndex > 0) sumIndex--;
-            else sumIndex = N - 1;
-
-            output += m_impulseResponse[i] * m_buffer[sumIndex];
-        }
+        float const output = Dsp::dot(m_taps.data(), m_buffer.data() + m_bufferIndex + 1u, N);
 
+        m_bufferIndex = m_bufferIndex + 1u == N ? 0u : m_bufferIndex + 1u;
         return output;
     }
 
 private:
-    std::array<float, N> m_impulseResponse{};
-    std::array<float, N> m_buffer{};
+    // oldest first, to line up with the buffer
+    std::array<float, N> m_taps{};
+    std::array<float, 2u * N> m_buffer{};
     size_t m_bufferIndex{ 0u };
 };
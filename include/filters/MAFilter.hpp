@@ -1,5 +1,7 @@
 #pragma once
 
+#include "dsp/Kernels.hpp"
+
 #include <array>
 #include <cstddef>
 
@@ -9,17 +11,21 @@ public:
     MAFilter() = default;
 
     float update(float input) {
-        output -= buffer[bufferIndex];
+        output = Dsp::mac(output, -SCALE, buffer[bufferIndex]);
         buffer[bufferIndex] = input;
-        output += buffer[bufferIndex];
+        output = Dsp::mac(output, SCALE, buffer[bufferIndex]);
 
         ++bufferIndex;
         bufferIndex %= FilterLength;
 
-        return output / static_cast<float>(FilterLength);
+        return output;
     }
 
 private:
+    // the running sum is kept already divided, each sample scaled as it goes in and out. for a
+    // power of two length the scale is exact and this rounds the same as dividing the sum
+    static constexpr float SCALE = 1.0f / static_cast<float>(FilterLength);
+
     std::array<float, FilterLength> buffer{};
     size_t bufferIndex{ 0u };
 
@@ -7,9 +7,7 @@ public:
     float update(float input);
 
 private:
-    float const m_tau{};
-    float const m_coefficient1{};
-    float const m_coefficient2{};
-    
+    float const m_alpha{};
+
     float m_prevOutput = 0.0f;
 };
@@ -2,17 +2,43 @@
 
 #include "Constants.hpp"
 
-#include "filters/LagFilter.hpp"
+#include "filters/BiquadDesign.hpp"
 #include "filters/RCFilter.hpp"
 
+#include "kinematics/SlipDetector.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "state/Radians.hpp"
 #include "state/Vector.hpp"
 
+#include "tuning/Parameters.hpp"
+
 #include <optional>
 #include <utility>
 
-class ForwardKinematics {
+template <RobotProfileType Profile>
+class BasicForwardKinematics {
 public:
-    ForwardKinematics(Vec2 const& wheelAngles, float dt);
+    // the velocity regulator acts on the shape of the velocity, so it gets the steeper bessel.
+    // public so anything compared against the velocity can be put through the same lag
+    using VelocityFilter = BiquadFilter<BiquadDesign::Response::BESSEL, 4u>;
+
+    BasicForwardKinematics(Vec2 const& wheelAngles, float dt)
+        : m_velocityXFilter{ Parameters::value<Profile, Parameters::VELOCITY_CUTOFF_FREQUENCY>(),
+                             dt },
+          m_velocityYFilter{ Parameters::value<Profile, Parameters::VELOCITY_CUTOFF_FREQUENCY>(),
+                             dt },
+          m_leftWheelSpeedFilter{
+              Parameters::value<Profile, Parameters::WHEEL_SPEED_CUTOFF_FREQUENCY>(), dt },
+          m_rightWheelSpeedFilter{
+              Parameters::value<Profile, Parameters::WHEEL_SPEED_CUTOFF_FREQUENCY>(), dt },
+          m_angularVelocityFilter{
+              Parameters::value<Profile, Parameters::ANGULAR_VELOCITY_CUTOFF_FREQUENCY>(), dt },
+          m_slipDetector{ dt },
+          m_prevWheelAngles{ wheelAngles },
+          m_dt{ dt } {}
 
     struct State {
         Vec2 position{};
@@ -22,23 +48,82 @@ public:
 
         float angle{};
         float angularVelocity{};
+
+        // the position is worth less while a wheel slips, traction is what the straight manager
+        // keeps of its acceleration limits
+        bool slipping{ false };
+        float traction{ 1.0f };
     };
 
     void update(Vec2 const& wheelAngles, std::optional<float> heading,
-                std::optional<float> angularVelocity);
+                std::optional<float> angularVelocity) {
+        using Chassis = Profile::Chassis;
+
+        Radians const dWheelAngleLeft{ wheelAngles.x - m_prevWheelAngles.x };
+        Radians const dWheelAngleRight{ wheelAngles.y - m_prevWheelAngles.y };
+
+        float const dLeft = Chassis::WHEEL_RADIUS * dWheelAngleLeft.toFloat();
+        float const dRight = Chassis::WHEEL_RADIUS * dWheelAngleRight.toFloat();
+        float const d = (dLeft + dRight) / 2.0f;
+
+        float const deltaTheta = (dRight - dLeft) / Chassis::AXLE_LENGTH;
+        float const theta = heading.value_or(m_prevTheta + deltaTheta);
+
+        // m_state.position += Vec2::fromPolar(d, m_prevTheta + deltaTheta / 2.0f);
+        m_state.position += Vec2::fromPolar(d, (m_prevTheta + theta) / 2.0f);
+        m_state.angle = theta;
+        m_state.angularVelocity = angularVelocity.value_or(
+            m_angularVelocityFilter.update((theta - m_prevTheta) / m_dt));
+
+        Vec2 const velocity{ (m_state.position - m_prevPosition) / m_dt };
+        m_state.velocity.x = m_velocityXFilter.update(velocity.x);
+        m_state.velocity.y = m_velocityYFilter.update(velocity.y);
+
+        m_state.wheelSpeeds.x = m_leftWheelSpeedFilter.update(dWheelAngleLeft.toFloat() / m_dt);
+        m_state.wheelSpeeds.y = m_rightWheelSpeedFilter.update(dWheelAngleRight.toFloat() / m_dt);
+
+        m_slipDetector.update(deltaTheta / m_dt, angularVelocity, m_state.wheelSpeeds);
+        m_state.slipping = m_slipDetector.slipping();
+        m_state.traction = m_slipDetector.traction();
+
+        m_prevPosition = m_state.position;
+        m_prevWheelAngles = wheelAngles;
+        m_prevTheta = theta;
+    }
+
+    // constant velocity and turn rate, dt is a few fast loop periods at most so the rotation of the
+    // velocity uses the small angle form
+    static State predict(State const& state, float dt) {
+        float const turn = state.angularVelocity * dt;
+        auto const rotate = [](Vec2 const& v, float angle) -> Vec2 {
+            return { v.x - angle * v.y, v.y + angle * v.x };
+        };
+
+        State predicted{ state };
+        predicted.position += rotate(state.velocity, turn / 2.0f) * dt;
+        predicted.velocity = rotate(state.velocity, turn);
+        predicted.angle += turn;
+        return predicted;
+    }
 
     constexpr decltype(auto) state(this auto&& self) {
         return std::forward_like<decltype(self)>(self.m_state);
     }
 
 private:
-    RCFilter m_velocityXFilter;
-    RCFilter m_velocityYFilter;
+    // the wheel speeds only set the current limits and a single section keeps them quick
+    using WheelSpeedFilter = BiquadFilter<BiquadDesign::Response::BESSEL, 2u>;
+    using AngularVelocityFilter = RCFilter;
+
+    VelocityFilter m_velocityXFilter;
+    VelocityFilter m_velocityYFilter;
 
-    RCFilter m_leftWheelSpeedFilter;
-    RCFilter m_rightWheelSpeedFilter;
+    WheelSpeedFilter m_leftWheelSpeedFilter;
+    WheelSpeedFilter m_rightWheelSpeedFilter;
 
-    RCFilter m_angularVelocityFilter;
+    AngularVelocityFilter m_angularVelocityFilter;
+
+    BasicSlipDetector<Profile> m_slipDetector;
 
     State m_state{};
 
@@ -48,3 +133,5 @@ private:
 
     float const m_dt{};
 };
+
+using ForwardKinematics = BasicForwardKinematics<Robot>;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "filters/RCFilter.hpp"
+
+#include "profiles/Profile.hpp"
+
+#include "state/Vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+// a wheel slips when the encoders turn the robot at a different rate than the gyroscope does, or
+// when a wheel rim speeds up faster than its tyre could push the chassis. traction drops to
+// Slip::TRACTION the moment either happens and climbs back to 1 over Slip::RECOVERY_TIME once
+// both agree again, the straight manager scales its acceleration limits by it
+template <RobotProfileType Profile>
+class BasicSlipDetector {
+public:
+    BasicSlipDetector(float dt)
+        : m_yawRateErrorFilter{ Slip::YAW_RATE_CUTOFF_FREQUENCY, dt },
+          m_rimAccelXFilter{ Slip::RIM_ACCEL_CUTOFF_FREQUENCY, dt },
+          m_rimAccelYFilter{ Slip::RIM_ACCEL_CUTOFF_FREQUENCY, dt },
+          m_recoveryStep{ (1.0f - Slip::TRACTION) * dt / Slip::RECOVERY_TIME },
+          m_dt{ dt } {}
+
+    // the encoder turn rate is the unfiltered one, the difference is filtered instead so both
+    // sides see the same lag. without a gyroscope only the rims are checked
+    void update(float encoderYawRate, std::optional<float> gyroYawRate, Vec2 const& wheelSpeeds) {
+        constexpr float WHEEL_RADIUS = Profile::Chassis::WHEEL_RADIUS;
+
+        float const yawRateError = m_yawRateErrorFilter.update(
+            gyroYawRate ? encoderYawRate - *gyroYawRate : 0.0f);
+
+        Vec2 const rimAccel = (wheelSpeeds - m_prevWheelSpeeds) * (WHEEL_RADIUS / m_dt);
+        float const rimAccelX = m_rimAccelXFilter.update(rimAccel.x);
+        float const rimAccelY = m_rimAccelYFilter.update(rimAccel.y);
+        m_prevWheelSpeeds = wheelSpeeds;
+
+        m_slipping = std::fabsf(yawRateError) > Slip::YAW_RATE_THRESHOLD ||
+                     std::max(std::fabsf(rimAccelX), std::fabsf(rimAccelY)) >
+                         Slip::RIM_ACCEL_THRESHOLD;
+
+        if (m_slipping) m_traction = Slip::TRACTION;
+        else m_traction = std::min(m_traction + m_recoveryStep, 1.0f);
+    }
+
+    bool slipping() const { return m_slipping; }
+    float traction() const { return m_traction; }
+
+private:
+    using Slip = Profile::Kinematics::Slip;
+
+    RCFilter m_yawRateErrorFilter;
+    RCFilter m_rimAccelXFilter;
+    RCFilter m_rimAccelYFilter;
+
+    Vec2 m_prevWheelSpeeds{};
+
+    bool m_slipping{ false };
+    float m_traction{ 1.0f };
+
+    float const m_recoveryStep{};
+    float const m_dt{};
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "fusion/Fusion.hpp"
+
+#include "kinematics/ForwardKinematics.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "profiling/Stages.hpp"
+
+#include "state/Vector.hpp"
+
+// everything core1 does with a sample once it is in physical units, shared with the replay so a
+// recorded run goes through exactly the same code. measure times each stage on the robot
+template <RobotProfileType Profile>
+class BasicFastLoop {
+public:
+    using State = BasicForwardKinematics<Profile>::State;
+
+    BasicFastLoop(Vec2 const& wheelAngles, float dt)
+        : m_fusion{ dt }, m_forwardKinematics{ wheelAngles, dt } {}
+
+    template <typename Measure = Stages::Unmeasured>
+    State const& update(Vec2 const& wheelAngles, float angularVelocity, Measure&& measure = {}) {
+        float const angle = measure(Stages::FUSION,
+                                    [&] { return m_fusion.update(angularVelocity); });
+
+        measure(Stages::KINEMATICS,
+                [&] { m_forwardKinematics.update(wheelAngles, angle, angularVelocity); });
+        return m_forwardKinematics.state();
+    }
+
+private:
+    Fusion m_fusion;
+    BasicForwardKinematics<Profile> m_forwardKinematics;
+};
+
+using FastLoop = BasicFastLoop<Robot>;
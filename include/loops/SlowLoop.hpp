@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "dsp/Kernels.hpp"
+
+#include "kinematics/ForwardKinematics.hpp"
+
+#include "managers/Follower.hpp"
+
+#include "path/Path.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "profiling/Stages.hpp"
+
+#include "regulators/BatteryEstimator.hpp"
+#include "regulators/CurrentRegulator.hpp"
+#include "regulators/FeedforwardEstimator.hpp"
+#include "regulators/VelocityRegulator.hpp"
+
+#include "state/Vector.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+// the follower and both regulators, from the fused state to motor voltages. shared with the
+// replay like FastLoop. the state is stateAge old, so it is predicted forward to the tick first.
+// with adaptFeedforward the linear velocity feedforward is refined as it drives. batteryVoltage
+// and batteryCurrent are sampled together, with Integration::BATTERY_SAG_MODEL they fit the pack
+// the regulators plan against, without it batteryVoltage is taken as the pack at rest
+template <RobotProfileType Profile>
+class BasicSlowLoop {
+public:
+    using State = BasicForwardKinematics<Profile>::State;
+
+    BasicSlowLoop(std::span<Path const> path, std::span<float const> targetTimes, float dt,
+                  bool adaptFeedforward = false)
+        : m_follower{ path, targetTimes, dt },
+          m_velocityRegulator{ dt },
+          m_currentRegulator{ dt },
+          m_batteryEstimator{ dt } {
+        if (adaptFeedforward) m_feedforwardEstimator.emplace(dt);
+    }
+
+    template <typename Measure = Stages::Unmeasured>
+    Vec2 update(State const& publishedState, float stateAge, float elapsed, float batteryVoltage,
+                float batteryCurrent, Measure&& measure = {}) {
+        auto const state = measure(Stages::PREDICTION, [&] {
+            return BasicForwardKinematics<Profile>::predict(
+                publishedState,
+                Dsp::clamp(stateAge, 0.0f, Kinematics::Forward::MAX_PREDICTION_TIME));
+        });
+
+        m_targetSpeeds = measure(Stages::FOLLOWER,
+                                 [&] { return m_follower.update(state, elapsed); });
+
+        measure(Stages::ESTIMATION, [&] {
+            if constexpr (Integration::BATTERY_SAG_MODEL)
+                m_batteryEstimator.update(batteryVoltage, batteryCurrent);
+            if (m_feedforwardEstimator) adapt(batteryVoltage, state.slipping);
+        });
+
+        m_targetVoltages = measure(Stages::VELOCITY_REGULATOR, [&] {
+            m_velocityRegulator.setTargets(m_targetSpeeds.x, m_targetSpeeds.y);
+            return m_velocityRegulator.update(state.velocity, state.angle, state.angularVelocity,
+                                              openCircuitVoltage(batteryVoltage));
+        });
+
+        m_motorPower = measure(Stages::CURRENT_REGULATOR, [&] {
+            m_currentRegulator.setTargetVoltage(m_targetVoltages);
+            return m_currentRegulator.update(state.wheelSpeeds, openCircuitVoltage(batteryVoltage),
+                                             batteryResistance(), state.traction);
+        });
+        return m_motorPower;
+    }
+
+    bool finished() { return m_follower.finished(); }
+
+    // the setpoints of the last update, for telemetry
+    size_t segment() const { return m_follower.index(); }
+    Vec2 targetSpeeds() const { return m_targetSpeeds; }
+    Vec2 targetVoltages() const { return m_targetVoltages; }
+    Vec2 motorTemperatures() const { return m_currentRegulator.thermalModel().temperatures(); }
+
+    // empty unless the loop was built to adapt its feedforward
+    std::optional<BasicFeedforwardEstimator<Profile>> const& feedforwardEstimator() const {
+        return m_feedforwardEstimator;
+    }
+
+private:
+    float openCircuitVoltage(float batteryVoltage) const {
+        if constexpr (Integration::BATTERY_SAG_MODEL)
+            return m_batteryEstimator.openCircuitVoltage();
+        else return batteryVoltage;
+    }
+
+    float batteryResistance() const {
+        if constexpr (Integration::BATTERY_SAG_MODEL) return m_batteryEstimator.resistance();
+        else return 0.0f;
+    }
+
+    // the power of the last tick against the velocities it was worked out from, a tick behind on
+    // both sides
+    void adapt(float batteryVoltage, bool slipping) {
+        constexpr float MAX_POWER = static_cast<float>(Drivers::Motors::MAX_POWER);
+
+        m_feedforwardEstimator->update(m_motorPower * (batteryVoltage / MAX_POWER),
+                                       m_velocityRegulator.linearVelocity(), slipping);
+
+        if (m_feedforwardEstimator->settled())
+            m_velocityRegulator.setLinearFeedforward(m_feedforwardEstimator->feedforward());
+    }
+
+    BasicFollower<Profile> m_follower;
+    BasicVelocityRegulator<Profile> m_velocityRegulator;
+    BasicCurrentRegulator<Profile> m_currentRegulator;
+    std::optional<BasicFeedforwardEstimator<Profile>> m_feedforwardEstimator{};
+    BasicBatteryEstimator<Profile> m_batteryEstimator;
+
+    Vec2 m_targetSpeeds{};
+    Vec2 m_targetVoltages{};
+    Vec2 m_motorPower{};
+};
+
+using SlowLoop = BasicSlowLoop<Robot>;
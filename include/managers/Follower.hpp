@@ -10,21 +10,24 @@
 
 #include "path/Path.hpp"
 
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
 #include "state/Radians.hpp"
 #include "state/Vector.hpp"
 
 #include <algorithm>
-#include <array>
 #include <cmath>
 #include <cstddef>
 #include <optional>
+#include <span>
 
 using uint = unsigned int;
 
-template <size_t N>
-class Follower {
+template <RobotProfileType Profile>
+class BasicFollower {
 public:
-    Follower(std::array<Path, N> const& path, std::array<float, N> const& targetTimes, float dt)
+    BasicFollower(std::span<Path const> path, std::span<float const> targetTimes, float dt)
         : m_path{ path },
           m_targetTimes{ targetTimes },
           m_straightManager{ dt },
@@ -33,34 +36,39 @@ public:
     }
 
     bool finished() { return m_finished; }
+    size_t index() const { return m_index; }
 
-    Vec2 update(ForwardKinematics::State const& state, float currentTime) {
+    Vec2 update(typename BasicForwardKinematics<Profile>::State const& state, float currentTime) {
         if (m_exitCondition.check(state.position, state.angle))
             m_finished = setupNextMode(state.position);
         if (m_finished) return { 0.0f, 0.0f };
 
         if (m_mode == movement)
-            return m_straightManager.update(state.position, state.angle, currentTime);
+            return m_straightManager.update(state.position, state.angle, currentTime,
+                                            state.traction);
         else if (m_mode == rotation) return m_rotationManager.update(state.angle);
         else return { 0.0f, 0.0f };
     }
 
 private:
+    using Thresholds = Profile::Manager::Follower;
+    using Movement = BasicStraight<Profile>::Movement;
+
     void setupMovement(Vec2 const& currentPosition) {
         Vec2 const& startPosition = m_index == 0u ? Vec2{ 0.0f, 0.0f }
                                                   : m_path[m_index - 1].position;
 
-        Straight::Movement const currentMovement{ m_path[m_index], m_targetTimes[m_index] };
+        Movement const currentMovement{ m_path[m_index], m_targetTimes[m_index] };
         auto const nextMovement = m_index < m_path.size() - 1u
-                                      ? std::make_optional<Straight::Movement>(
+                                      ? std::make_optional<Movement>(
                                             m_path[m_index + 1], m_targetTimes[m_index + 1])
                                       : std::nullopt;
 
-        float distanceThreshold = Manager::Follower::TURNING_RADIUS;
+        float distanceThreshold = Thresholds::TURNING_RADIUS;
         if (currentMovement.path.flags & Path::ACCURATE)
-            distanceThreshold = Manager::Follower::DISTANCE_THRESHOLD_ACCURATE;
+            distanceThreshold = Thresholds::DISTANCE_THRESHOLD_ACCURATE;
         else if (currentMovement.path.flags & Path::STOP)
-            distanceThreshold = Manager::Follower::DISTANCE_THRESHOLD_FAST;
+            distanceThreshold = Thresholds::DISTANCE_THRESHOLD_FAST;
 
         m_straightManager.set(startPosition, currentMovement, nextMovement, distanceThreshold);
         m_exitCondition.set(
@@ -78,18 +86,18 @@ private:
         if (path.flags & Path::REVERSE) targetAngle += Radians{ Constants::PI };
 
         m_rotationManager.set(targetAngle);
-        m_exitCondition.set(std::nullopt, { { targetAngle, Manager::Follower::ANGLE_THRESHOLD } });
+        m_exitCondition.set(std::nullopt, { { targetAngle, Thresholds::ANGLE_THRESHOLD } });
 
         m_mode = rotation;
     }
 
     bool setupNextMode(Vec2 const& currentPosition) {
-        if (m_index == N) return true;
+        if (m_index == m_path.size()) return true;
 
         if (m_mode == none || m_mode == rotation) setupMovement(currentPosition);
         else if (m_mode == movement) {
             ++m_index;
-            if (m_index == N) return true;
+            if (m_index == m_path.size()) return true;
 
             if (m_path[m_index - 1].flags & Path::STOP) setupRotation();
             else setupMovement(currentPosition);
@@ -100,11 +108,11 @@ private:
 
     enum Mode { none, wait, movement, rotation };
 
-    std::array<Path, N> m_path{};
-    std::array<float, N> m_targetTimes{};
+    std::span<Path const> m_path{};
+    std::span<float const> m_targetTimes{};
 
-    Straight m_straightManager;
-    Rotation m_rotationManager;
+    BasicStraight<Profile> m_straightManager;
+    BasicRotation<Profile> m_rotationManager;
 
     ExitCondition m_exitCondition{};
 
@@ -116,3 +124,5 @@ private:
 
     bool m_finished{ false };
 };
+
+using Follower = BasicFollower<Robot>;
@@ -6,22 +6,44 @@
 #include "control/feedforward/SController.hpp"
 #include "control/pid/PController.hpp"
 
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
 #include "state/Radians.hpp"
 #include "state/Vector.hpp"
 
-class Rotation {
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+
+template <RobotProfileType Profile>
+class BasicRotation {
 public:
-    Rotation() = default;
+    BasicRotation() = default;
 
     Radians targetAngle() const { return m_targetAngle; }
 
     void set(Radians targetAngle) { m_targetAngle = targetAngle; }
 
-    Vec2 update(Radians currentAngle);
+    Vec2 update(Radians currentAngle) {
+        constexpr float GRABBING_SPEED = Profile::Manager::Rotation::GRABBING_SPEED;
+        constexpr float MAX_SPEED = Profile::Manager::Rotation::MAX_SPEED;
+
+        Radians const angularError = m_targetAngle - currentAngle;
+
+        float const angularVelocity = m_rotationController.update(angularError, 0.0f);
+        float const clampedAngularVelocity = std::clamp(angularVelocity, -MAX_SPEED, MAX_SPEED);
+
+        return { GRABBING_SPEED, clampedAngularVelocity };
+    }
 
 private:
-    Controller<SController, PController> m_rotationController{ { Manager::Rotation::kS },
-                                                               { Manager::Rotation::kP } };
+    Controller<SController, PController> m_rotationController{
+        { Parameters::value<Profile, Parameters::ROTATION_KS>() },
+        { Parameters::value<Profile, Parameters::ROTATION_KP>() }
+    };
 
     Radians m_targetAngle{};
 };
+
+using Rotation = BasicRotation<Robot>;
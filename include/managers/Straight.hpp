@@ -11,29 +11,230 @@
 
 #include "path/Path.hpp"
 
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
 #include "state/Radians.hpp"
 #include "state/Vector.hpp"
 
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <cmath>
 #include <optional>
 
-class Straight {
+template <RobotProfileType Profile>
+class BasicStraight {
 public:
     struct Movement {
         Path path{};
         float targetTime{};
     };
 
-    Straight(float dt);
+    BasicStraight(float dt)
+        : m_headingController{
+              { Parameters::value<Profile, Parameters::STRAIGHT_ANGULAR_KP>() },
+              { Parameters::value<Profile, Parameters::STRAIGHT_ANGULAR_KD>(),
+                Limits::FILTER_ALPHA, dt } },
+          m_linearController{ { Parameters::value<Profile, Parameters::STRAIGHT_LINEAR_KP>() },
+                              { Parameters::value<Profile, Parameters::STRAIGHT_LINEAR_KD>(),
+                                Limits::FILTER_ALPHA, dt } },
+          m_angularSpeedFilter{ Limits::CENTRIPETAL_FILTER_CUTOFF, dt } {}
 
     void set(Vec2 const& startPosition, Movement const& currentMovement,
-             std::optional<Movement> const& nextMovement, float stoppingRadius);
+             std::optional<Movement> const& nextMovement, float stoppingRadius) {
+        m_startPosition = startPosition;
+        m_targetPosition = currentMovement.path.position;
+        m_stoppingRadius = stoppingRadius;
+
+        m_targetAngle = (m_targetPosition - m_startPosition).angle();
+        m_turnAngle = getTurnAngle(startPosition, currentMovement, nextMovement);
+        m_targetTime = currentMovement.targetTime;
+
+        m_turnSpeed = getTurnSpeed(nextMovement, currentMovement, m_turnAngle);
+        m_finalSpeed = getFinalSpeed(nextMovement, currentMovement, m_stoppingRadius,
+                                     m_turnAngle, m_turnSpeed);
+
+        m_reverse = currentMovement.path.flags & Path::REVERSE;
+    }
 
-    Vec2 update(Vec2 const& currentPosition, Radians currentAngle, float currentTime);
+    // traction scales the acceleration limits down while the wheels slip, the turn speed with its
+    // root as that comes from the centripetal limit
+    Vec2 update(Vec2 const& currentPosition, Radians currentAngle, float currentTime,
+                float traction) {
+        float const headingError = getHeadingError(m_targetAngle, currentAngle, m_reverse);
+        float const headingErrorSpeed = m_headingController.update(0.0f, headingError);
+        float const linearError = getLinearError(m_startPosition, m_targetPosition,
+                                                 currentPosition);
+        float const linearErrorSpeed = m_linearController.update(0.0f, linearError);
+
+        float const linearControl = getLinearControl(headingError, m_turnAngle);
+        float const angularSpeed = getAngularSpeed(headingErrorSpeed, linearErrorSpeed,
+                                                   linearControl);
+
+        float const slowdownAccel = Limits::SLOWDOWN_ACCEL * traction;
+        std::optional<float> finalSpeed = m_finalSpeed;
+        if (finalSpeed && traction < 1.0f)
+            finalSpeed = std::min(*finalSpeed, m_turnSpeed * std::sqrtf(traction));
+
+        float const distanceLeft = getDistanceLeft(m_targetPosition, currentPosition);
+        float const slowdownSpeed = getSlowdownSpeed(finalSpeed, distanceLeft, m_stoppingRadius,
+                                                     slowdownAccel);
+        auto const targetSpeed = getTargetSpeed(m_targetTime, currentTime, distanceLeft,
+                                                finalSpeed, slowdownAccel);
+        float const linearSpeed = getLinearSpeed(targetSpeed, slowdownSpeed, m_reverse);
+
+        return limitSpeeds(linearSpeed, angularSpeed, traction);
+    }
 
 private:
-    float getLinearSpeed(std::optional<float> targetSpeed, float slowdownSpeed, bool reverse);
+    using Limits = Profile::Manager::Straight;
+
+    static float getHeadingError(Radians targetAngle, Radians currentAngle, bool reverse) {
+        Radians headingError = currentAngle - targetAngle;
+        if (reverse) return headingError + Radians{ Constants::PI };
+        else return headingError;
+    }
+
+    static float getLinearError(Vec2 const& startPosition, Vec2 const& targetPosition,
+                                Vec2 const& currentPosition) {
+        Vec2 const pathVector = targetPosition - startPosition;
+        Vec2 const startToCurrentPosition = currentPosition - startPosition;
+        float const lateralError = Vec2::cross(pathVector, startToCurrentPosition) /
+                                   pathVector.length();
+
+        return lateralError;
+    }
+
+    static float getLinearControl(float headingError, float turnAngle) {
+        float const angleBound = std::max(Constants::PI / 16.0f, std::fabsf(turnAngle / 2.0f));
+        if (headingError < -angleBound || headingError > angleBound) return 0.0f;
+        else return Parameters::value<Profile, Parameters::STRAIGHT_LINEAR_CONTROL_AUTHORITY>();
+    }
+
+    static float getAngularSpeed(float headingErrorSpeed, float linearErrorSpeed,
+                                 float linearAuthority) {
+        float const headingErrorSpeedMagnitude = std::fabsf(headingErrorSpeed) + linearAuthority;
+        return std::clamp(linearErrorSpeed, -headingErrorSpeedMagnitude,
+                          headingErrorSpeedMagnitude) +
+               headingErrorSpeed;
+    }
+
+    static float getDistanceLeft(Vec2 const& targetPosition, Vec2 const& currentPosition) {
+        return (targetPosition - currentPosition).length();
+    }
+
+    static float getSlowdownSpeed(std::optional<float> finalSpeed, float distanceLeft,
+                                  float stoppingRadius, float slowdownAccel) {
+        constexpr float MAX_LINEAR_SPEED = Limits::MAX_LINEAR_SPEED;
+
+        if (!finalSpeed) return MAX_LINEAR_SPEED;
+
+        float const slowdownSpeedSquared = *finalSpeed * *finalSpeed +
+                                           2.0f * slowdownAccel * (distanceLeft - stoppingRadius);
+
+        if (slowdownSpeedSquared <= 0.0f) return *finalSpeed;
+        else return std::sqrtf(slowdownSpeedSquared);
+    }
 
-    Vec2 limitSpeeds(float linearSpeed, float angularSpeed);
+    static std::optional<float> getTargetSpeed(float targetTime, float currentTime,
+                                               float distanceLeft,
+                                               std::optional<float> finalSpeed,
+                                               float slowdownAccel) {
+        if (!finalSpeed) return std::nullopt;
+
+        float const timeLeft = targetTime - currentTime;
+        if (timeLeft <= 0.0f) return std::nullopt;
+        if (distanceLeft / timeLeft <= *finalSpeed) return distanceLeft / timeLeft;
+
+        float const determinant = slowdownAccel * slowdownAccel * timeLeft * timeLeft +
+                                  2.0f * slowdownAccel * (*finalSpeed * timeLeft - distanceLeft);
+        if (determinant <= 0.0f) return std::nullopt;
+        else return *finalSpeed + slowdownAccel * timeLeft - std::sqrtf(determinant);
+    }
+
+    static float getTurnAngle(Vec2 const& startPosition, Movement const& currentMovement,
+                              std::optional<Movement> const& nextMovement) {
+        if (!nextMovement) return 0.0f;
+        else {
+            Vec2 const currentDirection = currentMovement.path.position - startPosition;
+            Vec2 const nextDirection = nextMovement->path.position -
+                                       currentMovement.path.position;
+
+            return std::acosf(Vec2::dot(currentDirection, nextDirection) /
+                              (currentDirection.length() * nextDirection.length()));
+        }
+    }
+
+    // the fastest the corner at the end can be taken within the centripetal limit
+    static float getTurnSpeed(std::optional<Movement> const& nextMovement,
+                              Movement const& currentMovement, float turnAngle) {
+        using Thresholds = Profile::Manager::Follower;
+        constexpr float MASS = Profile::Chassis::MASS;
+        constexpr float MAX_CENTRIPETAL = Limits::MAX_CENTRIPETAL;
+        constexpr float MAX_LINEAR_SPEED = Limits::MAX_LINEAR_SPEED;
+
+        if (currentMovement.path.flags & Path::STOP || !nextMovement || turnAngle == 0.0f)
+            return MAX_LINEAR_SPEED;
+
+        float const turnRadius = Thresholds::TURNING_RADIUS *
+                                 std::fabsf(std::tanf((Constants::PI - turnAngle) / 2.0f));
+        return std::sqrtf(MAX_CENTRIPETAL * turnRadius / MASS);
+    }
+
+    static std::optional<float> getFinalSpeed(std::optional<Movement> const& nextMovement,
+                                              Movement const& currentMovement,
+                                              float stoppingRadius, float turnAngle,
+                                              float turnSpeed) {
+        using Thresholds = Profile::Manager::Follower;
+        constexpr float MAX_LINEAR_SPEED = Limits::MAX_LINEAR_SPEED;
+        constexpr float SLOWDOWN_ACCEL = Limits::SLOWDOWN_ACCEL;
+        constexpr float SLOWDOWN_MIN_SPEED = Limits::SLOWDOWN_MIN_SPEED;
+
+        if (currentMovement.path.flags & Path::STOP || !nextMovement) return SLOWDOWN_MIN_SPEED;
+        else if (turnAngle == 0.0f) return MAX_LINEAR_SPEED;
+        else {
+            float const nextTravelLength =
+                (nextMovement->path.position - currentMovement.path.position).length();
+
+            float const slowdownSpeed = nextMovement->path.flags & Path::STOP
+                                            ? getSlowdownSpeed(
+                                                  0.0f, nextTravelLength,
+                                                  Thresholds::DISTANCE_THRESHOLD_ACCURATE,
+                                                  SLOWDOWN_ACCEL)
+                                            : MAX_LINEAR_SPEED;
+            float const nextTargetTime = nextMovement->targetTime - currentMovement.targetTime;
+            float const nextSpeed = nextTargetTime != 0.0f ? nextTravelLength / nextTargetTime
+                                                           : MAX_LINEAR_SPEED;
+
+            return std::min({ turnSpeed, slowdownSpeed, nextSpeed, MAX_LINEAR_SPEED });
+        }
+    }
+
+    float getLinearSpeed(std::optional<float> targetSpeed, float slowdownSpeed, bool reverse) {
+        float linearSpeed;
+        if (!targetSpeed) linearSpeed = slowdownSpeed;
+        else linearSpeed = std::min(*targetSpeed, slowdownSpeed);
+
+        return (reverse ? -1.0f : 1.0f) * linearSpeed;
+    }
+
+    Vec2 limitSpeeds(float linearSpeed, float angularSpeed, float traction) {
+        constexpr float MASS = Profile::Chassis::MASS;
+        constexpr float TURN_ANGULAR_SPEED = Limits::TURN_ANGULAR_SPEED;
+
+        float const maxCentripetal = Limits::MAX_CENTRIPETAL * traction;
+
+        angularSpeed = std::clamp(angularSpeed, -TURN_ANGULAR_SPEED, TURN_ANGULAR_SPEED);
+        float const filteredAngularSpeed = m_angularSpeedFilter.update(angularSpeed);
+
+        if (angularSpeed != 0.0f) {
+            float const maxLinearSpeed = maxCentripetal / std::fabsf(filteredAngularSpeed) / MASS;
+            linearSpeed = std::clamp(linearSpeed, -maxLinearSpeed, maxLinearSpeed);
+        }
+
+        return { linearSpeed, angularSpeed };
+    }
 
     Controller<PController, DController> m_headingController;
     Controller<PController, DController> m_linearController;
@@ -49,7 +250,10 @@ private:
     float m_targetTime{};
 
     float m_turnAngle{};
+    float m_turnSpeed{};
     float m_stoppingRadius{};
 
     bool m_reverse{};
 };
+
+using Straight = BasicStraight<Robot>;
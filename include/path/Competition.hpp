@@ -11,7 +11,7 @@ namespace Competition {
     using namespace Compiler::Tokens;
 
     inline constexpr bool FAIL_RUN = false;
-    inline constexpr float TARGET_TIME = 5.0f;
+    inline constexpr float TARGET_TIME = 6.0f;
 
     inline constexpr auto COMMANDS = std::to_array<Compiler::Command>({
         // clang-format off
@@ -28,4 +28,12 @@ namespace Competition {
     inline constexpr auto TARGET_TIMES = Compiler::getTargetTimes(COMMANDS, PATH, TARGET_TIME);
     inline constexpr auto TURN_TIMES = Compiler::TargetTime::getTurnTimes(PATH);
     inline constexpr Vec2 DESTINATION = Compiler::getDestination(PATH) / SQUARE_SIZE;
+
+    // rotour-report shows which segment and by how much
+    static_assert(Compiler::Feasibility::hasTimeToDrive(PATH, TARGET_TIMES, TURN_TIMES),
+                  "TARGET_TIME is shorter than the turns, a segment has no time left to drive");
+    static_assert(Compiler::Feasibility::canStopInTime(PATH, TARGET_TIMES, TURN_TIMES),
+                  "a segment cannot be driven in its time and still stop at SLOWDOWN_ACCEL");
+    static_assert(Compiler::Feasibility::withinMaxSpeed(PATH, TARGET_TIMES, TURN_TIMES),
+                  "a segment needs more than MAX_LINEAR_SPEED to be driven in its time");
 }
@@ -7,10 +7,14 @@
 
 #include "path/Path.hpp"
 
+#include "profiles/Robot.hpp"
+
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
-#include <numeric>
 #include <optional>
+#include <span>
 #include <tuple>
 
 using uint = unsigned int;
@@ -45,7 +49,7 @@ namespace Compiler {
     struct LastMove {};
 
     namespace Tokens {
-        using Chassis::DOWEL_DISTANCE;
+        inline constexpr float DOWEL_DISTANCE = Robot::Chassis::DOWEL_DISTANCE;
         using Track::SQUARE_SIZE;
 
         inline constexpr Vec2 UP{ 0.0f, 1.0f };
@@ -125,126 +129,221 @@ namespace Compiler {
     }
 
     template <size_t N>
-    constexpr std::array<Path, N> compile(std::array<Command, N> const& commands) {
-        std::array<Path, N> path{};
+    constexpr void compile(std::array<Command, N> const& commands, std::array<Path, N>& path,
+                           size_t size = N) {
         Vec2 currentPosition{ 0.0f, 0.0f };
 
-        for (size_t i = 0; i < commands.size(); ++i) {
+        for (size_t i = 0; i < size; ++i) {
             Command const& command = commands[i];
-            Command const& nextCommand = commands[i + 1];
 
             if (command.relative) currentPosition += command.amount * command.units;
             else currentPosition = command.amount * command.units;
 
-            Path segment{ currentPosition, command.flags };
+            // the offset moves this point only, the next command still starts from the original
+            Path segment{ currentPosition + command.offset, command.flags };
 
-            if (i == commands.size() - 1) {
+            if (i == size - 1) {
                 segment.flags |= Path::STOP;
                 segment.flags |= Path::ACCURATE;
-            } else if (Vec2::dot(command.amount, nextCommand.amount) < 0.0f ||
-                       (command.flags & Path::REVERSE) != (nextCommand.flags & Path::REVERSE))
-                segment.flags |= Path::STOP;
+            } else {
+                Command const& nextCommand = commands[i + 1];
+                if (Vec2::dot(command.amount, nextCommand.amount) < 0.0f ||
+                    (command.flags & Path::REVERSE) != (nextCommand.flags & Path::REVERSE))
+                    segment.flags |= Path::STOP;
+            }
 
             path[i] = segment;
         }
+    }
 
-        for (size_t i = 0; i < commands.size(); ++i) {
-            Command const& command = commands[i];
-            Path& pathSegment = path[i];
-
-            pathSegment.position += command.offset;
-        }
-
+    template <size_t N>
+    constexpr std::array<Path, N> compile(std::array<Command, N> const& commands,
+                                          size_t size = N) {
+        std::array<Path, N> path{};
+        compile(commands, path, size);
         return path;
     }
 
     namespace TargetTime {
         template <size_t N>
-        constexpr float getEffectiveLength(std::array<Command, N> const& commands,
-                                           std::array<Path, N> const& path) {
-            Vec2 previousPosition{ 0.0f, 0.0f };
-            float totalLength = 0.0f;
-            for (size_t i = 0; i < N; ++i) {
-                Vec2 const& currentPosition = path[i].position;
+        constexpr void getTurnTimes(std::array<Path, N> const& path,
+                                    std::array<float, N>& turnTimes, size_t size = N) {
+            constexpr float MAX_SPEED = Robot::Manager::Rotation::MAX_SPEED;
+            constexpr float TURN_TIME_OFFSET = Robot::Manager::Rotation::TURN_TIME_OFFSET;
+
+            std::fill(turnTimes.begin(), turnTimes.end(), 0.0f);
+
+            // the heading of each segment, worked out at most once and only around stops
+            auto const heading = [&path](size_t i) {
+                Vec2 const start = i == 0 ? Vec2{ 0.0f, 0.0f } : path[i - 1].position;
+                Radians angle{ (path[i].position - start).angle() };
+                if (path[i].flags & Path::REVERSE) angle += Constants::PI;
+                return angle;
+            };
+
+            std::optional<Radians> previousHeading{};
+            for (size_t i = 1; i < size; ++i) {
+                if (!(path[i - 1].flags & Path::STOP)) {
+                    previousHeading.reset();
+                    continue;
+                }
+
+                Radians const currentHeading = heading(i);
+                if (!previousHeading) previousHeading = heading(i - 1);
+
+                float angle = currentHeading - *previousHeading;
+                if (angle < 0.0f) angle = -angle;
 
-                if (!commands[i].targetTime)
-                    totalLength += (currentPosition - previousPosition).length();
+                if (angle > 1.0e-6f) turnTimes[i] = angle / MAX_SPEED + TURN_TIME_OFFSET;
 
-                previousPosition = currentPosition;
+                previousHeading = currentHeading;
             }
-            return totalLength;
         }
 
         template <size_t N>
-        constexpr std::array<float, N> getTurnTimes(std::array<Path, N> const& path) {
-            using Manager::Rotation::MAX_SPEED;
-            using Manager::Rotation::TURN_TIME_OFFSET;
-
+        constexpr std::array<float, N> getTurnTimes(std::array<Path, N> const& path,
+                                                    size_t size = N) {
             std::array<float, N> turnTimes{ 0.0f };
+            getTurnTimes(path, turnTimes, size);
+            return turnTimes;
+        }
+    }
 
-            Vec2 firstPosition{ 0.0f, 0.0f };
-            Vec2 secondPosition = path[0].position;
-            for (size_t i = 1; i < N; ++i) {
-                Vec2 const& thirdPosition = path[i].position;
-
-                if (path[i - 1].flags & Path::STOP) {
-                    Radians angle1{ (thirdPosition - secondPosition).angle() };
-                    Radians angle2{ (secondPosition - firstPosition).angle() };
-
-                    if (path[i].flags & Path::REVERSE) angle1 += Constants::PI;
-                    if (path[i - 1].flags & Path::REVERSE) angle2 += Constants::PI;
-
-                    float angle = angle1 - angle2;
-                    if (angle < 0.0f) angle = -angle;
-
-                    if (angle > 1.0e-6f) turnTimes[i] = angle / MAX_SPEED + TURN_TIME_OFFSET;
-                }
+    template <size_t N>
+    constexpr void getTargetTimes(std::array<Command, N> const& commands,
+                                  std::array<Path, N> const& path,
+                                  std::array<float, N> const& turnTimes, float targetTime,
+                                  std::array<float, N>& targetTimes, size_t size = N) {
+        // one pass for the totals, parking each segment's length in its target time, then one to
+        // share out what is left after the turns and the fixed times
+        float effectiveLength = 0.0f;
+        float totalTurnTime = 0.0f;
+        float totalForcedTargetTime = 0.0f;
+
+        std::fill(targetTimes.begin(), targetTimes.end(), 0.0f);
+        Vec2 prevPosition{ 0.0f, 0.0f };
+        for (size_t i = 0; i < size; ++i) {
+            Vec2 const& currentPosition = path[i].position;
 
-                firstPosition = secondPosition;
-                secondPosition = thirdPosition;
+            totalTurnTime += turnTimes[i];
+            if (commands[i].targetTime) totalForcedTargetTime += commands[i].targetTime.value();
+            else {
+                targetTimes[i] = (currentPosition - prevPosition).length();
+                effectiveLength += targetTimes[i];
             }
 
-            return turnTimes;
+            prevPosition = currentPosition;
         }
 
-        template <size_t N>
-        constexpr float getTotalForcedTargetTime(std::array<Command, N> const& commands) {
-            float totalForcedTargetTime = 0.0f;
-            for (size_t i = 0; i < N; ++i)
-                if (commands[i].targetTime) totalForcedTargetTime += commands[i].targetTime.value();
-            return totalForcedTargetTime;
+        float effectiveTargetTime = targetTime - totalTurnTime - totalForcedTargetTime;
+
+        float accumulatedTime = 0.0f;
+        for (size_t i = 0; i < size; ++i) {
+            accumulatedTime += commands[i].targetTime.value_or(
+                effectiveTargetTime * targetTimes[i] / effectiveLength + turnTimes[i]);
+            targetTimes[i] = accumulatedTime;
         }
     }
 
     template <size_t N>
     constexpr std::array<float, N> getTargetTimes(std::array<Command, N> const& commands,
                                                   std::array<Path, N> const& path,
-                                                  float targetTime) {
-        float effectiveLength = TargetTime::getEffectiveLength(commands, path);
-
-        std::array<float, N> turnTimes = TargetTime::getTurnTimes(path);
-        float totalTurnTime = std::accumulate(turnTimes.begin(), turnTimes.end(), 0.0f);
-        float totalForcedTargetTime = TargetTime::getTotalForcedTargetTime(commands);
-        float effectiveTargetTime = targetTime - totalTurnTime - totalForcedTargetTime;
+                                                  float targetTime, size_t size = N) {
+        std::array<float, N> turnTimes = TargetTime::getTurnTimes(path, size);
 
         std::array<float, N> targetTimes{};
-        float accumulatedTime = 0.0f;
-        Vec2 prevPosition{ 0.0f, 0.0f };
-        for (size_t i = 0; i < N; ++i) {
-            Vec2 const& currentPosition = path[i].position;
+        getTargetTimes(commands, path, turnTimes, targetTime, targetTimes, size);
+        return targetTimes;
+    }
 
-            accumulatedTime += commands[i].targetTime.value_or(
-                effectiveTargetTime * (currentPosition - prevPosition).length() / effectiveLength +
-                turnTimes[i]);
-            targetTimes[i] = accumulatedTime;
+    // what a compiled route asks of the straight manager. a segment drives in what is left of its
+    // target time once the turn before it is done, ending at SLOWDOWN_MIN_SPEED if it stops and
+    // braking no harder than SLOWDOWN_ACCEL, the same limits Straight::update works within.
+    // corner speeds on segments that run into the next are not modelled
+    namespace Feasibility {
+        struct Segment {
+            float distance{};
+            float targetTime{};
+            float turnTime{};
+            float driveTime{};
+            bool stops{};
+        };
+
+        constexpr Segment getSegment(std::span<Path const> path, std::span<float const> targetTimes,
+                                     std::span<float const> turnTimes, size_t i) {
+            Vec2 const start = i == 0u ? Vec2{ 0.0f, 0.0f } : path[i - 1].position;
+            float const previousTime = i == 0u ? 0.0f : targetTimes[i - 1];
+
+            Segment segment{};
+            segment.distance = (path[i].position - start).length();
+            segment.targetTime = targetTimes[i] - previousTime;
+            segment.turnTime = turnTimes[i];
+            segment.driveTime = segment.targetTime - segment.turnTime;
+            segment.stops = (path[i].flags & Path::STOP) != 0u;
+            return segment;
+        }
 
-            prevPosition = currentPosition;
+        // the cruise speed that covers the segment in its drive time and still brakes to the final
+        // speed in the distance left, as getTargetSpeed in Straight.cpp works it out. nullopt if
+        // braking at SLOWDOWN_ACCEL cannot make it at any speed
+        constexpr std::optional<float> getRequiredSpeed(Segment const& segment) {
+            using Limits = Robot::Manager::Straight;
+            constexpr float MAX_LINEAR_SPEED = Limits::MAX_LINEAR_SPEED;
+            constexpr float SLOWDOWN_ACCEL = Limits::SLOWDOWN_ACCEL;
+            constexpr float SLOWDOWN_MIN_SPEED = Limits::SLOWDOWN_MIN_SPEED;
+
+            if (segment.driveTime <= 0.0f) return std::nullopt;
+
+            float const time = segment.driveTime;
+            float const finalSpeed = segment.stops ? SLOWDOWN_MIN_SPEED : MAX_LINEAR_SPEED;
+            float const distance = segment.distance;
+            if (distance / time <= finalSpeed) return distance / time;
+
+            float const determinant = SLOWDOWN_ACCEL * SLOWDOWN_ACCEL * time * time +
+                                      2.0f * SLOWDOWN_ACCEL * (finalSpeed * time - distance);
+            if (determinant <= 0.0f) return std::nullopt;
+
+            float root{};
+            if consteval {
+                root = VectorHelper::constexprSqrt(determinant);
+            } else {
+                root = std::sqrtf(determinant);
+            }
+            return finalSpeed + SLOWDOWN_ACCEL * time - root;
+        }
+
+        // target times too short for the turns leave segments nothing, or less than nothing
+        constexpr bool hasTimeToDrive(std::span<Path const> path,
+                                      std::span<float const> targetTimes,
+                                      std::span<float const> turnTimes) {
+            for (size_t i = 0u; i < path.size(); ++i)
+                if (getSegment(path, targetTimes, turnTimes, i).driveTime <= 0.0f) return false;
+            return true;
+        }
+
+        constexpr bool canStopInTime(std::span<Path const> path,
+                                     std::span<float const> targetTimes,
+                                     std::span<float const> turnTimes) {
+            for (size_t i = 0u; i < path.size(); ++i) {
+                Segment const segment = getSegment(path, targetTimes, turnTimes, i);
+                if (segment.driveTime > 0.0f && !getRequiredSpeed(segment)) return false;
+            }
+            return true;
+        }
+
+        constexpr bool withinMaxSpeed(std::span<Path const> path,
+                                      std::span<float const> targetTimes,
+                                      std::span<float const> turnTimes) {
+            for (size_t i = 0u; i < path.size(); ++i) {
+                auto const speed = getRequiredSpeed(getSegment(path, targetTimes, turnTimes, i));
+                if (speed && *speed > Robot::Manager::Straight::MAX_LINEAR_SPEED) return false;
+            }
+            return true;
         }
-        return targetTimes;
     }
 
     template <size_t N>
-    constexpr Vec2 getDestination(std::array<Path, N> const& path) {
-        return path[N - 1].position;
+    constexpr Vec2 getDestination(std::array<Path, N> const& path, size_t size = N) {
+        return path[size - 1].position;
     }
 }
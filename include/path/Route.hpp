@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "path/Compiler.hpp"
+#include "path/Path.hpp"
+
+#include "state/Vector.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+class Route {
+public:
+    static constexpr size_t CAPACITY = Track::MAX_ROUTE_LENGTH;
+
+    template <size_t N>
+    Route(std::array<Compiler::Command, N> const& commands, float targetTime)
+        : m_targetTime{ targetTime } {
+        static_assert(N > 0u && N <= CAPACITY, "route does not fit in Track::MAX_ROUTE_LENGTH");
+        setCommands(commands);
+    }
+
+    // false for a route that does not fit or holds a value that is not finite, and for a target
+    // time that is not positive, leaving the route as it was. the host tools take infeasible
+    // routes too, to report on them
+    bool setCommands(std::span<Compiler::Command const> commands);
+    bool setTargetTime(float targetTime);
+
+    // as above, but kept only if the straight manager can keep to the result as well, for routes
+    // the robot is about to drive. the route is compiled in place and put back if it is refused.
+    // the commands are swapped in rather than copied so no second route is needed, which leaves
+    // the caller's buffer holding the commands the route does not
+    bool setIfFeasible(std::array<Compiler::Command, CAPACITY>& commands, size_t size,
+                       float targetTime);
+    bool setTargetTimeIfFeasible(float targetTime);
+
+    // Compiler::Feasibility's checks, with every target time finite
+    bool feasible() const;
+
+    size_t size() const { return m_size; }
+    float targetTime() const { return m_targetTime; }
+    Vec2 destination() const { return Compiler::getDestination(m_path, m_size); }
+
+    std::span<Compiler::Command const> commands() const { return { m_commands.data(), m_size }; }
+    std::span<Path const> path() const { return { m_path.data(), m_size }; }
+    std::span<float const> targetTimes() const { return { m_targetTimes.data(), m_size }; }
+    std::span<float const> turnTimes() const { return { m_turnTimes.data(), m_size }; }
+
+private:
+    static bool isValid(Compiler::Command const& command);
+    static bool isValid(float targetTime);
+
+    void compile();
+
+    std::array<Compiler::Command, CAPACITY> m_commands{};
+    std::array<Path, CAPACITY> m_path{};
+    std::array<float, CAPACITY> m_targetTimes{};
+    std::array<float, CAPACITY> m_turnTimes{};
+
+    size_t m_size{};
+    float m_targetTime{};
+};
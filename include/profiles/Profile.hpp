@@ -0,0 +1,37 @@
+#pragma once
+
+#include "state/Vector.hpp"
+
+#include <concepts>
+
+// what the control code reads from a robot profile. a profile is a type made of nested structs of
+// static constexpr values, so everything built on one folds to the constants it holds and two
+// robots can be instantiated in the same program
+template <typename Profile>
+concept RobotProfileType = requires {
+    { Profile::Chassis::AXLE_LENGTH } -> std::convertible_to<float>;
+    { Profile::Chassis::WHEEL_RADIUS } -> std::convertible_to<float>;
+    { Profile::Chassis::DOWEL_DISTANCE } -> std::convertible_to<float>;
+    { Profile::Chassis::MASS } -> std::convertible_to<float>;
+
+    { Profile::Battery::RESISTANCE } -> std::convertible_to<float>;
+
+    { Profile::Kinematics::Forward::VELOCITY_CUTOFF_FREQUENCY } -> std::convertible_to<float>;
+    { Profile::Kinematics::Forward::WHEEL_SPEED_CUTOFF_FREQUENCY } -> std::convertible_to<float>;
+    { Profile::Kinematics::Forward::ANGULAR_VELOCITY_CUTOFF_FREQUENCY } ->
+        std::convertible_to<float>;
+    { Profile::Kinematics::Slip::YAW_RATE_THRESHOLD } -> std::convertible_to<float>;
+    { Profile::Kinematics::Slip::TRACTION } -> std::convertible_to<float>;
+
+    { Profile::Manager::Follower::TURNING_RADIUS } -> std::convertible_to<float>;
+    { Profile::Manager::Straight::MAX_LINEAR_SPEED } -> std::convertible_to<float>;
+    { Profile::Manager::Rotation::MAX_SPEED } -> std::convertible_to<float>;
+
+    { Profile::Regulators::Current::KV } -> std::convertible_to<Vec2>;
+    { Profile::Regulators::Current::RESISTANCE } -> std::convertible_to<Vec2>;
+    { Profile::Regulators::Current::PEAK_CURRENT } -> std::convertible_to<float>;
+    { Profile::Regulators::Current::Thermal::TIME_CONSTANT } -> std::convertible_to<float>;
+    { Profile::Regulators::Velocity::Linear::kV } -> std::convertible_to<float>;
+    { Profile::Regulators::Velocity::Angular::kV } -> std::convertible_to<float>;
+    { Profile::Regulators::Velocity::Adaptation::MEMORY_TIME } -> std::convertible_to<float>;
+};
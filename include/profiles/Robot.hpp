@@ -0,0 +1,14 @@
+#pragma once
+
+#include "profiles/Profile.hpp"
+#include "profiles/RobotTourV2.hpp"
+
+// the robot this build is for, set with cmake -DROBOT_PROFILE=<profile> so every robot gets a
+// build directory of its own. the host tools have to be built for the same one to replay its runs
+#ifdef ROBOT_PROFILE
+using Robot = ROBOT_PROFILE;
+#else
+using Robot = RobotTourV2;
+#endif
+
+static_assert(RobotProfileType<Robot>, "ROBOT_PROFILE is not a robot profile");
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "state/Vector.hpp"
+
+// the robot this firmware was written for. another chassis gets a profile of its own, deriving
+// from this one and shadowing only the groups that differ
+struct RobotTourV2 {
+    struct Chassis {
+        static constexpr float AXLE_LENGTH = 13.35f;
+        static constexpr float WHEEL_RADIUS = 3.01625f;
+
+        static constexpr float DOWEL_DISTANCE = 2.314066f;
+
+        static constexpr float MASS = 0.786f;
+    };
+
+    // a 3s lipo and its leads, where the estimate starts before the first sample
+    struct Battery {
+        static constexpr float NOMINAL_VOLTAGE = 11.1f;
+        static constexpr float RESISTANCE = 0.3f;
+
+        // how far off the estimate expects to start, and the most it believes
+        static constexpr float VOLTAGE_SPREAD = 2.0f;
+        static constexpr float RESISTANCE_SPREAD = 1.0f;
+        static constexpr float MAX_VOLTAGE = 14.0f;
+        static constexpr float MAX_RESISTANCE = 2.0f;
+
+        static constexpr float MEMORY_TIME = 2.0f;
+    };
+
+    struct Kinematics {
+        struct Forward {
+            // bessel cutoffs at -3 db. the encoder differences are quantised to 12 rad/s at the
+            // fast loop rate, these match the lag of the rc filters they replaced with a sixth
+            // (velocity) and a sixteenth (wheel speed) of the noise
+            static constexpr float VELOCITY_CUTOFF_FREQUENCY = 15.0f;
+            static constexpr float WHEEL_SPEED_CUTOFF_FREQUENCY = 15.0f;
+            // the gyroscope normally provides it, so it keeps the rc filter
+            static constexpr float ANGULAR_VELOCITY_CUTOFF_FREQUENCY = 50.0f;
+        };
+
+        struct Slip {
+            // rad/s between the turn rate of the encoders and the gyroscope's
+            static constexpr float YAW_RATE_THRESHOLD = 0.1f;
+            static constexpr float YAW_RATE_CUTOFF_FREQUENCY = 20.0f;
+            // cm/s^2 at a wheel rim, past what the peak current can give the chassis
+            static constexpr float RIM_ACCEL_THRESHOLD = 650.0f;
+            static constexpr float RIM_ACCEL_CUTOFF_FREQUENCY = 20.0f;
+
+            // the share of the acceleration limits left right after a slip
+            static constexpr float TRACTION = 0.5f;
+            static constexpr float RECOVERY_TIME = 0.5f;
+        };
+    };
+
+    struct Manager {
+        struct Follower {
+            static constexpr float DISTANCE_THRESHOLD_ACCURATE = 0.0f;
+            static constexpr float DISTANCE_THRESHOLD_FAST = 0.0f;
+            static constexpr float TURNING_RADIUS = 20.0f;
+
+            static constexpr float ANGLE_THRESHOLD = 0.05f;
+        };
+
+        struct Straight {
+            static constexpr float SLOWDOWN_ACCEL = 40.0f;
+            static constexpr float SLOWDOWN_MIN_SPEED = 4.0f;
+
+            static constexpr float angularKp = 20.0f;
+            static constexpr float angularKd = 0.2f;
+
+            static constexpr float linearKp = 2.0f;
+            static constexpr float linearKd = 0.1f;
+            static constexpr float LINEAR_CONTROL_AUTHORITY = 0.3f;
+
+            static constexpr float FILTER_ALPHA = 1.0f;
+            static constexpr float CENTRIPETAL_FILTER_CUTOFF = 25.0f;
+
+            static constexpr float MAX_CENTRIPETAL = 60.0f;
+            static constexpr float TURN_ANGULAR_SPEED = 3.5f;
+            static constexpr float MAX_LINEAR_SPEED = 500.0f;
+        };
+
+        struct Rotation {
+            static constexpr float kS = 2.0f;
+            static constexpr float kP = 3.5f;
+
+            static constexpr float GRABBING_SPEED = 2.0f;
+
+            static constexpr float MAX_SPEED = 2.0f;
+            static constexpr float TURN_TIME_OFFSET = 1.0f;
+        };
+    };
+
+    struct Regulators {
+        struct Current {
+            // what a motor can carry indefinitely, and what it may take for a burst while its
+            // winding is cool
+            static constexpr float MAX_CURRENT = 0.40f;
+            static constexpr float PEAK_CURRENT = 0.60f;
+
+            static constexpr Vec2 RESISTANCE{ 3.30982f, 3.33778f };
+            static constexpr Vec2 FREE_ANGULAR_VEL{ 91.0553f, 90.0371f };
+            static constexpr Vec2 FREE_VOLTAGE{ 10.5f, 10.5f };
+            static constexpr Vec2 FREE_CURRENT{ 0.0576f, 0.0608f };
+
+            static constexpr Vec2 KV = FREE_ANGULAR_VEL /
+                                       (FREE_VOLTAGE - FREE_CURRENT * RESISTANCE);
+
+            // an n20 winding to the air around it in k/w, and how quickly it follows its losses
+            struct Thermal {
+                static constexpr float RESISTANCE = 60.0f;
+                static constexpr float TIME_CONSTANT = 20.0f;
+            };
+        };
+
+        struct Velocity {
+            static constexpr float ANGLE_CONTROL_MIN_VOLTAGE_BUDGET = 0.3f;
+            static constexpr float LINEAR_VELOCITY_VOLTAGE_BUDGET =
+                1.0f - ANGLE_CONTROL_MIN_VOLTAGE_BUDGET;
+            static constexpr float OFFSET = 0.85f;
+
+            // Integration::ADAPTIVE_FEEDFORWARD. the estimate forgets with this time constant, and
+            // the robot has to drive this long before it is used
+            struct Adaptation {
+                static constexpr float MEMORY_TIME = 5.0f;
+                static constexpr float SETTLE_TIME = 2.0f;
+            };
+
+            struct Linear {
+                static constexpr float kS = 0.4f;
+                static constexpr float kV = 0.037f;
+                static constexpr float kA = 0.001f;
+                static constexpr float kP = 0.08f;
+                static constexpr float kI = 0.08f;
+
+                static constexpr float MIN_INT = -1.0f;
+                static constexpr float MAX_INT = 1.0f;
+
+                static constexpr float FILTER_ALPHA = 1.0f;
+                static constexpr float LAG_FILTER_K = 0.05f;
+
+                // how far off the adaptation expects each gain to start, and the speed in cm/s
+                // it needs to tell the direction of travel
+                static constexpr float kS_SPREAD = 0.5f;
+                static constexpr float kV_SPREAD = 0.03f;
+                static constexpr float kA_SPREAD = 0.005f;
+                static constexpr float MIN_ADAPTATION_SPEED = 5.0f;
+            };
+
+            struct Angular {
+                static constexpr float kS = 0.0f;
+                static constexpr float kV = 0.7f;
+                static constexpr float kA = 0.0f;
+                static constexpr float kP = 1.0f;
+                static constexpr float kI = 0.0f;
+
+                static constexpr float MIN_INT = -10.0f;
+                static constexpr float MAX_INT = 10.0f;
+
+                static constexpr float FILTER_ALPHA = 1.0f;
+
+                static constexpr float LAG_FILTER_K = 0.05f;
+            };
+        };
+    };
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "profiling/Stages.hpp"
+
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#include <cstdint>
+
+// times stages in cycles off the calling core's systick, which every core has its own of. each
+// core needs its own timer, started on that core. with Integration::PROFILE_STAGES off the stages
+// are called straight through and nothing here is compiled in
+class StageTimer {
+public:
+    StageTimer(Stages::Profile& profile) : m_profile{ profile } {}
+
+    StageTimer(StageTimer const&) = delete;
+    StageTimer& operator=(StageTimer const&) = delete;
+    StageTimer(StageTimer&&) = delete;
+    StageTimer& operator=(StageTimer&&) = delete;
+
+    // free running from the processor clock, it wraps every 2^24 cycles which is far longer than
+    // any stage
+    void start() {
+        if constexpr (!Integration::PROFILE_STAGES) return;
+
+        m_profile.frequency = clock_get_hz(clk_sys);
+
+        systick_hw->csr = 0u;
+        systick_hw->rvr = M33_SYST_RVR_BITS;
+        systick_hw->cvr = 0u;
+        systick_hw->csr = M33_SYST_CSR_CLKSOURCE_BITS | M33_SYST_CSR_ENABLE_BITS;
+    }
+
+    template <typename Function>
+    decltype(auto) operator()(Stages::Id id, Function&& function) {
+        if constexpr (Integration::PROFILE_STAGES) {
+            Scope const scope{ m_profile.stats[id] };
+            return function();
+        } else return function();
+    }
+
+private:
+    // recorded on the way out, after the stage's result has been constructed
+    class Scope {
+    public:
+        Scope(Stages::Stats& stats) : m_stats{ stats }, m_start{ systick_hw->cvr } {}
+        ~Scope() { m_stats.record((m_start - systick_hw->cvr) & M33_SYST_CVR_BITS); }
+
+    private:
+        Stages::Stats& m_stats;
+        uint32_t const m_start;
+    };
+
+    Stages::Profile& m_profile;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// the steps of both control loops, each timed on its own so the slow loop's budget can be split
+// up before its rate is raised. a stage only ever runs on its own core, which is the only one that
+// records it
+namespace Stages {
+    enum Id : size_t {
+        STATE_LOAD,
+        PREDICTION,
+        FOLLOWER,
+        // the battery fit and, when adapting, the feedforward fit
+        ESTIMATION,
+        VELOCITY_REGULATOR,
+        CURRENT_REGULATOR,
+        MOTORS,
+        // the recorder and the telemetry queue
+        SLOW_RECORDING,
+        SENSORS,
+        FUSION,
+        KINEMATICS,
+        FAST_RECORDING,
+        PUBLISH,
+        COUNT,
+    };
+
+    struct Info {
+        std::string_view name{};
+        uint8_t core{};
+    };
+
+    inline constexpr std::array<Info, COUNT> TABLE{ {
+        { "state load", 0u },
+        { "prediction", 0u },
+        { "follower", 0u },
+        { "estimation", 0u },
+        { "velocity regulator", 0u },
+        { "current regulator", 0u },
+        { "motors", 0u },
+        { "slow recording", 0u },
+        { "sensors", 1u },
+        { "fusion", 1u },
+        { "kinematics", 1u },
+        { "fast recording", 1u },
+        { "publish", 1u },
+    } };
+
+    // cycles of the core's own clock, including any time spent in interrupts that preempted it
+    struct Stats {
+        uint32_t runs{};
+        uint32_t minCycles{};
+        uint32_t maxCycles{};
+        uint64_t totalCycles{};
+
+        void record(uint32_t cycles) {
+            minCycles = runs == 0u ? cycles : std::min(minCycles, cycles);
+            maxCycles = std::max(maxCycles, cycles);
+            totalCycles += cycles;
+            ++runs;
+        }
+
+        float meanCycles() const {
+            return runs == 0u ? 0.0f
+                              : static_cast<float>(totalCycles) / static_cast<float>(runs);
+        }
+    };
+
+    // filled in by a StageTimer on each core, frequency is the clock the cycles are counted in
+    struct Profile {
+        uint32_t frequency{};
+        std::array<Stats, COUNT> stats{};
+    };
+
+    // what the loops are measured with when nothing is timing them, as in the host tools
+    struct Unmeasured {
+        template <typename Function>
+        decltype(auto) operator()(Id, Function&& function) const {
+            return function();
+        }
+    };
+}
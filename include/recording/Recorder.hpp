@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "path/Route.hpp"
+
+#include "recording/Recording.hpp"
+
+#include "state/Vector.hpp"
+
+#include "storage/RouteRecord.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// core1 records fast samples and core0 slow samples into separate buffers so each has a single
+// writer. recording stops for good once either fills, so the samples always start at run start
+// where the replay knows the state of every filter
+class Recorder {
+public:
+    Recorder() = default;
+
+    Recorder(Recorder const&) = delete;
+    Recorder& operator=(Recorder const&) = delete;
+    Recorder(Recorder&&) = delete;
+    Recorder& operator=(Recorder&&) = delete;
+
+    // both halves of the starting state have to be in before the loops start
+    void begin(float fastLoopDt, Vec3 const& bias, Vec3 const& down,
+               std::array<uint16_t, 2> const& encoders) {
+        m_header.fastLoopDt = fastLoopDt;
+        m_header.bias = bias;
+        m_header.down = down;
+        m_header.encoders = encoders;
+    }
+
+    void setRoute(Route const& route) {
+        m_header.routeSize = static_cast<uint16_t>(RouteRecord::serialize(route, 0u, m_route));
+    }
+
+    void setParameters(Parameters::Record const& parameters) { m_header.parameters = parameters; }
+
+    void recordFast(Recording::FastSample const& sample) {
+        uint32_t const count = m_fastCount.load(std::memory_order_relaxed);
+        if (count == m_fast.size()) return;
+
+        m_fast[count] = sample;
+        m_fastCount.store(count + 1u, std::memory_order_release);
+    }
+
+    void recordSlow(Recording::SlowSample const& sample) {
+        uint32_t const count = m_slowCount.load(std::memory_order_relaxed);
+        if (m_full || sample.fastCount > m_fastCount.load(std::memory_order_acquire)) return;
+
+        m_slow[count] = sample;
+        m_slowCount.store(count + 1u, std::memory_order_release);
+        m_full = count + 1u == m_slow.size();
+    }
+
+    // fast samples past the last slow sample are dropped, the replay has nothing to compare them to
+    void finish() {
+        uint32_t const slowCount = m_slowCount.load(std::memory_order_acquire);
+
+        m_header.slowCount = slowCount;
+        m_header.fastCount = slowCount > 0u ? m_slow[slowCount - 1u].fastCount : 0u;
+        m_finished.store(true, std::memory_order_release);
+    }
+
+    // zero until finish so a half written recording is never read back
+    size_t size() const {
+        if (!m_finished.load(std::memory_order_acquire)) return 0u;
+
+        return sizeof(Recording::Header) + m_header.routeSize +
+               m_header.fastCount * sizeof(Recording::FastSample) +
+               m_header.slowCount * sizeof(Recording::SlowSample);
+    }
+
+    size_t read(size_t offset, std::span<uint8_t> output) const {
+        if (!m_finished.load(std::memory_order_acquire)) return 0u;
+
+        auto const header = std::bit_cast<std::array<uint8_t, sizeof(Recording::Header)>>(m_header);
+        std::array<std::span<uint8_t const>, 4> const sections{
+            std::span<uint8_t const>{ header },
+            std::span<uint8_t const>{ m_route.data(), m_header.routeSize },
+            bytes(std::span{ m_fast.data(), m_header.fastCount }),
+            bytes(std::span{ m_slow.data(), m_header.slowCount }),
+        };
+
+        size_t copied = 0u;
+        for (std::span<uint8_t const> section : sections) {
+            if (offset >= section.size()) {
+                offset -= section.size();
+                continue;
+            }
+
+            size_t const count = std::min(section.size() - offset, output.size() - copied);
+            std::copy_n(section.begin() + offset, count, output.begin() + copied);
+            copied += count;
+            offset = 0u;
+        }
+
+        return copied;
+    }
+
+private:
+    template <typename T>
+    static std::span<uint8_t const> bytes(std::span<T const> samples) {
+        return { reinterpret_cast<uint8_t const*>(samples.data()), samples.size_bytes() };
+    }
+
+    Recording::Header m_header{};
+    std::array<uint8_t, RouteRecord::MAX_SIZE> m_route{};
+
+    std::array<Recording::FastSample, Recording::FAST_SAMPLE_CAPACITY> m_fast{};
+    std::array<Recording::SlowSample, Recording::SLOW_SAMPLE_CAPACITY> m_slow{};
+
+    std::atomic<uint32_t> m_fastCount{ 0u };
+    std::atomic<uint32_t> m_slowCount{ 0u };
+    std::atomic<bool> m_finished{ false };
+    bool m_full{ false };
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "state/Vector.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// the raw inputs of both loops and the motor voltages they produced, enough for the host to push
+// a run back through the same loop code and compare. a recording is the header, the route as
+// RouteRecord serializes it, the fast samples, then the slow samples, all little endian
+namespace Recording {
+    inline constexpr uint32_t MAGIC = 0x43455252u;
+    inline constexpr uint16_t VERSION = 5u;
+
+    struct Header {
+        uint32_t magic{ MAGIC };
+        uint16_t version{ VERSION };
+        uint16_t routeSize{};
+
+        // the fast loop's dt, the measured gyroscope sample period when it runs off data ready
+        float fastLoopDt{};
+
+        // the gyroscope calibration and encoder angles the fast loop started from
+        Vec3 bias{};
+        Vec3 down{};
+        std::array<uint16_t, 2> encoders{};
+
+        uint32_t fastCount{};
+        uint32_t slowCount{};
+
+        // the parameters both loops were built with
+        Parameters::Record parameters{};
+    };
+
+    // one fast loop iteration, the 14 bit encoder angles and gyroscope words as the loop read them
+    struct FastSample {
+        std::array<uint16_t, 2> encoders{};
+        std::array<uint16_t, 3> gyroscope{};
+    };
+
+    // one slow loop iteration, fastCount is how many fast samples the state it read had seen
+    struct SlowSample {
+        uint32_t fastCount{};
+        float stateAge{};
+        float elapsed{};
+        float batteryVoltage{};
+        float batteryCurrent{};
+        Vec2 motorVoltages{};
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> &&
+                  sizeof(Header) == 52u + sizeof(float) * Parameters::COUNT);
+    static_assert(std::is_trivially_copyable_v<FastSample> && sizeof(FastSample) == 10u);
+    static_assert(std::is_trivially_copyable_v<SlowSample> && sizeof(SlowSample) == 28u);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "control/estimation/RecursiveLeastSquares.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+// the pack as an open circuit voltage behind an internal resistance, fitted from its terminal
+// voltage against the current the motors draw from it as voltage = openCircuitVoltage -
+// resistance current. the open circuit voltage falls as the pack discharges and the resistance
+// rises as it cools or ages, so both are forgotten over Battery::MEMORY_TIME
+template <RobotProfileType Profile>
+class BasicBatteryEstimator {
+public:
+    BasicBatteryEstimator(float dt)
+        : m_estimator{ { Battery::NOMINAL_VOLTAGE, Battery::RESISTANCE },
+                       { Battery::VOLTAGE_SPREAD * Battery::VOLTAGE_SPREAD,
+                         Battery::RESISTANCE_SPREAD * Battery::RESISTANCE_SPREAD },
+                       { 0.0f, 0.0f },
+                       { Battery::MAX_VOLTAGE, Battery::MAX_RESISTANCE },
+                       1.0f - dt / Battery::MEMORY_TIME } {}
+
+    // both sampled together, the current is what the pack gave the motors at their duty cycles
+    void update(float terminalVoltage, float current) {
+        m_estimator.update({ 1.0f, -current }, terminalVoltage);
+    }
+
+    float openCircuitVoltage() const { return m_estimator.estimate()[0]; }
+    float resistance() const { return m_estimator.estimate()[1]; }
+
+private:
+    using Battery = Profile::Battery;
+
+    RecursiveLeastSquares<2u> m_estimator;
+};
+
+using BatteryEstimator = BasicBatteryEstimator<Robot>;
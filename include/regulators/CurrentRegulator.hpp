@@ -10,19 +10,120 @@
 
 #include "drivers/Motors.hpp"
 
+#include "dsp/Kernels.hpp"
+
 #include "filters/LagFilter.hpp"
 #include "filters/RCFilter.hpp"
 
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "regulators/ThermalModel.hpp"
+
+#include "state/Vector.hpp"
+
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <optional>
 
-class CurrentRegulator {
+template <RobotProfileType Profile>
+class BasicCurrentRegulator {
 public:
-    CurrentRegulator() = default;
+    BasicCurrentRegulator(float dt) : m_thermalModel{ dt } {}
+
+    // the current limit is the tyre force limit, so it comes down with the traction while a wheel
+    // slips, under what the windings can take as warm as they are. the duty cycles are worked out
+    // against what the battery will sag to under the current they draw, a batteryResistance of 0
+    // divides by the open circuit voltage as is
+    Vec2 update(Vec2 const& wheelSpeeds, float openCircuitVoltage, float batteryResistance,
+                float traction) {
+        constexpr Vec2 KV = Profile::Regulators::Current::KV;
+        constexpr Vec2 RESISTANCE = Profile::Regulators::Current::RESISTANCE;
+
+        Vec2 const maxCurrents = currentLimits() * traction;
 
-    Vec2 update(Vec2 const& wheelSpeeds, float batteryVoltage);
+        Vec2 const voltageMins = wheelSpeeds / KV - maxCurrents * RESISTANCE;
+        Vec2 const voltageMaxes = wheelSpeeds / KV + maxCurrents * RESISTANCE;
+
+        Vec2 currentLimitedVoltages = scale(voltageMins, voltageMaxes, m_targetVoltages);
+
+        Vec2 const currents = (currentLimitedVoltages - wheelSpeeds / KV) / RESISTANCE;
+        if constexpr (Integration::THERMAL_CURRENT_LIMIT) m_thermalModel.update(currents);
+        float const power = Vec2::dot(currentLimitedVoltages, currents);
+        float const supplyVoltage = getSupplyVoltage(openCircuitVoltage, batteryResistance, power);
+
+        return currentLimitedVoltages / supplyVoltage *
+               static_cast<float>(Drivers::Motors::MAX_POWER);
+    }
 
     void setTargetVoltage(Vec2 const& targetVoltages) { m_targetVoltages = targetVoltages; }
 
+    // the windings as the limit sees them, from the currents it planned rather than measured ones
+    BasicThermalModel<Profile> const& thermalModel() const { return m_thermalModel; }
+
 private:
+    static constexpr size_t SCALE_VALUE_COUNT = 5;
+
+    Vec2 currentLimits() const {
+        if constexpr (Integration::THERMAL_CURRENT_LIMIT) return m_thermalModel.currentLimits();
+        else return { Profile::Regulators::Current::MAX_CURRENT,
+                      Profile::Regulators::Current::MAX_CURRENT };
+    }
+
+    // the pack gives the motors power / supplyVoltage through its resistance, so the supply is
+    // the larger root of v^2 - openCircuitVoltage v + resistance power. past the most the pack
+    // can give there is none and half the open circuit voltage is as far as it goes
+    static float getSupplyVoltage(float openCircuitVoltage, float resistance, float power) {
+        float const discriminant = openCircuitVoltage * openCircuitVoltage -
+                                   4.0f * resistance * power;
+        return (openCircuitVoltage + std::sqrtf(std::max(discriminant, 0.0f))) / 2.0f;
+    }
+
+    static std::array<std::optional<float>, SCALE_VALUE_COUNT>
+    getScaleValues(Vec2 const& mins, Vec2 const& maxes, Vec2 const& targets) {
+        return { Dsp::divide(maxes.x, targets.x), Dsp::divide(maxes.y, targets.y),
+                 Dsp::divide(mins.x, targets.x), Dsp::divide(mins.y, targets.y), 1.00f };
+    }
+
+    static auto getScaledVectors(
+        std::array<std::optional<float>, SCALE_VALUE_COUNT> const& scaleValues,
+        Vec2 const& targets) {
+        std::array<std::optional<Vec2>, SCALE_VALUE_COUNT> scaledVectors{};
+        for (size_t i = 0; i < scaledVectors.size(); ++i)
+            scaledVectors[i] = scaleValues[i].transform([&](float x) { return targets * x; });
+        return scaledVectors;
+    }
+
+    static Vec2 scale(Vec2 const& mins, Vec2 const& maxes, Vec2 const& targets) {
+        auto const scaleValues = getScaleValues(mins, maxes, targets);
+        auto const scaledVectors = getScaledVectors(scaleValues, targets);
+
+        std::optional<size_t> scaleIndex{};
+        for (size_t i = 0; i < scaleValues.size(); ++i) {
+            if (!scaledVectors[i]) continue;
+            Vec2 const& scaledVector = *scaledVectors[i];
+
+            if (scaledVector.x < mins.x || scaledVector.x > maxes.x || scaledVector.y < mins.y ||
+                scaledVector.y > maxes.y)
+                continue;
+
+            if (!scaleIndex ||
+                std::fabsf(*scaleValues[i] - 1.0f) < std::fabsf(*scaleValues[*scaleIndex] - 1.0f))
+                scaleIndex = i;
+        }
+
+        if (!scaleIndex)
+            return Vec2::transform(
+                [](float voltage, float min, float max) { return Dsp::clamp(voltage, min, max); },
+                targets, mins, maxes);
+        else return *scaledVectors[*scaleIndex];
+    }
+
+    BasicThermalModel<Profile> m_thermalModel;
+
     Vec2 m_targetVoltages{ 0.0f, 0.0f };
 };
+
+using CurrentRegulator = BasicCurrentRegulator<Robot>;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "control/estimation/RecursiveLeastSquares.hpp"
+#include "control/feedforward/Feedforward.hpp"
+
+#include "kinematics/ForwardKinematics.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "state/Vector.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <cmath>
+
+// refines kS, kV and kA of the linear velocity axis from the voltage that reached the motors
+// against the velocity that came of it, as voltage = kS sgn(v) + kV v + kA a. the floor, the
+// battery and the motors warming up all move them, and the integrator carries whatever the
+// feedforward misses. the estimate is only trusted once the robot has driven for
+// Adaptation::SETTLE_TIME, and store() hands it to the parameter table for the next run.
+// the angular axis keeps its configured gains: its turns on the spot are too short to fit, and
+// turning while driving the wheels share a direction so its kS cancels out
+template <RobotProfileType Profile>
+class BasicFeedforwardEstimator {
+public:
+    BasicFeedforwardEstimator(float dt)
+        : m_estimator{ estimator(dt) },
+          m_voltageFilter{ Parameters::value<Profile, Parameters::VELOCITY_CUTOFF_FREQUENCY>(),
+                           dt },
+          m_dt{ dt } {}
+
+    // motorVoltages are after the current limit, linearVelocity is the one the regulator
+    // measured. nothing is learned while a wheel slips, the chassis is not where the voltage went
+    void update(Vec2 const& motorVoltages, float linearVelocity, bool slipping) {
+        // undoes the regulator's offset on the right wheel, the angular part cancels in the sum
+        float const voltage = (motorVoltages.x + motorVoltages.y / Velocity::OFFSET) / 2.0f;
+
+        // the velocity came through this filter in the kinematics, so neither side lags the other
+        float const filteredVoltage = m_voltageFilter.update(voltage);
+        float const acceleration = (linearVelocity - m_prevVelocity) / m_dt;
+        m_prevVelocity = linearVelocity;
+
+        // below the minimum speed the direction, and with it kS, is not known
+        if (slipping || std::fabsf(linearVelocity) < Linear::MIN_ADAPTATION_SPEED) return;
+
+        m_estimator.update({ std::copysignf(1.0f, linearVelocity), linearVelocity, acceleration },
+                           filteredVoltage);
+        m_drivenTime += m_dt;
+    }
+
+    bool settled() const { return m_drivenTime >= Adaptation::SETTLE_TIME; }
+
+    // the gains it started from until it settled
+    Feedforward feedforward() const {
+        if (!settled()) return initial();
+
+        auto const& gains = m_estimator.estimate();
+        return { gains[0], gains[1], gains[2] };
+    }
+
+    // false if it did not settle or the table could not take the gains
+    bool store() const {
+        if (!settled()) return false;
+
+        Feedforward const gains = feedforward();
+        return Parameters::set(Parameters::LINEAR_VELOCITY_KS, gains.kS) &&
+               Parameters::set(Parameters::LINEAR_VELOCITY_KV, gains.kV) &&
+               Parameters::set(Parameters::LINEAR_VELOCITY_KA, gains.kA);
+    }
+
+private:
+    using Velocity = Profile::Regulators::Velocity;
+    using Linear = Velocity::Linear;
+    using Adaptation = Velocity::Adaptation;
+    using Estimator = RecursiveLeastSquares<3u>;
+    using VelocityFilter = BasicForwardKinematics<Profile>::VelocityFilter;
+
+    static Feedforward initial() {
+        return { Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KS>(),
+                 Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KV>(),
+                 Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KA>() };
+    }
+
+    // starts from the gains the regulator was built with, inside the bounds the table allows
+    static Estimator estimator(float dt) {
+        constexpr auto TABLE = Parameters::table<Profile>();
+        constexpr auto KS = Parameters::LINEAR_VELOCITY_KS;
+        constexpr auto KV = Parameters::LINEAR_VELOCITY_KV;
+        constexpr auto KA = Parameters::LINEAR_VELOCITY_KA;
+
+        Feedforward const gains = initial();
+        return { { gains.kS, gains.kV, gains.kA },
+                 { Linear::kS_SPREAD * Linear::kS_SPREAD, Linear::kV_SPREAD * Linear::kV_SPREAD,
+                   Linear::kA_SPREAD * Linear::kA_SPREAD },
+                 { TABLE[KS].min, TABLE[KV].min, TABLE[KA].min },
+                 { TABLE[KS].max, TABLE[KV].max, TABLE[KA].max },
+                 1.0f - dt / Adaptation::MEMORY_TIME };
+    }
+
+    Estimator m_estimator;
+    VelocityFilter m_voltageFilter;
+
+    float m_prevVelocity{};
+    float m_drivenTime{};
+
+    float const m_dt{};
+};
+
+using FeedforwardEstimator = BasicFeedforwardEstimator<Robot>;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "state/Vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// each winding as a single thermal mass heated by its copper losses and cooled through
+// Thermal::RESISTANCE to the air around it, in kelvin over that air. MAX_CURRENT is the current
+// that settles it at the budget, so a cool motor can take up to PEAK_CURRENT for a burst and the
+// limit closes in on MAX_CURRENT as the budget is used up
+template <RobotProfileType Profile>
+class BasicThermalModel {
+public:
+    BasicThermalModel(float dt) : m_step{ dt / Thermal::TIME_CONSTANT } {}
+
+    // the current each motor drew since the last update
+    void update(Vec2 const& currents) {
+        Vec2 const losses = currents * currents * Current::RESISTANCE;
+        m_temperatures += (losses * Thermal::RESISTANCE - m_temperatures) * m_step;
+    }
+
+    Vec2 temperatures() const { return m_temperatures; }
+
+    // the budget, where MAX_CURRENT settles each winding
+    static constexpr Vec2 maxTemperatures() {
+        return Current::MAX_CURRENT * Current::MAX_CURRENT * Current::RESISTANCE *
+               Thermal::RESISTANCE;
+    }
+
+    // the headroom left under the budget is shared out as the square of the current, which is
+    // what heats the winding
+    Vec2 currentLimits() const {
+        constexpr float CONTINUOUS = Current::MAX_CURRENT * Current::MAX_CURRENT;
+        constexpr float BURST = Current::PEAK_CURRENT * Current::PEAK_CURRENT - CONTINUOUS;
+
+        return Vec2::transform(
+            [](float temperature, float maxTemperature) {
+                float const headroom = std::max(1.0f - temperature / maxTemperature, 0.0f);
+                return std::sqrtf(CONTINUOUS + BURST * headroom);
+            },
+            m_temperatures, maxTemperatures());
+    }
+
+private:
+    using Current = Profile::Regulators::Current;
+    using Thermal = Current::Thermal;
+
+    Vec2 m_temperatures{ 0.0f, 0.0f };
+
+    float const m_step{};
+};
+
+using ThermalModel = BasicThermalModel<Robot>;
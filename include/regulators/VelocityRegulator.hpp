@@ -4,39 +4,129 @@
 
 #include "control/Controller.hpp"
 #include "control/feedforward/AController.hpp"
+#include "control/feedforward/Feedforward.hpp"
 #include "control/feedforward/SController.hpp"
 #include "control/feedforward/VController.hpp"
 #include "control/pid/DController.hpp"
 #include "control/pid/IController.hpp"
 #include "control/pid/PController.hpp"
 
+#include "dsp/Kernels.hpp"
+
 #include "filters/LagFilter.hpp"
 #include "filters/RCFilter.hpp"
 
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
 #include "state/Radians.hpp"
 #include "state/Vector.hpp"
 
-class VelocityRegulator {
+#include "tuning/Parameters.hpp"
+
+#include <cmath>
+
+template <RobotProfileType Profile>
+class BasicVelocityRegulator {
 public:
-    VelocityRegulator(float dt);
+    BasicVelocityRegulator(float dt)
+        : m_linearVelocityController{
+              { Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KS>() },
+              { Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KV>() },
+              { Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KA>(),
+                Linear::FILTER_ALPHA, dt },
+              { Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KP>() },
+              { Parameters::value<Profile, Parameters::LINEAR_VELOCITY_KI>(), Linear::MIN_INT,
+                Linear::MAX_INT, dt }
+          },
+          m_anglularVelocityController{
+              { Parameters::value<Profile, Parameters::ANGULAR_VELOCITY_KS>() },
+              { Parameters::value<Profile, Parameters::ANGULAR_VELOCITY_KV>() },
+              { Parameters::value<Profile, Parameters::ANGULAR_VELOCITY_KA>(),
+                Angular::FILTER_ALPHA, dt },
+              { Parameters::value<Profile, Parameters::ANGULAR_VELOCITY_KP>() },
+              { Parameters::value<Profile, Parameters::ANGULAR_VELOCITY_KI>(), Angular::MIN_INT,
+                Angular::MAX_INT, dt }
+          } {}
 
     void setTargets(float targetLinearVelocity, float targetAngularVelocity) {
         m_targetLinearVelocity = targetLinearVelocity;
         m_targetAngularVelocity = targetAngularVelocity;
     }
 
+    // replaces the linear feedforward from the next update on
+    void setLinearFeedforward(Feedforward const& gains) {
+        m_linearVelocityController.get<SController>().setGain(gains.kS);
+        m_linearVelocityController.get<VController>().setGain(gains.kV);
+        m_linearVelocityController.get<AController>().setGain(gains.kA);
+    }
+
+    // signed along the heading, as the last update acted on it
+    float linearVelocity() const { return m_linearVelocity; }
+
     Vec2 update(Vec2 const& currentVelocity, Radians currentAngle, float currentAngularVelocity,
-                float batteryVoltage);
+                float batteryVoltage) {
+        float const angleDifference = Radians{ currentVelocity.angle() + Constants::PI / 2.0f } -
+                                      currentAngle;
+        float const currentLinearVelocity = std::copysignf(currentVelocity.length(),
+                                                           angleDifference);
+        m_linearVelocity = currentLinearVelocity;
+
+        float const filteredTargetLinearVelocity =
+            m_linearVelocitySetpointFilter.update(m_targetLinearVelocity);
+        float const linearVelocityTargetVoltage = m_linearVelocityController.update(
+            filteredTargetLinearVelocity, currentLinearVelocity);
+
+        float const filteredTargetAngularVelocity =
+            m_angularVelocitySetpointFilter.update(m_targetAngularVelocity);
+        float const anglularVelocityControlTargetVoltage = m_anglularVelocityController.update(
+            filteredTargetAngularVelocity, currentAngularVelocity);
+
+        float const linearVelocityVoltageBudget = batteryVoltage *
+                                                  Velocity::LINEAR_VELOCITY_VOLTAGE_BUDGET;
+        float const linearVelocityVoltage = Dsp::saturate(linearVelocityTargetVoltage,
+                                                          linearVelocityVoltageBudget);
+
+        float const angularVelocityVoltageBudget = batteryVoltage - linearVelocityVoltage;
+        float const angularVelocityControlVoltage = Dsp::saturate(
+            anglularVelocityControlTargetVoltage, angularVelocityVoltageBudget);
+
+        float const leftVoltage = linearVelocityVoltage - angularVelocityControlVoltage;
+        float const rightVoltage = linearVelocityVoltage + angularVelocityControlVoltage;
+
+        float leftOffsetVoltage = leftVoltage;
+        float rightOffsetVoltage = rightVoltage * Velocity::OFFSET;
+
+        if (leftOffsetVoltage > batteryVoltage || leftOffsetVoltage < -batteryVoltage ||
+            rightOffsetVoltage > batteryVoltage || rightOffsetVoltage < -batteryVoltage) {
+            float const largerOffsetVoltage = Dsp::max(std::fabsf(leftOffsetVoltage),
+                                                       std::fabsf(rightOffsetVoltage));
+            float const scale = Dsp::divide(batteryVoltage, largerOffsetVoltage).value_or(0.0f);
+
+            leftOffsetVoltage *= scale;
+            rightOffsetVoltage *= scale;
+        }
+
+        return { leftOffsetVoltage, rightOffsetVoltage };
+    }
 
 private:
+    using Velocity = Profile::Regulators::Velocity;
+    using Linear = Velocity::Linear;
+    using Angular = Velocity::Angular;
+
     Controller<SController, VController, AController, PController, IController>
         m_linearVelocityController;
     Controller<SController, VController, AController, PController, IController>
         m_anglularVelocityController;
 
-    LagFilter m_linearVelocitySetpointFilter{ Regulators::Velocity::Linear::LAG_FILTER_K };
-    LagFilter m_angularVelocitySetpointFilter{ Regulators::Velocity::Angular::LAG_FILTER_K };
+    LagFilter m_linearVelocitySetpointFilter{ Linear::LAG_FILTER_K };
+    LagFilter m_angularVelocitySetpointFilter{ Angular::LAG_FILTER_K };
 
     float m_targetLinearVelocity{};
     float m_targetAngularVelocity{};
+
+    float m_linearVelocity{};
 };
+
+using VelocityRegulator = BasicVelocityRegulator<Robot>;
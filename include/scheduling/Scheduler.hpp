@@ -0,0 +1,106 @@
+#pragma once
+
+#include "scheduling/Task.hpp"
+
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+
+#include "pico/time.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using uint = unsigned int;
+
+// runs a task table on alarm interrupts. every task gets its own hardware alarm so its priority
+// is a real nvic priority, and each core starts its own rows since an alarm interrupts the core
+// that claimed it. tasks return false to stop. triggered tasks get no alarm, whatever releases
+// them calls trigger() so they keep the same statistics
+template <size_t N>
+class Scheduler {
+public:
+    Scheduler(std::array<TaskSpec, N> const& specs) {
+        for (size_t i = 0u; i < N; ++i) m_tasks[i].spec = specs[i];
+    }
+
+    Scheduler(Scheduler const&) = delete;
+    Scheduler& operator=(Scheduler const&) = delete;
+    Scheduler(Scheduler&&) = delete;
+    Scheduler& operator=(Scheduler&&) = delete;
+
+    template <typename Function>
+    void bind(size_t id, Function& function) {
+        m_tasks[id].function = [](void* context) { return (*static_cast<Function*>(context))(); };
+        m_tasks[id].context = &function;
+    }
+
+    // phases are relative to this call, so they only order tasks on the same core
+    void start(uint core) {
+        uint64_t const epoch = time_us_64();
+
+        for (Task& task : m_tasks) {
+            if (task.spec.core != core || !task.function || task.spec.triggered) continue;
+
+            alarm_pool_t* pool = alarm_pool_create_with_unused_hardware_alarm(1u);
+            irq_set_priority(hardware_alarm_get_irq_num(alarm_pool_hardware_alarm_num(pool)),
+                             task.spec.priority);
+
+            task.scheduled = epoch + task.spec.phaseUs;
+            alarm_pool_add_alarm_at(pool, from_us_since_boot(task.scheduled), run, &task, true);
+        }
+    }
+
+    // lateness is measured against one period after the previous run started
+    void trigger(size_t id) {
+        Task& task = m_tasks[id];
+        if (task.stopped) return;
+
+        uint64_t const start = time_us_64();
+        if (task.stats.runs == 0u) task.scheduled = start;
+
+        task.stopped = !task.function(task.context);
+        uint64_t const end = time_us_64();
+
+        task.stats.record(start > task.scheduled ? clamp(start - task.scheduled) : 0u,
+                          clamp(end - start), task.spec.periodUs);
+        task.scheduled = start + task.spec.periodUs;
+    }
+
+    TaskSpec const& spec(size_t id) const { return m_tasks[id].spec; }
+    TaskStats const& stats(size_t id) const { return m_tasks[id].stats; }
+
+private:
+    struct Task {
+        TaskSpec spec{};
+        bool (*function)(void*){ nullptr };
+        void* context{ nullptr };
+
+        uint64_t scheduled{};
+        bool stopped{ false };
+        TaskStats stats{};
+    };
+
+    // a negative return reschedules from the previous target rather than from now, so the rate
+    // does not drift with the run time
+    static int64_t run(alarm_id_t, void* userData) {
+        Task& task = *static_cast<Task*>(userData);
+
+        uint64_t const start = time_us_64();
+        bool const keepRunning = task.function(task.context);
+        uint64_t const end = time_us_64();
+
+        task.stats.record(clamp(start - task.scheduled), clamp(end - start), task.spec.periodUs);
+        task.scheduled += task.spec.periodUs;
+
+        return keepRunning ? -static_cast<int64_t>(task.spec.periodUs) : 0;
+    }
+
+    static uint32_t clamp(uint64_t us) {
+        return static_cast<uint32_t>(std::min<uint64_t>(us, std::numeric_limits<uint32_t>::max()));
+    }
+
+    std::array<Task, N> m_tasks{};
+};
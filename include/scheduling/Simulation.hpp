@@ -0,0 +1,126 @@
+#pragma once
+
+#include "scheduling/Task.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// steps a task table one microsecond at a time with the same rules the alarms follow on the
+// robot: fixed priority preemption per core, a release waits for the previous run of the same
+// task to finish, and releases stay on the period grid however late they start. durations are
+// the run time of each task, interrupts outside the table are not modelled
+namespace Simulation {
+    template <size_t N>
+    std::array<TaskStats, N> run(std::array<TaskSpec, N> const& specs,
+                                 std::array<uint32_t, N> const& durationsUs, uint64_t horizonUs) {
+        struct Job {
+            uint64_t scheduled{};
+            uint64_t started{};
+            uint32_t remaining{};
+            bool running{ false };
+        };
+
+        std::array<TaskStats, N> stats{};
+        std::array<Job, N> jobs{};
+        for (size_t i = 0u; i < N; ++i) jobs[i].scheduled = specs[i].phaseUs;
+
+        // a job only counts as started once it first gets the core
+        auto const released = [&](size_t i, uint64_t time) {
+            return jobs[i].running || time >= jobs[i].scheduled;
+        };
+
+        for (uint64_t time = 0u; time < horizonUs; ++time) {
+            std::array<std::optional<size_t>, 2> current{};
+
+            for (size_t i = 0u; i < N; ++i) {
+                if (!released(i, time)) continue;
+
+                auto& chosen = current[specs[i].core];
+                bool const preempts = !chosen || specs[i].priority < specs[*chosen].priority ||
+                                      (specs[i].priority == specs[*chosen].priority &&
+                                       jobs[i].running && !jobs[*chosen].running);
+                if (preempts) chosen = i;
+            }
+
+            for (std::optional<size_t> const& chosen : current) {
+                if (!chosen) continue;
+
+                Job& job = jobs[*chosen];
+                if (!job.running) {
+                    job.running = true;
+                    job.started = time;
+                    job.remaining = durationsUs[*chosen];
+                }
+
+                if (job.remaining > 0u) --job.remaining;
+                if (job.remaining > 0u) continue;
+
+                uint32_t const periodUs = specs[*chosen].periodUs;
+                stats[*chosen].record(static_cast<uint32_t>(job.started - job.scheduled),
+                                      static_cast<uint32_t>(time + 1u - job.started), periodUs);
+                job.scheduled += periodUs;
+                job.running = false;
+            }
+        }
+
+        return stats;
+    }
+
+    struct Sampling {
+        uint32_t ticks{};
+        uint32_t reused{};
+        uint32_t skipped{};
+        double maxAgeUs{};
+        double meanAgeUs{};
+        double headingError{};
+    };
+
+    // a loop ticking every tickPeriodUs from tickPhaseUs, integrating the latest of the samples a
+    // sensor takes every samplePeriodUs and delivers latencyUs later. the heading error is against
+    // the exact integral of angularVelocity over the ticks that had a sample
+    template <typename AngularVelocity>
+    Sampling sample(double samplePeriodUs, double tickPeriodUs, double tickPhaseUs,
+                    double latencyUs, double durationUs, AngularVelocity const& angularVelocity) {
+        constexpr double INTEGRATION_STEP_US = 0.01;
+
+        Sampling sampling{};
+        double heading = 0.0;
+        double exactHeading = 0.0;
+        std::optional<double> exactTime{};
+        std::optional<int64_t> previous{};
+
+        for (uint64_t tick = 0u;; ++tick) {
+            double const time = tickPhaseUs + static_cast<double>(tick) * tickPeriodUs;
+            if (time >= durationUs) break;
+
+            int64_t const latest = static_cast<int64_t>(
+                std::floor((time - latencyUs) / samplePeriodUs + 1.0e-9));
+            if (latest < 0) continue;
+
+            if (previous && latest == *previous) ++sampling.reused;
+            if (previous && latest > *previous + 1) sampling.skipped += latest - *previous - 1;
+            previous = latest;
+
+            double const sampleTime = static_cast<double>(latest) * samplePeriodUs;
+            double const age = time - sampleTime;
+            sampling.maxAgeUs = std::max(sampling.maxAgeUs, age);
+            sampling.meanAgeUs += age;
+            ++sampling.ticks;
+
+            heading += angularVelocity(sampleTime * 1.0e-6) * tickPeriodUs * 1.0e-6;
+
+            if (!exactTime) exactTime = time - tickPeriodUs;
+            for (; *exactTime < time; *exactTime += INTEGRATION_STEP_US)
+                exactHeading += angularVelocity(*exactTime * 1.0e-6) * INTEGRATION_STEP_US *
+                                1.0e-6;
+        }
+
+        if (sampling.ticks > 0u) sampling.meanAgeUs /= sampling.ticks;
+        sampling.headingError = heading - exactHeading;
+        return sampling;
+    }
+}
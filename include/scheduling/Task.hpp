@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+// one row of a task table. priority is the nvic priority of the task's alarm, lower preempts
+// higher, and tasks on different cores never contend. a triggered task is released by some other
+// periodic interrupt instead of an alarm, its period is what that interrupt is expected to keep
+struct TaskSpec {
+    std::string_view name{};
+    uint32_t periodUs{};
+    uint32_t phaseUs{};
+    uint8_t priority{};
+    uint8_t core{};
+    bool triggered{ false };
+};
+
+// lateness is from the scheduled release to the start, duration from the start to the end
+// including any time spent preempted, so the two add up to the response time
+struct TaskStats {
+    uint32_t runs{};
+    uint32_t overruns{};
+    uint32_t maxLatenessUs{};
+    uint32_t maxDurationUs{};
+    uint64_t totalDurationUs{};
+
+    // an overrun is a run that ended after the next release was due
+    void record(uint32_t latenessUs, uint32_t durationUs, uint32_t periodUs) {
+        ++runs;
+        if (latenessUs + durationUs > periodUs) ++overruns;
+
+        maxLatenessUs = std::max(maxLatenessUs, latenessUs);
+        maxDurationUs = std::max(maxDurationUs, durationUs);
+        totalDurationUs += durationUs;
+    }
+
+    float load(uint32_t periodUs) const {
+        return runs == 0u ? 0.0f
+                          : static_cast<float>(totalDurationUs) /
+                                (static_cast<float>(runs) * static_cast<float>(periodUs));
+    }
+};
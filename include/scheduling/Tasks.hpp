@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "scheduling/Task.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// every periodic task on the robot. a new rate is a new row here and a bind in main, and
+// rotour-schedule checks the table against measured run times before it is flashed
+namespace Tasks {
+    enum Id : size_t {
+        FAST_LOOP,
+        SLOW_LOOP,
+        COUNT,
+    };
+
+    inline constexpr std::array<TaskSpec, COUNT> TABLE{ {
+        { "fast-loop", static_cast<uint32_t>(Integration::FAST_LOOP_US), 0u, 0b11110000, 1u,
+          Integration::DATA_READY_FAST_LOOP },
+        { "slow-loop", static_cast<uint32_t>(Integration::SLOW_LOOP_US), 0u, 0b11110000, 0u },
+    } };
+}
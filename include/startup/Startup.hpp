@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// each phase is completed by exactly one core and waited on by anything that depends on it, so
+// independent setup on the two cores overlaps instead of running in lockstep
+class Startup {
+public:
+    enum class Phase : uint8_t {
+        CORE0_DRIVERS,
+        CORE1_DRIVERS,
+        BATTERY,
+        MOTORS,
+        GYROSCOPE_SETUP,
+        CALIBRATION_CLICK,
+        GYROSCOPE_CALIBRATION,
+        SAMPLE_PERIOD,
+        RUN_CLICK,
+        RUN_SETUP,
+    };
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::RUN_SETUP) + 1u;
+
+    static constexpr std::array<std::string_view, PHASE_COUNT> PHASE_NAMES{
+        "core0 drivers",   "core1 drivers",     "battery",               "motors",
+        "gyroscope setup", "calibration click", "gyroscope calibration", "sample period",
+        "run click",       "run setup",
+    };
+
+    // microseconds since boot, zero until the phase has begun or completed
+    struct Timing {
+        uint32_t start{};
+        uint32_t end{};
+    };
+
+    Startup() = default;
+
+    Startup(Startup const&) = delete;
+    Startup& operator=(Startup const&) = delete;
+    Startup(Startup&&) = delete;
+    Startup& operator=(Startup&&) = delete;
+
+    void begin(Phase phase);
+    void complete(Phase phase);
+
+    bool completed(Phase phase) const {
+        return (m_completed.load(std::memory_order_acquire) & bit(phase)) != 0u;
+    }
+
+    template <std::same_as<Phase>... Phases>
+    void waitFor(Phases... phases) const {
+        uint32_t const mask = (bit(phases) | ...);
+        while ((m_completed.load(std::memory_order_acquire) & mask) != mask) idle();
+    }
+
+    std::span<Timing const> timings() const { return m_timings; }
+
+private:
+    static constexpr uint32_t bit(Phase phase) { return 1u << static_cast<uint32_t>(phase); }
+
+    static void idle();
+
+    std::atomic<uint32_t> m_completed{ 0u };
+    std::array<Timing, PHASE_COUNT> m_timings{};
+};
@@ -5,76 +5,24 @@
 #include "Constants.hpp"
 
 #include <cmath>
-#include <limits>
+#include <cstdint>
 
 namespace RadianHelper {
-    constexpr float ipow(float x, int n) {
-        if (n == 0) return 1.0f;
-        else if (n == 1) return x;
-        else if (n > 1) return ((n & 1) ? x * ipow(x, n - 1) : ipow(x, n / 2) * ipow(x, n / 2));
-        else return 1.0f / ipow(x, -n);
-    }
-
-    constexpr float floorHelper2(float x, float guess, float inc) {
-        if (guess + inc <= x) return floorHelper2(x, guess + inc, inc);
-        else if (inc <= 1.0f) return guess;
-        else return floorHelper2(x, guess, inc / 2.0f);
-    }
-
-    constexpr float floorHelper1(float x, float guess, float inc) {
-        if (inc < 8.0f) return floorHelper2(x, guess, inc);
-        else if (guess + inc <= x) return floorHelper1(x, guess + inc, inc);
-        else if (guess + (inc / 8.0f) * 7.0f <= x)
-            return floorHelper1(x, guess + (inc / 8.0f) * 7.0f, inc / 8.0f);
-        else if (guess + (inc / 8.0f) * 6.0f <= x)
-            return floorHelper1(x, guess + (inc / 8.0f) * 6.0f, inc / 8.0f);
-        else if (guess + (inc / 8.0f) * 5.0f <= x)
-            return floorHelper1(x, guess + (inc / 8.0f) * 5.0f, inc / 8.0f);
-        else if (guess + (inc / 8.0f) * 4.0f <= x)
-            return floorHelper1(x, guess + (inc / 8.0f) * 4.0f, inc / 8.0f);
-        else if (guess + (inc / 8.0f) * 3.0f <= x)
-            return floorHelper1(x, guess + (inc / 8.0f) * 3.0f, inc / 8.0f);
-        else if (guess + (inc / 8.0f) * 2.0f <= x)
-            return floorHelper1(x, guess + (inc / 8.0f) * 2.0f, inc / 8.0f);
-        else if (guess + inc / 8.0f <= x) return floorHelper1(x, guess + inc / 8.0f, inc / 8.0f);
-        else return floorHelper1(x, guess, inc / 8.0f);
-    }
+    // from 2^23 up every float is a whole number, below it the cast truncates towards zero
+    inline constexpr float WHOLE_NUMBERS = 8388608.0f;
 
     constexpr float floor(float x) {
-        if (x < 0.0f) return -ceil(-x);
-        else return floorHelper1(x, 0.0f, ipow(2.0f, std::numeric_limits<float>::max_exponent - 1));
-    }
-
-    constexpr float ceilHelper2(float x, float guess, float dec) {
-        if (guess - dec >= x) return ceilHelper2(x, guess - dec, dec);
-        else if (dec <= 1.0f) return guess;
-        else return ceilHelper2(x, guess, dec / 2.0f);
-    }
+        if (!(x > -WHOLE_NUMBERS && x < WHOLE_NUMBERS)) return x;
 
-    constexpr float ceilHelper1(float x, float guess, float dec) {
-        if (dec < 8.0f) return ceilHelper2(x, guess, dec);
-        else if (guess - dec >= x) return ceilHelper1(x, guess - dec, dec);
-        else if (guess - (dec / 8.0f) * 7.0f >= x)
-            return ceilHelper1(x, guess - (dec / 8.0f) * 7.0f, dec / 8.0f);
-        else if (guess - (dec / 8.0f) * 6.0f >= x)
-            return ceilHelper1(x, guess - (dec / 8.0f) * 6.0f, dec / 8.0f);
-        else if (guess - (dec / 8.0f) * 5.0f >= x)
-            return ceilHelper1(x, guess - (dec / 8.0f) * 5.0f, dec / 8.0f);
-        else if (guess - (dec / 8.0f) * 4.0f >= x)
-            return ceilHelper1(x, guess - (dec / 8.0f) * 4.0f, dec / 8.0f);
-        else if (guess - (dec / 8.0f) * 3.0f >= x)
-            return ceilHelper1(x, guess - (dec / 8.0f) * 3.0f, dec / 8.0f);
-        else if (guess - (dec / 8.0f) * 2.0f >= x)
-            return ceilHelper1(x, guess - (dec / 8.0f) * 2.0f, dec / 8.0f);
-        else if (guess - dec / 8.0f >= x) return ceilHelper1(x, guess - dec / 8.0f, dec / 8.0f);
-        else return ceilHelper1(x, guess, dec / 8.0f);
+        float const truncated = static_cast<float>(static_cast<int32_t>(x));
+        return truncated > x ? truncated - 1.0f : truncated;
     }
 
     constexpr float ceil(float x) {
-        if (x < 0.0f) return -floor(-x);
-        else
-            return ceilHelper1(x, ipow(2.0f, std::numeric_limits<float>::max_exponent - 1),
-                               ipow(2.0f, std::numeric_limits<float>::max_exponent - 1));
+        if (!(x > -WHOLE_NUMBERS && x < WHOLE_NUMBERS)) return x;
+
+        float const truncated = static_cast<float>(static_cast<int32_t>(x));
+        return truncated < x ? truncated + 1.0f : truncated;
     }
 
     constexpr float round(float x) { return x >= 0.0f ? floor(x + 0.5f) : ceil(x - 0.5f); }
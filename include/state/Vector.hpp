@@ -3,60 +3,63 @@
 
 #pragma once
 
+#include <bit>
 #include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <limits>
 #include <numbers>
 #include <utility>
 
 namespace VectorHelper {
-    constexpr float sqrtNewtonRaphson(float x, float current, float previous) {
-        if (current == previous) return current;
-        else return sqrtNewtonRaphson(x, 0.5f * (current + (x / current)), current);
-    }
-
-    constexpr float constexprSqrt(float x) {
-        if (x >= 0.0f && x < std::numeric_limits<float>::infinity())
-            return sqrtNewtonRaphson(x, x, 0.0f);
-    }
+    inline constexpr float PI = std::numbers::pi_v<float>;
 
-    namespace Atan {
-        constexpr float abs(float x) { return x > 0.0f ? x : -x; }
+    // both run a fixed number of steps in double and round once, so a route of any length stays
+    // inside the constexpr limits and matches sqrtf and atan2f at run time
+    inline constexpr int SQRT_STEPS = 6;
+    inline constexpr int ATAN_TERMS = 64;
 
-        constexpr float term(float x, int k) {
-            return (2.0f * static_cast<float>(k) * x) /
-                   ((2.0f * static_cast<float>(k) + 1.0f) * (1.0f + x));
+    constexpr float constexprSqrt(float x) {
+        if (x >= 0.0f && x < std::numeric_limits<float>::infinity()) {
+            if (x == 0.0f) return x;
+
+            // halving the exponent lands within 6 percent, newton doubles the digits each step
+            double const value = x;
+            double root = std::bit_cast<double>((std::bit_cast<uint64_t>(value) >> 1) +
+                                                (uint64_t{ 1023u } << 51));
+            for (int i = 0; i < SQRT_STEPS; ++i) root = 0.5 * (root + value / root);
+            return static_cast<float>(root);
         }
+    }
 
-        constexpr float product(float x, int k) {
-            return k == 1 ? term(x * x, k) : term(x * x, k) * product(x, k - 1);
-        }
+    // euler's series, every term at most half the last for |x| <= 1
+    constexpr double constexprAtan(double x) {
+        double const ratio = x * x / (1.0 + x * x);
 
-        constexpr float sum(float x, float currentSum, int n) {
-            return currentSum + product(x, n) == currentSum
-                       ? currentSum
-                       : sum(x, currentSum + product(x, n), n + 1);
+        double term = 1.0;
+        double sum = 1.0;
+        for (int k = 1; k <= ATAN_TERMS && sum + term != sum; ++k) {
+            term *= 2.0 * k * ratio / (2.0 * k + 1.0);
+            sum += term;
         }
+        return x / (1.0 + x * x) * sum;
     }
 
-    constexpr float constexprAtan(float x) { return x / (1.0f + x * x) * Atan::sum(x, 1.0f, 1); }
-
     constexpr float constexprAtan2(float y, float x) {
-        static constexpr float PI = std::numbers::pi_v<float>;
+        constexpr double HALF_PI = std::numbers::pi / 2.0;
 
         if (x == 0.0f && y > 0.0f) return PI / 2.0f;
         if (x == 0.0f && y < 0.0f) return -PI / 2.0f;
         if (x == 0.0f && y == 0.0f) return 0.0f;
 
-        bool const swap = Atan::abs(x) < Atan::abs(y);
-        float const atanInput = (swap ? x : y) / (swap ? y : x);
+        bool const swap = (x < 0.0f ? -x : x) < (y < 0.0f ? -y : y);
+        double const atanInput = static_cast<double>(swap ? x : y) / (swap ? y : x);
 
-        float result = constexprAtan(atanInput);
-        if (swap) result = (atanInput >= 0.0f ? PI / 2.0f : -PI / 2.0f) - result;
+        double result = constexprAtan(atanInput);
+        if (swap) result = (atanInput >= 0.0 ? HALF_PI : -HALF_PI) - result;
 
-        if (x >= 0.0f) return result;
-        if (x < 0.0f && y >= 0.0f) return result + PI;
-        if (x < 0.0f && y < 0.0f) return result - PI;
+        if (x < 0.0f) result += y >= 0.0f ? std::numbers::pi : -std::numbers::pi;
+        return static_cast<float>(result);
     }
 }
 
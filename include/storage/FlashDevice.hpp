@@ -0,0 +1,16 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+// offsets are relative to the start of the device, programs are whole pages and erases whole
+// sectors, as on the real flash
+template <typename T>
+concept FlashDeviceType = requires(T device, uint32_t offset, std::span<uint8_t> output,
+                                   std::span<uint8_t const> input) {
+    { device.size() } -> std::convertible_to<uint32_t>;
+    { device.read(offset, output) } -> std::same_as<bool>;
+    { device.program(offset, input) } -> std::same_as<bool>;
+    { device.erase(offset) } -> std::same_as<bool>;
+};
@@ -0,0 +1,474 @@
+// https://en.wikipedia.org/wiki/Log-structured_file_system
+// https://en.wikipedia.org/wiki/Wear_leveling
+
+#pragma once
+
+#include "Constants.hpp"
+
+#include "storage/FlashDevice.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+enum class RecordType : uint8_t {
+    CALIBRATION = 0x01,
+    ROUTE = 0x02,
+    TUNING = 0x03,
+    RUN_LOG = 0x04,
+};
+
+// records are appended to the open sector and the newest copy of each (type, slot) key wins.
+// page 0 of every sector holds its erase count, records start on page boundaries after it.
+//
+// append() only ever programs pages, at most one sector header plus the pages of the record, and
+// never erases. erasing is left to collectGarbage(), which does at most one sector per call so the
+// caller decides when the stall is acceptable
+template <FlashDeviceType Device>
+class LogStore {
+public:
+    static constexpr uint32_t PAGE_SIZE = Storage::PAGE_SIZE;
+    static constexpr uint32_t PAGES_PER_SECTOR = Storage::SECTOR_SIZE / Storage::PAGE_SIZE;
+
+    struct RecordHeader {
+        uint32_t magic{};
+        uint16_t key{};
+        uint16_t length{};
+        uint32_t sequence{};
+        uint32_t crc{};
+    };
+    static_assert(sizeof(RecordHeader) == 16u);
+
+    static constexpr size_t MAX_RECORD_SIZE = (PAGES_PER_SECTOR - 1u) * PAGE_SIZE -
+                                              sizeof(RecordHeader);
+
+    LogStore(Device& device) : m_device{ device } { mount(); }
+
+    LogStore(LogStore const&) = delete;
+    LogStore& operator=(LogStore const&) = delete;
+    LogStore(LogStore&&) = delete;
+    LogStore& operator=(LogStore&&) = delete;
+
+    bool append(RecordType type, uint8_t slot, std::span<uint8_t const> data) {
+        if (data.size() > MAX_RECORD_SIZE) return false;
+
+        uint16_t const key = makeKey(type, slot);
+        if (!findEntry(key) && !freeEntry()) return false;
+
+        RecordHeader header{ RECORD_MAGIC, key, static_cast<uint16_t>(data.size()), m_nextSequence,
+                             0u };
+        header.crc = crc32(data, crc32(headerBytes(header)));
+
+        auto const readData = [&](size_t offset, std::span<uint8_t> output) {
+            std::copy_n(data.begin() + offset, output.size(), output.begin());
+            return true;
+        };
+        return writeRecord(header, readData, false);
+    }
+
+    std::optional<size_t> read(RecordType type, uint8_t slot, std::span<uint8_t> output) const {
+        Entry const* const entry = findEntry(makeKey(type, slot));
+        if (!entry || output.size() < entry->length) return std::nullopt;
+
+        if (!m_device.read(entry->offset + sizeof(RecordHeader), output.first(entry->length)))
+            return std::nullopt;
+        return entry->length;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool store(RecordType type, uint8_t slot, T const& value) {
+        auto const bytes = std::bit_cast<std::array<uint8_t, sizeof(T)>>(value);
+        return append(type, slot, bytes);
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    std::optional<T> load(RecordType type, uint8_t slot) const {
+        std::array<uint8_t, sizeof(T)> bytes{};
+        if (read(type, slot, bytes) != sizeof(T)) return std::nullopt;
+
+        return std::bit_cast<T>(bytes);
+    }
+
+    bool needsGarbageCollection() const { return chooseVictim().has_value(); }
+
+    // relocates the live records out of one sector and erases it
+    bool collectGarbage() {
+        auto const victim = chooseVictim();
+        if (!victim) return false;
+
+        if (m_sectors[*victim].state != SectorState::DIRTY) {
+            for (Entry const& entry : m_entries) {
+                if (!entry.used || entry.offset / Storage::SECTOR_SIZE != *victim) continue;
+                if (!relocate(entry)) return false;
+            }
+        }
+
+        return eraseSector(*victim);
+    }
+
+    size_t freeSectorCount() const {
+        return static_cast<size_t>(std::count_if(m_sectors.begin(), m_sectors.end(), isFree));
+    }
+
+private:
+    static constexpr uint32_t SECTOR_MAGIC = 0x4c4f4753;
+    static constexpr uint32_t RECORD_MAGIC = 0x52454344;
+
+    enum class SectorState : uint8_t {
+        // erased with no header, the erase count is only an estimate
+        BLANK,
+        // header written but no records
+        FREE,
+        USED,
+        // unreadable header or an interrupted erase, must be erased before use
+        DIRTY,
+    };
+
+    struct SectorHeader {
+        uint32_t magic{};
+        uint32_t eraseCount{};
+        uint32_t crc{};
+    };
+
+    struct Sector {
+        SectorState state{ SectorState::DIRTY };
+        uint32_t eraseCount{};
+        uint32_t usedPages{};
+        uint32_t livePages{};
+    };
+
+    struct Entry {
+        bool used{};
+        uint16_t key{};
+        uint16_t length{};
+        uint32_t sequence{};
+        uint32_t offset{};
+    };
+
+    static constexpr uint16_t makeKey(RecordType type, uint8_t slot) {
+        return static_cast<uint16_t>(static_cast<uint16_t>(type) << 8u | slot);
+    }
+
+    static constexpr uint32_t pagesFor(size_t length) {
+        return static_cast<uint32_t>((sizeof(RecordHeader) + length + PAGE_SIZE - 1u) /
+                                     PAGE_SIZE);
+    }
+
+    static constexpr bool isFree(Sector const& sector) {
+        return sector.state == SectorState::BLANK || sector.state == SectorState::FREE;
+    }
+
+    static constexpr uint32_t crc32(std::span<uint8_t const> data, uint32_t crc = 0xffffffff) {
+        for (uint8_t const byte : data) {
+            crc ^= byte;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1u) ? (crc >> 1u) ^ 0xedb88320 : crc >> 1u;
+        }
+        return crc;
+    }
+
+    static std::array<uint8_t, 8u> headerBytes(RecordHeader const& header) {
+        // everything except the magic and the crc itself
+        auto const bytes = std::bit_cast<std::array<uint8_t, sizeof(RecordHeader)>>(header);
+        std::array<uint8_t, 8u> covered{};
+        std::copy_n(bytes.begin() + 4u, covered.size(), covered.begin());
+        return covered;
+    }
+
+    static std::array<uint8_t, 8u> headerBytes(SectorHeader const& header) {
+        auto const bytes = std::bit_cast<std::array<uint8_t, sizeof(SectorHeader)>>(header);
+        std::array<uint8_t, 8u> covered{};
+        std::copy_n(bytes.begin(), covered.size(), covered.begin());
+        return covered;
+    }
+
+    static bool isBlank(std::span<uint8_t const> data) {
+        return std::all_of(data.begin(), data.end(), [](uint8_t byte) { return byte == 0xff; });
+    }
+
+    void mount() {
+        std::optional<uint32_t> minEraseCount{};
+        uint32_t maxEraseCount = 0u;
+
+        for (uint32_t index = 0u; index < Storage::SECTOR_COUNT; ++index) {
+            Sector& sector = m_sectors[index];
+            sector = {};
+
+            if (!m_device.read(index * Storage::SECTOR_SIZE, m_page)) continue;
+
+            auto const header = headerFromPage<SectorHeader>();
+            if (header.magic == SECTOR_MAGIC && header.crc == crc32(headerBytes(header))) {
+                sector.eraseCount = header.eraseCount;
+                minEraseCount = std::min(minEraseCount.value_or(header.eraseCount),
+                                         header.eraseCount);
+                maxEraseCount = std::max(maxEraseCount, header.eraseCount);
+                scanSector(index);
+            } else if (isBlank(m_page) && isSectorBlank(index)) {
+                sector.state = SectorState::BLANK;
+            }
+        }
+
+        // sectors without a header have lost their count. blank ones are most likely unused so they
+        // are handed out first, damaged ones are assumed to be as worn as the worst
+        for (Sector& sector : m_sectors) {
+            if (sector.state == SectorState::BLANK) sector.eraseCount = minEraseCount.value_or(0u);
+            if (sector.state == SectorState::DIRTY) sector.eraseCount = maxEraseCount;
+        }
+
+        // keep appending to the sector holding the newest record
+        uint32_t newest = 0u;
+        for (Entry const& entry : m_entries) {
+            if (!entry.used || entry.sequence < newest) continue;
+            newest = entry.sequence;
+            m_head = entry.offset / Storage::SECTOR_SIZE;
+        }
+    }
+
+    bool isSectorBlank(uint32_t index) {
+        for (uint32_t page = 1u; page < PAGES_PER_SECTOR; ++page) {
+            if (!m_device.read(index * Storage::SECTOR_SIZE + page * PAGE_SIZE, m_page))
+                return false;
+            if (!isBlank(m_page)) return false;
+        }
+        return true;
+    }
+
+    void scanSector(uint32_t index) {
+        Sector& sector = m_sectors[index];
+
+        uint32_t page = 1u;
+        while (page < PAGES_PER_SECTOR) {
+            uint32_t const offset = index * Storage::SECTOR_SIZE + page * PAGE_SIZE;
+            if (!m_device.read(offset, m_page)) break;
+            if (isBlank(m_page)) break;
+
+            auto const header = headerFromPage<RecordHeader>();
+            uint32_t const pages = pagesFor(header.length);
+            if (header.magic != RECORD_MAGIC || header.length > MAX_RECORD_SIZE ||
+                page + pages > PAGES_PER_SECTOR) {
+                // a torn header hides where the next record starts, so nothing more goes here
+                page = PAGES_PER_SECTOR;
+                break;
+            }
+
+            // a record torn partway through keeps its pages but fails the crc
+            if (checksum(offset, header) == header.crc) {
+                m_nextSequence = std::max(m_nextSequence, header.sequence + 1u);
+                indexRecord(header, offset);
+            }
+
+            page += pages;
+        }
+
+        sector.usedPages = page;
+        sector.state = page == 1u ? SectorState::FREE : SectorState::USED;
+    }
+
+    template <typename T>
+    T headerFromPage() const {
+        std::array<uint8_t, sizeof(T)> bytes{};
+        std::copy_n(m_page.begin(), bytes.size(), bytes.begin());
+        return std::bit_cast<T>(bytes);
+    }
+
+    std::optional<uint32_t> checksum(uint32_t offset, RecordHeader const& header) {
+        uint32_t crc = crc32(headerBytes(header));
+
+        std::array<uint8_t, PAGE_SIZE> chunk{};
+        size_t done = 0u;
+        while (done < header.length) {
+            size_t const size = std::min<size_t>(chunk.size(), header.length - done);
+            if (!m_device.read(offset + sizeof(RecordHeader) + done, { chunk.data(), size }))
+                return std::nullopt;
+
+            crc = crc32({ chunk.data(), size }, crc);
+            done += size;
+        }
+        return crc;
+    }
+
+    void indexRecord(RecordHeader const& header, uint32_t offset) {
+        Entry* entry = findEntry(header.key);
+        if (entry && entry->sequence > header.sequence) return;
+        if (!entry) entry = freeEntry();
+        if (!entry) return;
+
+        if (entry->used)
+            m_sectors[entry->offset / Storage::SECTOR_SIZE].livePages -= pagesFor(entry->length);
+        m_sectors[offset / Storage::SECTOR_SIZE].livePages += pagesFor(header.length);
+
+        *entry = { true, header.key, header.length, header.sequence, offset };
+    }
+
+    Entry* findEntry(uint16_t key) {
+        for (Entry& entry : m_entries)
+            if (entry.used && entry.key == key) return &entry;
+        return nullptr;
+    }
+
+    Entry const* findEntry(uint16_t key) const {
+        for (Entry const& entry : m_entries)
+            if (entry.used && entry.key == key) return &entry;
+        return nullptr;
+    }
+
+    Entry* freeEntry() {
+        for (Entry& entry : m_entries)
+            if (!entry.used) return &entry;
+        return nullptr;
+    }
+
+    // finds room for a record, opening a new sector if the head is full. only garbage collection
+    // may take the reserved sectors since it needs them to make progress
+    std::optional<uint32_t> allocate(uint32_t pages, bool useReserve) {
+        if (m_head && m_sectors[*m_head].state == SectorState::USED &&
+            m_sectors[*m_head].usedPages + pages <= PAGES_PER_SECTOR)
+            return *m_head;
+
+        if (!useReserve && freeSectorCount() <= Storage::RESERVE_SECTORS) return std::nullopt;
+
+        std::optional<uint32_t> chosen{};
+        for (uint32_t index = 0u; index < Storage::SECTOR_COUNT; ++index) {
+            if (!isFree(m_sectors[index])) continue;
+            if (!chosen || m_sectors[index].eraseCount < m_sectors[*chosen].eraseCount)
+                chosen = index;
+        }
+        if (!chosen) return std::nullopt;
+
+        Sector& sector = m_sectors[*chosen];
+        if (sector.state == SectorState::BLANK && !writeSectorHeader(*chosen)) return std::nullopt;
+
+        sector.state = SectorState::USED;
+        sector.usedPages = 1u;
+        m_head = *chosen;
+        return *chosen;
+    }
+
+    bool writeRecord(RecordHeader header, auto const& readData, bool useReserve) {
+        uint32_t const pages = pagesFor(header.length);
+        auto const sectorIndex = allocate(pages, useReserve);
+        if (!sectorIndex) return false;
+
+        Sector& sector = m_sectors[*sectorIndex];
+        uint32_t const offset = *sectorIndex * Storage::SECTOR_SIZE + sector.usedPages * PAGE_SIZE;
+
+        // claim the pages first so a failed program is never written over
+        sector.usedPages += pages;
+        ++m_nextSequence;
+
+        auto const headerData = std::bit_cast<std::array<uint8_t, sizeof(RecordHeader)>>(header);
+        size_t done = 0u;
+        for (uint32_t page = 0u; page < pages; ++page) {
+            m_page.fill(0xff);
+
+            size_t start = 0u;
+            if (page == 0u) {
+                std::copy(headerData.begin(), headerData.end(), m_page.begin());
+                start = headerData.size();
+            }
+
+            size_t const size = std::min<size_t>(PAGE_SIZE - start, header.length - done);
+            if (!readData(done, std::span<uint8_t>{ m_page.data() + start, size })) return false;
+            done += size;
+
+            if (!m_device.program(offset + page * PAGE_SIZE, m_page)) return false;
+        }
+
+        indexRecord(header, offset);
+        return true;
+    }
+
+    bool relocate(Entry const& entry) {
+        RecordHeader header{ RECORD_MAGIC, entry.key, entry.length, m_nextSequence, 0u };
+        uint32_t const source = entry.offset + sizeof(RecordHeader);
+
+        auto const crc = checksum(entry.offset, header);
+        if (!crc) return false;
+        header.crc = *crc;
+
+        auto const readData = [&](size_t offset, std::span<uint8_t> output) {
+            return m_device.read(source + static_cast<uint32_t>(offset), output);
+        };
+        return writeRecord(header, readData, true);
+    }
+
+    bool writeSectorHeader(uint32_t index) {
+        Sector& sector = m_sectors[index];
+
+        SectorHeader header{ SECTOR_MAGIC, sector.eraseCount, 0u };
+        header.crc = crc32(headerBytes(header));
+
+        auto const bytes = std::bit_cast<std::array<uint8_t, sizeof(SectorHeader)>>(header);
+        m_page.fill(0xff);
+        std::copy(bytes.begin(), bytes.end(), m_page.begin());
+
+        if (!m_device.program(index * Storage::SECTOR_SIZE, m_page)) {
+            sector.state = SectorState::DIRTY;
+            return false;
+        }
+
+        sector.state = SectorState::FREE;
+        sector.usedPages = 1u;
+        sector.livePages = 0u;
+        return true;
+    }
+
+    bool eraseSector(uint32_t index) {
+        Sector& sector = m_sectors[index];
+        if (m_head == index) m_head.reset();
+
+        sector.state = SectorState::DIRTY;
+        if (!m_device.erase(index * Storage::SECTOR_SIZE)) return false;
+
+        ++sector.eraseCount;
+        sector.state = SectorState::BLANK;
+        sector.usedPages = 0u;
+        sector.livePages = 0u;
+        return writeSectorHeader(index);
+    }
+
+    std::optional<uint32_t> chooseVictim() const {
+        uint32_t maxEraseCount = 0u;
+        for (Sector const& sector : m_sectors)
+            maxEraseCount = std::max(maxEraseCount, sector.eraseCount);
+
+        std::optional<uint32_t> emptiest{};
+        std::optional<uint32_t> leastWorn{};
+        for (uint32_t index = 0u; index < Storage::SECTOR_COUNT; ++index) {
+            Sector const& sector = m_sectors[index];
+            if (sector.state == SectorState::DIRTY) return index;
+            if (sector.state != SectorState::USED || m_head == index) continue;
+
+            // nothing to copy, reclaiming it costs only the erase
+            if (sector.livePages == 0u) return index;
+
+            if (sector.livePages + 1u < sector.usedPages &&
+                (!emptiest || sector.livePages < m_sectors[*emptiest].livePages))
+                emptiest = index;
+
+            if (sector.eraseCount + Storage::WEAR_LEVELLING_THRESHOLD < maxEraseCount &&
+                (!leastWorn || sector.eraseCount < m_sectors[*leastWorn].eraseCount))
+                leastWorn = index;
+        }
+
+        if (freeSectorCount() <= Storage::RESERVE_SECTORS && emptiest) return emptiest;
+        // records that never change would otherwise pin their sector at a low erase count
+        return leastWorn;
+    }
+
+    Device& m_device;
+
+    std::array<Sector, Storage::SECTOR_COUNT> m_sectors{};
+    std::array<Entry, Storage::MAX_KEYS> m_entries{};
+    std::array<uint8_t, PAGE_SIZE> m_page{};
+
+    std::optional<uint32_t> m_head{};
+    uint32_t m_nextSequence{ 0u };
+};
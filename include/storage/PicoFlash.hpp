@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include <cstdint>
+#include <span>
+
+// the store region at the end of the onboard flash, programmed through flash_safe_execute so the
+// other core is parked while xip is unavailable
+class PicoFlash {
+public:
+    PicoFlash();
+
+    PicoFlash(PicoFlash const&) = delete;
+    PicoFlash& operator=(PicoFlash const&) = delete;
+    PicoFlash(PicoFlash&&) = delete;
+    PicoFlash& operator=(PicoFlash&&) = delete;
+
+    uint32_t size() const { return Storage::REGION_SIZE; }
+
+    bool read(uint32_t offset, std::span<uint8_t> output);
+    bool program(uint32_t offset, std::span<uint8_t const> input);
+    bool erase(uint32_t offset);
+
+private:
+    uint32_t m_regionOffset{};
+};
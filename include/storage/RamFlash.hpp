@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// host side stand in for PicoFlash with nor semantics: erase sets bytes to 0xff and programming
+// can only clear bits. failAfter() cuts the power partway through a later operation so recovery
+// can be exercised
+class RamFlash {
+public:
+    RamFlash(uint32_t size = Storage::REGION_SIZE)
+        : m_memory(size, 0xff), m_eraseCounts(size / Storage::SECTOR_SIZE, 0u) {}
+
+    RamFlash(RamFlash const&) = delete;
+    RamFlash& operator=(RamFlash const&) = delete;
+    RamFlash(RamFlash&&) = delete;
+    RamFlash& operator=(RamFlash&&) = delete;
+
+    uint32_t size() const { return static_cast<uint32_t>(m_memory.size()); }
+
+    bool read(uint32_t offset, std::span<uint8_t> output) {
+        if (!m_powered || offset + output.size() > size()) return false;
+
+        std::copy_n(m_memory.begin() + offset, output.size(), output.begin());
+        return true;
+    }
+
+    bool program(uint32_t offset, std::span<uint8_t const> input) {
+        if (!m_powered || offset % Storage::PAGE_SIZE != 0u ||
+            input.size() % Storage::PAGE_SIZE != 0u || offset + input.size() > size())
+            return false;
+
+        // a torn program only lands the first half of the bytes
+        size_t const count = consumeOperation() ? input.size() : input.size() / 2u;
+        for (size_t i = 0u; i < count; ++i) m_memory[offset + i] &= input[i];
+
+        ++m_programCount;
+        return m_powered;
+    }
+
+    bool erase(uint32_t offset) {
+        if (!m_powered || offset % Storage::SECTOR_SIZE != 0u ||
+            offset + Storage::SECTOR_SIZE > size())
+            return false;
+
+        // a torn erase leaves the back half of the sector untouched
+        size_t const count = consumeOperation() ? Storage::SECTOR_SIZE : Storage::SECTOR_SIZE / 2u;
+        std::fill_n(m_memory.begin() + offset, count, 0xff);
+
+        ++m_eraseCounts[offset / Storage::SECTOR_SIZE];
+        return m_powered;
+    }
+
+    // the next operations succeed, then the one after is torn and everything fails until powerOn()
+    void failAfter(size_t operations) { m_operationsLeft = operations; }
+    void powerOn() {
+        m_powered = true;
+        m_operationsLeft.reset();
+    }
+    bool powered() const { return m_powered; }
+
+    size_t programCount() const { return m_programCount; }
+    std::span<uint32_t const> eraseCounts() const { return m_eraseCounts; }
+
+private:
+    bool consumeOperation() {
+        if (!m_operationsLeft) return true;
+        if (*m_operationsLeft > 0u) {
+            --*m_operationsLeft;
+            return true;
+        }
+
+        m_powered = false;
+        return false;
+    }
+
+    std::vector<uint8_t> m_memory{};
+    std::vector<uint32_t> m_eraseCounts{};
+    size_t m_programCount{ 0u };
+
+    std::optional<size_t> m_operationsLeft{};
+    bool m_powered{ true };
+};
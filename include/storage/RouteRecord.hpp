@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "comms/Frame.hpp"
+#include "comms/Protocol.hpp"
+
+#include "path/Compiler.hpp"
+#include "path/Route.hpp"
+
+#include "storage/FlashDevice.hpp"
+#include "storage/LogStore.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+// an uploaded route in the command wire format, tagged with the fingerprint of the route built
+// into the firmware so reflashing a new competition route is not overridden by an older upload
+namespace RouteRecord {
+    // u16 built in fingerprint, u16 size, f32 target time, then the commands
+    inline constexpr size_t HEADER_SIZE = 2u * sizeof(uint16_t) + sizeof(float);
+    inline constexpr size_t MAX_SIZE = HEADER_SIZE + Route::CAPACITY * Protocol::COMMAND_SIZE;
+
+    inline size_t serialize(Route const& route, uint16_t fingerprint, std::span<uint8_t> output) {
+        Protocol::Writer writer{ output };
+        writer.write(fingerprint)
+            .write(static_cast<uint16_t>(route.size()))
+            .write(route.targetTime());
+        for (Compiler::Command const& command : route.commands()) writer.write(command);
+
+        return writer.overflowed() ? 0u : writer.data().size();
+    }
+
+    // returns the fingerprint the route was serialized with, the route is left alone on failure
+    inline std::optional<uint16_t> deserialize(std::span<uint8_t const> input, Route& route) {
+        static std::array<Compiler::Command, Route::CAPACITY> s_commands{};
+
+        Protocol::Reader reader{ input };
+        auto const fingerprint = reader.read<uint16_t>();
+        auto const count = reader.read<uint16_t>();
+        auto const targetTime = reader.read<float>();
+        if (!targetTime || *count > Route::CAPACITY) return std::nullopt;
+
+        for (size_t i = 0u; i < *count; ++i) {
+            auto const command = reader.readCommand();
+            if (!command) return std::nullopt;
+            s_commands[i] = *command;
+        }
+
+        if (!route.setIfFeasible(s_commands, *count, *targetTime)) return std::nullopt;
+        return fingerprint;
+    }
+
+    inline uint16_t fingerprint(Route const& route) {
+        static std::array<uint8_t, MAX_SIZE> s_buffer{};
+
+        size_t const size = serialize(route, 0u, s_buffer);
+        return Frame::crc16({ s_buffer.data(), size });
+    }
+
+    template <FlashDeviceType Device>
+    bool save(LogStore<Device>& store, Route const& route, uint16_t builtInFingerprint) {
+        static_assert(MAX_SIZE <= LogStore<Device>::MAX_RECORD_SIZE);
+        static std::array<uint8_t, MAX_SIZE> s_buffer{};
+
+        size_t const size = serialize(route, builtInFingerprint, s_buffer);
+        return size > 0u && store.append(RecordType::ROUTE, 0u, { s_buffer.data(), size });
+    }
+
+    template <FlashDeviceType Device>
+    bool load(LogStore<Device> const& store, Route& route, uint16_t builtInFingerprint) {
+        static std::array<uint8_t, MAX_SIZE> s_buffer{};
+
+        auto const size = store.read(RecordType::ROUTE, 0u, s_buffer);
+        if (!size) return false;
+
+        // checked before deserializing so a stale upload never touches the route
+        Protocol::Reader reader{ { s_buffer.data(), *size } };
+        if (reader.read<uint16_t>() != builtInFingerprint) return false;
+
+        return deserialize({ s_buffer.data(), *size }, route).has_value();
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "state/Vector.hpp"
+
+#include <cstdint>
+
+// what the robot streams while it drives, a slow loop iteration every Telemetry::DECIMATION. index
+// counts every sample taken and dropped every one the queue had no room for, so the receiver can
+// tell samples the robot dropped from frames lost on the way
+namespace Telemetry {
+    struct Sample {
+        uint32_t index{};
+        uint32_t dropped{};
+        float elapsed{};
+
+        Vec2 position{};
+        Vec2 velocity{};
+        float angle{};
+        float angularVelocity{};
+
+        // the follower's wheel speeds and the velocity regulator's voltages for them
+        Vec2 targetSpeeds{};
+        Vec2 targetVoltages{};
+
+        uint16_t segment{};
+    };
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "comms/Frame.hpp"
+#include "comms/Protocol.hpp"
+
+#include "telemetry/Telemetry.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// a single producer single consumer queue between the slow loop and whatever drains it to the
+// link. the producer never waits, a sample that finds the queue full is dropped and counted, and
+// the consumer only writes a frame once the transport has room for all of it
+template <typename Transport>
+class TelemetryStream {
+public:
+    TelemetryStream(Transport& transport) : m_transport{ transport } {}
+
+    TelemetryStream(TelemetryStream const&) = delete;
+    TelemetryStream& operator=(TelemetryStream const&) = delete;
+    TelemetryStream(TelemetryStream&&) = delete;
+    TelemetryStream& operator=(TelemetryStream&&) = delete;
+
+    // index and dropped are filled in here
+    void push(Telemetry::Sample sample) {
+        uint32_t const head = m_head.load(std::memory_order_relaxed);
+        uint32_t const dropped = m_dropped.load(std::memory_order_relaxed);
+
+        sample.index = m_taken++;
+        sample.dropped = dropped;
+
+        if (head - m_tail.load(std::memory_order_acquire) == CAPACITY) {
+            m_dropped.store(dropped + 1u, std::memory_order_relaxed);
+            return;
+        }
+
+        m_samples[head % CAPACITY] = sample;
+        m_head.store(head + 1u, std::memory_order_release);
+    }
+
+    // sends what the link takes right now and returns, a frame that did not fit is kept for the
+    // next call
+    void drain() {
+        while (true) {
+            if (m_frameSize == 0u && !encodeNext()) return;
+            if (!m_transport.tryWrite({ m_frame.data(), m_frameSize })) return;
+
+            m_frameSize = 0u;
+            ++m_sent;
+        }
+    }
+
+    bool empty() const {
+        return m_frameSize == 0u &&
+               m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+    }
+
+    uint32_t sent() const { return m_sent; }
+    uint32_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t CAPACITY = Telemetry::QUEUE_CAPACITY;
+    static_assert((CAPACITY & (CAPACITY - 1u)) == 0u, "the indices wrap at 2^32");
+
+    bool encodeNext() {
+        uint32_t const tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail) return false;
+
+        std::array<uint8_t, Comms::MAX_PAYLOAD_SIZE> payload{};
+        Protocol::Writer writer{ payload };
+        writer.write(static_cast<uint8_t>(Protocol::Message::TELEMETRY))
+            .write(uint8_t{ 0u })
+            .write(m_samples[tail % CAPACITY]);
+        m_tail.store(tail + 1u, std::memory_order_release);
+
+        // a leading delimiter as well, so text the robot printed before cannot run into the frame
+        m_frame[0] = Frame::DELIMITER;
+        m_frameSize = 1u + Frame::encode(writer.data(), std::span{ m_frame }.subspan(1u));
+        return true;
+    }
+
+    Transport& m_transport;
+
+    std::array<Telemetry::Sample, CAPACITY> m_samples{};
+    std::atomic<uint32_t> m_head{ 0u };
+    std::atomic<uint32_t> m_tail{ 0u };
+
+    // only the producer writes these
+    uint32_t m_taken{ 0u };
+    std::atomic<uint32_t> m_dropped{ 0u };
+
+    // only the consumer touches these
+    std::array<uint8_t, Comms::MAX_FRAME_SIZE + 1u> m_frame{};
+    size_t m_frameSize{ 0u };
+    uint32_t m_sent{ 0u };
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// the gains worth tuning on the robot, defaulting to their values in its profile. the robot only
+// takes changes over usb until the calibration click, before either loop is built, so a run never
+// sees one change under it. with Integration::TUNABLE_PARAMETERS off, value() is the default itself
+// and folds away like the constant it stands in for
+namespace Parameters {
+    enum Id : size_t {
+        STRAIGHT_ANGULAR_KP,
+        STRAIGHT_ANGULAR_KD,
+        STRAIGHT_LINEAR_KP,
+        STRAIGHT_LINEAR_KD,
+        STRAIGHT_LINEAR_CONTROL_AUTHORITY,
+        ROTATION_KS,
+        ROTATION_KP,
+        LINEAR_VELOCITY_KS,
+        LINEAR_VELOCITY_KV,
+        LINEAR_VELOCITY_KA,
+        LINEAR_VELOCITY_KP,
+        LINEAR_VELOCITY_KI,
+        ANGULAR_VELOCITY_KS,
+        ANGULAR_VELOCITY_KV,
+        ANGULAR_VELOCITY_KA,
+        ANGULAR_VELOCITY_KP,
+        ANGULAR_VELOCITY_KI,
+        VELOCITY_CUTOFF_FREQUENCY,
+        WHEEL_SPEED_CUTOFF_FREQUENCY,
+        ANGULAR_VELOCITY_CUTOFF_FREQUENCY,
+        COUNT,
+    };
+
+    struct Info {
+        std::string_view name{};
+        float defaultValue{};
+        float min{};
+        float max{};
+    };
+
+    // the same bounds for every profile, each one's own constants as the defaults
+    template <RobotProfileType Profile>
+    constexpr std::array<Info, COUNT> table() {
+        using Forward = Profile::Kinematics::Forward;
+        using Straight = Profile::Manager::Straight;
+        using Rotation = Profile::Manager::Rotation;
+        using Linear = Profile::Regulators::Velocity::Linear;
+        using Angular = Profile::Regulators::Velocity::Angular;
+
+        return { {
+            { "straight-angular-kp", Straight::angularKp, 0.0f, 200.0f },
+            { "straight-angular-kd", Straight::angularKd, 0.0f, 10.0f },
+            { "straight-linear-kp", Straight::linearKp, 0.0f, 50.0f },
+            { "straight-linear-kd", Straight::linearKd, 0.0f, 10.0f },
+            { "straight-linear-authority", Straight::LINEAR_CONTROL_AUTHORITY, 0.0f, 5.0f },
+            { "rotation-ks", Rotation::kS, 0.0f, 10.0f },
+            { "rotation-kp", Rotation::kP, 0.0f, 50.0f },
+            { "linear-velocity-ks", Linear::kS, 0.0f, 2.0f },
+            { "linear-velocity-kv", Linear::kV, 0.0f, 0.5f },
+            { "linear-velocity-ka", Linear::kA, 0.0f, 0.1f },
+            { "linear-velocity-kp", Linear::kP, 0.0f, 2.0f },
+            { "linear-velocity-ki", Linear::kI, 0.0f, 2.0f },
+            { "angular-velocity-ks", Angular::kS, 0.0f, 2.0f },
+            { "angular-velocity-kv", Angular::kV, 0.0f, 5.0f },
+            { "angular-velocity-ka", Angular::kA, 0.0f, 1.0f },
+            { "angular-velocity-kp", Angular::kP, 0.0f, 20.0f },
+            { "angular-velocity-ki", Angular::kI, 0.0f, 20.0f },
+            { "velocity-cutoff", Forward::VELOCITY_CUTOFF_FREQUENCY, 1.0f, 500.0f },
+            { "wheel-speed-cutoff", Forward::WHEEL_SPEED_CUTOFF_FREQUENCY, 1.0f, 500.0f },
+            { "angular-velocity-cutoff", Forward::ANGULAR_VELOCITY_CUTOFF_FREQUENCY, 1.0f,
+              500.0f },
+        } };
+    }
+
+    template <RobotProfileType Profile>
+    constexpr bool inBounds() {
+        return std::ranges::all_of(table<Profile>(), [](Info const& info) {
+            return info.defaultValue >= info.min && info.defaultValue <= info.max;
+        });
+    }
+
+    static_assert(inBounds<Robot>(), "a default is outside its own bounds");
+
+    inline constexpr std::array<Info, COUNT> TABLE = table<Robot>();
+
+    using Values = std::array<float, COUNT>;
+
+    constexpr Values defaults() {
+        Values values{};
+        for (size_t id = 0u; id < COUNT; ++id) values[id] = TABLE[id].defaultValue;
+        return values;
+    }
+
+    // fnv-1a over the names, so values stored by a firmware with a different table are ignored
+    constexpr uint32_t fingerprint() {
+        uint32_t hash = 2166136261u;
+        for (Info const& info : TABLE)
+            for (char const character : info.name) {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= 16777619u;
+            }
+        return hash;
+    }
+
+    // what is kept in flash under RecordType::TUNING
+    struct Record {
+        uint32_t fingerprint{};
+        Values values{};
+    };
+
+    // only ever written before the loops are built, or by a host tool between runs
+    inline Values values = defaults();
+
+    // only the robot the build is for can be tuned, any other profile gets its own constants
+    template <RobotProfileType Profile, Id id>
+    float value() {
+        static_assert(inBounds<Profile>(), "a default is outside its own bounds");
+
+        if constexpr (Integration::TUNABLE_PARAMETERS && std::same_as<Profile, Robot>)
+            return values[id];
+        else return table<Profile>()[id].defaultValue;
+    }
+
+    inline std::optional<Id> find(std::string_view name) {
+        for (size_t id = 0u; id < COUNT; ++id)
+            if (TABLE[id].name == name) return static_cast<Id>(id);
+        return std::nullopt;
+    }
+
+    // nan puts the default back, anything outside the bounds is refused
+    inline bool set(size_t id, float value) {
+        if (!Integration::TUNABLE_PARAMETERS || id >= COUNT) return false;
+
+        Info const& info = TABLE[id];
+        if (std::isnan(value)) value = info.defaultValue;
+        if (!(value >= info.min && value <= info.max)) return false;
+
+        values[id] = value;
+        return true;
+    }
+
+    inline Record record() { return { fingerprint(), values }; }
+
+    // all or nothing, a record with any value out of bounds leaves the table as it was
+    inline bool load(Record const& record) {
+        if (record.fingerprint != fingerprint()) return false;
+
+        Values const previous = values;
+        for (size_t id = 0u; id < COUNT; ++id) {
+            if (set(id, record.values[id])) continue;
+
+            values = previous;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,30 @@
+#include "comms/UsbTransport.hpp"
+
+#include "pico/stdio.h"
+#include "pico/stdio_usb.h"
+
+#include "tusb.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+std::optional<uint8_t> UsbTransport::read() {
+    int const character = getchar_timeout_us(0u);
+
+    if (character == PICO_ERROR_TIMEOUT) return std::nullopt;
+    else return static_cast<uint8_t>(character);
+}
+
+void UsbTransport::write(std::span<uint8_t const> data) {
+    // putchar_raw skips the crlf translation that would corrupt binary frames
+    for (uint8_t const byte : data) putchar_raw(byte);
+    stdio_flush();
+}
+
+bool UsbTransport::tryWrite(std::span<uint8_t const> data) {
+    if (!stdio_usb_connected() || tud_cdc_write_available() < data.size()) return false;
+
+    write(data);
+    return true;
+}
@@ -4,29 +4,117 @@
 
 #include "Constants.hpp"
 
+#include "drivers/SnapshotDma.hpp"
+
 #include "state/Vector.hpp"
 
 #include "hardware/dma.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
 #include "hardware/pio.h"
 #include "hardware/spi.h"
+#include "hardware/timer.h"
 
 #include "pico/time.h"
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// there is one gyroscope, so the interrupt handler finds its callback here
+static Gyroscope::SampleCallback sampleCallback{ nullptr };
+static void* sampleContext{ nullptr };
+static uint sampleChannel{};
+
+static void sampleHandler() {
+    if (!dma_channel_get_irq1_status(sampleChannel)) return;
+
+    dma_channel_acknowledge_irq1(sampleChannel);
+    sampleCallback(sampleContext);
+}
 
 Gyroscope::Gyroscope(PIO pio, uint csPin, uint sckPin, uint misoPin, uint mosiPin, uint intPin)
-    : m_rawDataPtr{ reinterpret_cast<uint32_t>(&m_rawData[0]) } {
-    spi_inst_t* spi = setupRegisterReadWrite(csPin, sckPin, misoPin, mosiPin);
-    setupRegisters(spi, csPin);
+    : m_pio{ pio },
+      m_csPin{ csPin },
+      m_sckPin{ sckPin },
+      m_misoPin{ misoPin },
+      m_mosiPin{ mosiPin },
+      m_intPin{ intPin } {
+    m_spi = setupRegisterReadWrite(csPin, sckPin, misoPin, mosiPin);
+    setupRegisters(m_spi, csPin);
+}
+
+void Gyroscope::calibrate() {
+    m_bias = getBias(m_spi, m_csPin, Drivers::Gyroscope::GYRO_CALIBRATION_SAMPLE_COUNT);
+    m_down = getDown(m_spi, m_csPin, Drivers::Gyroscope::DOWN_DIRECTION_SAMPLE_COUNT);
+    m_temperature = getTemperature(m_spi, m_csPin);
+}
+
+bool Gyroscope::verify(Calibration const& calibration) {
+    using namespace Drivers::Gyroscope;
+
+    float const temperature = getTemperature(m_spi, m_csPin);
+    if (std::fabsf(temperature - calibration.temperature) > MAX_CACHED_TEMPERATURE_ERROR)
+        return false;
+
+    // any motion or drift since the cached calibration pulls the short average away from it
+    Vec3 const bias = getBias(m_spi, m_csPin, VERIFICATION_BIAS_SAMPLE_COUNT);
+    if ((bias - calibration.bias).length() > MAX_CACHED_BIAS_ERROR) return false;
+
+    Vec3 const down = getDown(m_spi, m_csPin, VERIFICATION_DOWN_SAMPLE_COUNT);
+    if (Vec3::dot(down, calibration.down) < MIN_CACHED_DOWN_ALIGNMENT) return false;
+
+    m_bias = calibration.bias;
+    m_down = calibration.down;
+    m_temperature = temperature;
+    return true;
+}
+
+void Gyroscope::start() {
+    endSetup(m_spi);
+    setupPIORead(m_pio, m_csPin, m_sckPin, m_misoPin, m_mosiPin, m_intPin);
+}
+
+void Gyroscope::setSampleCallback(SampleCallback callback, void* context, uint8_t priority) {
+    bool const installed = sampleCallback != nullptr;
 
-    getBias(spi, csPin);
-    getDown(spi, csPin);
+    irq_set_enabled(DMA_IRQ_1, false);
+    sampleCallback = callback;
+    sampleContext = context;
+    sampleChannel = m_sampleChannel;
 
-    endSetup(spi);
-    setupPIORead(pio, csPin, sckPin, misoPin, mosiPin, intPin);
+    if (!installed) {
+        dma_channel_set_irq1_enabled(m_sampleChannel, true);
+        irq_add_shared_handler(DMA_IRQ_1, sampleHandler,
+                               PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    }
+    irq_set_priority(DMA_IRQ_1, priority);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+float Gyroscope::measureSamplePeriod() {
+    static std::atomic<uint32_t> s_count{ 0u };
+
+    setSampleCallback([](void*) { s_count.fetch_add(1u, std::memory_order_relaxed); }, nullptr,
+                      PICO_DEFAULT_IRQ_PRIORITY);
+
+    // both ends are taken on a sample edge so the window holds a whole number of periods
+    auto const nextSample = [&]() {
+        uint32_t const count = s_count.load(std::memory_order_relaxed);
+        while (s_count.load(std::memory_order_relaxed) == count) tight_loop_contents();
+        return std::make_pair(time_us_64(), s_count.load(std::memory_order_relaxed));
+    };
+
+    auto const [startTime, startCount] = nextSample();
+    sleep_us(static_cast<uint64_t>(Drivers::Gyroscope::SAMPLE_PERIOD_MEASUREMENT_TIME * 1.0e6f));
+    auto const [endTime, endCount] = nextSample();
+
+    return static_cast<float>(endTime - startTime) * 1.0e-6f /
+           static_cast<float>(endCount - startCount);
 }
 
 spi_inst_t* Gyroscope::setupRegisterReadWrite(uint csPin, uint sckPin, uint misoPin,
@@ -52,8 +140,8 @@ void Gyroscope::setupRegisters(spi_inst_t* spi, uint csPin) const {
     writeRegister(spi, csPin, Bank0::DEVICE_CONFIG, 0b00000001);
     sleep_ms(1);
 
-    // switch gyro and accel to low noise mode and disable temperature sensor
-    writeRegister(spi, csPin, Bank0::PWR_MGMT0, 0b00101111);
+    // switch gyro and accel to low noise mode with the temperature sensor on
+    writeRegister(spi, csPin, Bank0::PWR_MGMT0, 0b00001111);
 
     // switch accelerometer to 2g at 32kHz
     writeRegister(spi, csPin, Bank0::ACCEL_CONFIG0, 0b01100001);
@@ -73,9 +161,9 @@ void Gyroscope::setupRegisters(spi_inst_t* spi, uint csPin) const {
     sleep_ms(100);
 }
 
-void Gyroscope::getBias(spi_inst_t* spi, uint csPin) {
-    m_bias = { 0.0f, 0.0f, 0.0f };
-    for (size_t sample = 0; sample < Drivers::Gyroscope::GYRO_CALIBRATION_SAMPLE_COUNT; ++sample) {
+Vec3 Gyroscope::getBias(spi_inst_t* spi, uint csPin, size_t sampleCount) const {
+    Vec3 bias{ 0.0f, 0.0f, 0.0f };
+    for (size_t sample = 0; sample < sampleCount; ++sample) {
         uint8_t rawMeasurements[6]{};
         readRegisters(spi, csPin, Bank0::GYRO_DATA_X1, rawMeasurements, 6u);
 
@@ -83,17 +171,16 @@ void Gyroscope::getBias(spi_inst_t* spi, uint csPin) {
         uint16_t y = rawMeasurements[2] << 8u | rawMeasurements[3];
         uint16_t z = rawMeasurements[4] << 8u | rawMeasurements[5];
 
-        m_bias += Vec3{ static_cast<float>(std::bit_cast<int16_t>(x)),
-                        static_cast<float>(std::bit_cast<int16_t>(y)),
-                        static_cast<float>(std::bit_cast<int16_t>(z)) };
+        bias += Vec3{ static_cast<float>(std::bit_cast<int16_t>(x)),
+                      static_cast<float>(std::bit_cast<int16_t>(y)),
+                      static_cast<float>(std::bit_cast<int16_t>(z)) };
     }
-    m_bias /= Drivers::Gyroscope::RESOLUTION *
-              static_cast<float>(Drivers::Gyroscope::GYRO_CALIBRATION_SAMPLE_COUNT);
+    return bias / (Drivers::Gyroscope::RESOLUTION * static_cast<float>(sampleCount));
 }
 
-void Gyroscope::getDown(spi_inst_t* spi, uint csPin) {
-    m_down = { 0.0f, 0.0f, 0.0f };
-    for (size_t sample = 0; sample < Drivers::Gyroscope::DOWN_DIRECTION_SAMPLE_COUNT; ++sample) {
+Vec3 Gyroscope::getDown(spi_inst_t* spi, uint csPin, size_t sampleCount) const {
+    Vec3 down{ 0.0f, 0.0f, 0.0f };
+    for (size_t sample = 0; sample < sampleCount; ++sample) {
         uint8_t rawMeasurements[6]{};
         readRegisters(spi, csPin, Bank0::ACCEL_DATA_X1, rawMeasurements, 6u);
 
@@ -101,11 +188,21 @@ void Gyroscope::getDown(spi_inst_t* spi, uint csPin) {
         uint16_t y = rawMeasurements[2] << 8u | rawMeasurements[3];
         uint16_t z = rawMeasurements[4] << 8u | rawMeasurements[5];
 
-        m_down += Vec3{ static_cast<float>(std::bit_cast<int16_t>(x)),
-                        static_cast<float>(std::bit_cast<int16_t>(y)),
-                        static_cast<float>(std::bit_cast<int16_t>(z)) };
+        down += Vec3{ static_cast<float>(std::bit_cast<int16_t>(x)),
+                      static_cast<float>(std::bit_cast<int16_t>(y)),
+                      static_cast<float>(std::bit_cast<int16_t>(z)) };
     }
-    m_down /= m_down.length();
+    return down / down.length();
+}
+
+float Gyroscope::getTemperature(spi_inst_t* spi, uint csPin) const {
+    uint8_t rawMeasurement[2]{};
+    readRegisters(spi, csPin, Bank0::TEMP_DATA1, rawMeasurement, 2u);
+
+    uint16_t const raw = rawMeasurement[0] << 8u | rawMeasurement[1];
+    return static_cast<float>(std::bit_cast<int16_t>(raw)) /
+               Drivers::Gyroscope::TEMPERATURE_SENSITIVITY +
+           Drivers::Gyroscope::TEMPERATURE_OFFSET;
 }
 
 void Gyroscope::endSetup(spi_inst_t* spi) const { spi_deinit(spi); }
@@ -117,24 +214,8 @@ void Gyroscope::setupPIORead(PIO pio, uint csPin, uint sckPin, uint misoPin, uin
     uint const offset = pio_add_program(pio, &gyroscope_program);
     gyroscope_program_init(pio, sm, offset, csPin, sckPin, misoPin, mosiPin, intPin);
 
-    uint const dmaReadDataChannel = dma_claim_unused_channel(true);
-    uint const dmaReadControlChannel = dma_claim_unused_channel(true);
-
-    auto dmaReadDataConfig = dma_channel_get_default_config(dmaReadDataChannel);
-    channel_config_set_chain_to(&dmaReadDataConfig, dmaReadControlChannel);
-    channel_config_set_read_increment(&dmaReadDataConfig, false);
-    channel_config_set_write_increment(&dmaReadDataConfig, true);
-    channel_config_set_dreq(&dmaReadDataConfig, pio_get_dreq(pio, sm, false));
-
-    auto dmaReadControlConfig = dma_channel_get_default_config(dmaReadControlChannel);
-    channel_config_set_read_increment(&dmaReadControlConfig, false);
-    channel_config_set_write_increment(&dmaReadControlConfig, false);
-
-    dma_channel_configure(dmaReadDataChannel, &dmaReadDataConfig, nullptr, &pio->rxf[sm],
-                          dma_encode_transfer_count(3u), false);
-    dma_channel_configure(dmaReadControlChannel, &dmaReadControlConfig,
-                          &dma_hw->ch[dmaReadDataChannel].al2_write_addr_trig, &m_rawDataPtr,
-                          dma_encode_transfer_count(1u), true);
+    m_sampleChannel =
+        SnapshotDma::start(m_snapshot, &pio->rxf[sm], pio_get_dreq(pio, sm, false)).sequence;
 
     uint const dmaWriteChannel = dma_claim_unused_channel(true);
 
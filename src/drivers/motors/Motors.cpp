@@ -2,6 +2,9 @@
 
 #include "Constants.hpp"
 
+#include "drivers/PwmTiming.hpp"
+#include "drivers/SnapshotDma.hpp"
+
 #include "state/Vector.hpp"
 
 #include "hardware/adc.h"
@@ -11,8 +14,21 @@
 #include "hardware/pwm.h"
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+namespace {
+    // the round robin steps up through its inputs from the selected one and wraps around
+    std::array<size_t, 3> roundRobinOrder(std::array<uint, 3> const& inputs, uint first) {
+        std::array<size_t, 3> order{ 0u, 1u, 2u };
+        std::ranges::sort(order, {}, [&](size_t i) {
+            return (inputs[i] + NUM_ADC_CHANNELS - first) % NUM_ADC_CHANNELS;
+        });
+        return order;
+    }
+}
+
 Motors::Controller::Controller(uint in1Pin, uint in2Pin)
     : m_in1Channel{ pwm_gpio_to_channel(in1Pin) },
       m_in2Channel{ pwm_gpio_to_channel(in2Pin) },
@@ -27,8 +43,8 @@ Motors::Controller::Controller(uint in1Pin, uint in2Pin)
     pwm_config_set_wrap(&pwmConfig, Drivers::Motors::PWM_WRAP);
     pwm_config_set_phase_correct(&pwmConfig, true);
 
-    pwm_init(m_in1Slice, &pwmConfig, true);
-    pwm_init(m_in2Slice, &pwmConfig, true);
+    pwm_init(m_in1Slice, &pwmConfig, false);
+    pwm_init(m_in2Slice, &pwmConfig, false);
 
     spin(0);
 }
@@ -52,13 +68,19 @@ void Motors::Controller::spin(int power) {
     }
 }
 
-Motors::CurrentSensor::CurrentSensor(uint leftCurrentPin, uint rightCurrentPin) {
+Motors::CurrentSensor::CurrentSensor(uint leftCurrentPin, uint rightCurrentPin,
+                                     uint voltagePin) {
     adc_gpio_init(leftCurrentPin);
     adc_gpio_init(rightCurrentPin);
+    adc_gpio_init(voltagePin);
 
     m_bias.x = getBias(leftCurrentPin);
     m_bias.y = getBias(rightCurrentPin);
-    setupRead(leftCurrentPin, rightCurrentPin);
+
+    // a clock the motor period cannot pace at leaves the round robin free running
+    if constexpr (Integration::PWM_SYNCHRONOUS_CURRENT_SAMPLING)
+        if (setupPacedRead(leftCurrentPin, rightCurrentPin, voltagePin)) return;
+    setupRead(leftCurrentPin, rightCurrentPin, voltagePin);
 }
 
 float Motors::CurrentSensor::getBias(uint currentPin) {
@@ -97,48 +119,172 @@ float Motors::CurrentSensor::getBias(uint currentPin) {
     return rawBias * 3.3f / 4095.0f * 5.0f;
 }
 
-void Motors::CurrentSensor::setupRead(uint leftCurrentPin, uint rightCurrentPin) {
+void Motors::CurrentSensor::setupRead(uint leftCurrentPin, uint rightCurrentPin,
+                                      uint voltagePin) {
+    std::array<uint, 3> const inputs{ leftCurrentPin - 26u, rightCurrentPin - 26u,
+                                      voltagePin - 26u };
+
     adc_init();
-    adc_select_input(leftCurrentPin - 26u);
-    adc_set_round_robin((1u << (leftCurrentPin - 26u)) | (1u << (rightCurrentPin - 26u)));
+    adc_select_input(inputs[0]);
+    adc_set_round_robin((1u << inputs[0]) | (1u << inputs[1]) | (1u << inputs[2]));
     adc_fifo_setup(true, true, 1u, false, false);
     adc_set_clkdiv(0.0f);
 
-    uint const dmaChannel1 = dma_claim_unused_channel(true);
-    uint const dmaChannel2 = dma_claim_unused_channel(true);
+    // each channel of the dma ring writes the next input in round robin order into its own slot
+    auto const order = roundRobinOrder(inputs, inputs[0]);
 
-    auto dmaConfig1 = dma_channel_get_default_config(dmaChannel1);
-    channel_config_set_chain_to(&dmaConfig1, dmaChannel2);
-    channel_config_set_transfer_data_size(&dmaConfig1, DMA_SIZE_16);
-    channel_config_set_read_increment(&dmaConfig1, false);
-    channel_config_set_write_increment(&dmaConfig1, false);
-    channel_config_set_dreq(&dmaConfig1, DREQ_ADC);
+    std::array<uint, 3> dmaChannels{};
+    for (uint& dmaChannel : dmaChannels) dmaChannel = dma_claim_unused_channel(true);
 
-    auto dmaConfig2 = dma_channel_get_default_config(dmaChannel2);
-    channel_config_set_chain_to(&dmaConfig2, dmaChannel1);
-    channel_config_set_transfer_data_size(&dmaConfig2, DMA_SIZE_16);
-    channel_config_set_read_increment(&dmaConfig2, false);
-    channel_config_set_write_increment(&dmaConfig2, false);
-    channel_config_set_dreq(&dmaConfig2, DREQ_ADC);
+    for (size_t i = 0u; i < dmaChannels.size(); ++i) {
+        auto dmaConfig = dma_channel_get_default_config(dmaChannels[i]);
+        channel_config_set_chain_to(&dmaConfig, dmaChannels[(i + 1u) % dmaChannels.size()]);
+        channel_config_set_transfer_data_size(&dmaConfig, DMA_SIZE_16);
+        channel_config_set_read_increment(&dmaConfig, false);
+        channel_config_set_write_increment(&dmaConfig, false);
+        channel_config_set_dreq(&dmaConfig, DREQ_ADC);
 
-    dma_channel_configure(dmaChannel1, &dmaConfig1, &m_rawData[0], &adc_hw->fifo,
-                          dma_encode_transfer_count(1u), false);
-    dma_channel_configure(dmaChannel2, &dmaConfig2, &m_rawData[1], &adc_hw->fifo,
-                          dma_encode_transfer_count(1u), false);
+        dma_channel_configure(dmaChannels[i], &dmaConfig, &m_rawData[order[i]], &adc_hw->fifo,
+                              dma_encode_transfer_count(1u), false);
+    }
 
-    dma_channel_start(dmaChannel1);
+    dma_channel_start(dmaChannels[0]);
 
     adc_run(true);
 }
 
-Vec2 Motors::CurrentSensor::data() const {
-    return Vec2{ static_cast<float>(m_rawData[0]) * 3.3f / 4095.0f * 5.0f,
-                 static_cast<float>(m_rawData[1]) * 3.3f / 4095.0f * 5.0f } -
-           m_bias;
+// PwmTiming has the arithmetic. the pacing channels write whole control words, so every period
+// restarts the round robin from its first input wherever the last one left it
+bool Motors::CurrentSensor::setupPacedRead(uint leftCurrentPin, uint rightCurrentPin,
+                                           uint voltagePin) {
+    using namespace Drivers::Motors;
+
+    uint32_t const sysClockHz = clock_get_hz(clk_sys);
+    auto const timing = PwmTiming::timing(
+        sysClockHz, PwmTiming::divider(sysClockHz, TARGET_CLK_FREQUENCY), PWM_WRAP, 3u);
+    if (!timing) return false;
+
+    std::array<uint, 3> const inputs{ leftCurrentPin - 26u, rightCurrentPin - 26u,
+                                      voltagePin - 26u };
+
+    // starting from the input after the voltage puts the currents first, either side of the
+    // centre, and the voltage last where the stop lands. the stop keeps the voltage selected so
+    // the conversion it lands in reads the same input to the end
+    uint const first = inputs[roundRobinOrder(inputs, inputs[2])[1]];
+    auto const order = roundRobinOrder(inputs, first);
+    for (size_t i = 0u; i < order.size(); ++i) m_slots[order[i]] = i;
+
+    uint32_t const roundRobin = ((1u << inputs[0]) | (1u << inputs[1]) | (1u << inputs[2]))
+                                << ADC_CS_RROBIN_LSB;
+    m_startControl = ADC_CS_EN_BITS | ADC_CS_START_MANY_BITS | roundRobin |
+                     (first << ADC_CS_AINSEL_LSB);
+    m_stopControl = ADC_CS_EN_BITS | roundRobin | (inputs[2] << ADC_CS_AINSEL_LSB);
+
+    adc_init();
+    adc_fifo_setup(true, true, 1u, false, false);
+    adc_set_clkdiv(0.0f);
+    adc_fifo_drain();
+
+    m_channels = SnapshotDma::start(m_snapshot, &adc_hw->fifo, DREQ_ADC);
+
+    std::array<uint, 2> const slices{ SAMPLE_START_SLICE, SAMPLE_STOP_SLICE };
+    std::array<uint16_t, 2> const counters{ timing->startCounter, timing->stopCounter };
+    std::array<uint32_t const*, 2> const controls{ &m_startControl, &m_stopControl };
+
+    std::array<uint, 2> pacingChannels{};
+    for (uint& dmaChannel : pacingChannels) dmaChannel = dma_claim_unused_channel(true);
+    uint const witnessChannel = dma_claim_unused_channel(true);
+
+    for (size_t i = 0u; i < slices.size(); ++i) {
+        // the divider the motors were given, so all of them count the same clock
+        auto pwmConfig = pwm_get_default_config();
+        pwm_config_set_clkdiv(&pwmConfig,
+                              static_cast<float>(sysClockHz) / TARGET_CLK_FREQUENCY);
+        pwm_config_set_wrap(&pwmConfig, timing->sampleWrap);
+        pwm_init(slices[i], &pwmConfig, false);
+        pwm_set_counter(slices[i], counters[i]);
+
+        auto dmaConfig = dma_channel_get_default_config(pacingChannels[i]);
+        channel_config_set_read_increment(&dmaConfig, false);
+        channel_config_set_write_increment(&dmaConfig, false);
+        channel_config_set_dreq(&dmaConfig, pwm_get_dreq(slices[i]));
+
+        // the start goes one period at a time, handing to the witness in between
+        if (i == 0u) channel_config_set_chain_to(&dmaConfig, witnessChannel);
+        dma_channel_configure(pacingChannels[i], &dmaConfig, &adc_hw->cs, controls[i],
+                              i == 0u ? dma_encode_transfer_count(1u)
+                                      : dma_encode_endless_transfer_count(),
+                              true);
+
+        m_sampleSlices |= 1u << slices[i];
+    }
+
+    // as the round robin starts, well before its first conversion, copies how many words the
+    // data channel still wants into m_remaining and hands back to the start channel
+    auto witnessConfig = dma_channel_get_default_config(witnessChannel);
+    channel_config_set_chain_to(&witnessConfig, pacingChannels[0]);
+    channel_config_set_read_increment(&witnessConfig, false);
+    channel_config_set_write_increment(&witnessConfig, false);
+
+    dma_channel_configure(witnessChannel, &witnessConfig, &m_remaining,
+                          &dma_hw->ch[m_channels.data].transfer_count,
+                          dma_encode_transfer_count(1u), false);
+
+    return true;
+}
+
+Motors::CurrentSensor::Sample Motors::CurrentSensor::sample() {
+    if (m_sampleSlices == 0u) return convert({ m_rawData[0], m_rawData[1], m_rawData[2] }, 0u);
+
+    uint8_t period{};
+    auto const words = m_snapshot.read(period);
+
+    // a fifo overflow has lost a word this period, which the witness only sees at the next
+    bool const overflowed = (adc_hw->fcs & ADC_FCS_OVER_BITS) != 0u;
+    if (m_remaining != words.size() || overflowed) {
+        realign();
+        return m_lastSample;
+    }
+    if (period == m_outOfStep) return m_lastSample;
+    m_outOfStep.reset();
+
+    std::array<uint32_t, 3> raw{};
+    for (size_t i = 0u; i < raw.size(); ++i) raw[i] = words[m_slots[i]];
+    m_lastSample = convert(raw, period);
+    return m_lastSample;
+}
+
+// between periods, once the conversion the stop landed in is done, nothing reaches the fifo until
+// the next start, so the data channel can be started again on an empty fifo. in a period it is
+// left for the next tick
+void Motors::CurrentSensor::realign() {
+    if ((adc_hw->cs & ADC_CS_START_MANY_BITS) != 0u) return;
+    while ((adc_hw->cs & ADC_CS_READY_BITS) == 0u) tight_loop_contents();
+
+    adc_fifo_drain();
+    hw_set_bits(&adc_hw->fcs, ADC_FCS_OVER_BITS | ADC_FCS_UNDER_BITS);
+    // what was published before the restart was out of step, and until the next period the
+    // witness still holds what it saw at the start of this one
+    m_outOfStep = SnapshotDma::restart(m_snapshot, m_channels);
+    m_remaining = 3u;
+}
+
+Motors::CurrentSensor::Sample Motors::CurrentSensor::convert(std::array<uint32_t, 3> const& raw,
+                                                             uint8_t period) const {
+    return { Vec2{ static_cast<float>(raw[0]) * 3.3f / 4095.0f * 5.0f,
+                   static_cast<float>(raw[1]) * 3.3f / 4095.0f * 5.0f } -
+                 m_bias,
+             static_cast<float>(raw[2]) * 3.3f / 4095.0f / Drivers::Battery::DIVIDER_VALUE,
+             period };
 }
 
 Motors::Motors(uint leftIn1Pin, uint leftIn2Pin, uint rightIn1Pin, uint rightIn2Pin,
-               uint leftCurrentPin, uint rightCurrentPin)
+               uint leftCurrentPin, uint rightCurrentPin, uint voltagePin)
     : m_left{ leftIn1Pin, leftIn2Pin },
       m_right{ rightIn1Pin, rightIn2Pin },
-      m_currentSensor{ leftCurrentPin, rightCurrentPin } {}
+      m_currentSensor{ leftCurrentPin, rightCurrentPin, voltagePin } {
+    // on one write, so every slice counts from the same edge and the pacing slices wrap where
+    // the sensor set them to against the motor periods
+    hw_set_bits(&pwm_hw->en,
+                m_left.sliceMask() | m_right.sliceMask() | m_currentSensor.sampleSlices());
+}
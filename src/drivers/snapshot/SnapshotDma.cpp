@@ -0,0 +1,76 @@
+#include "drivers/SnapshotDma.hpp"
+
+#include "hardware/dma.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// the sequence channel walks this in a ring and never writes it, so every snapshot shares it. kept
+// out of flash so the dma never waits on xip
+alignas(256) static std::array<uint8_t, 256> sequenceNumbers = []() {
+    std::array<uint8_t, 256> numbers{};
+    for (size_t i = 0u; i < numbers.size(); ++i) numbers[i] = static_cast<uint8_t>(i);
+    return numbers;
+}();
+
+SnapshotDma::Channels SnapshotDma::start(uint32_t volatile* firstBuffer,
+                                         uint32_t volatile* const* addresses,
+                                         uint8_t volatile* sequence, size_t words,
+                                         void const volatile* source, uint dreq) {
+    uint const dataChannel = dma_claim_unused_channel(true);
+    uint const sequenceChannel = dma_claim_unused_channel(true);
+    uint const selectChannel = dma_claim_unused_channel(true);
+
+    auto dataConfig = dma_channel_get_default_config(dataChannel);
+    channel_config_set_chain_to(&dataConfig, sequenceChannel);
+    channel_config_set_read_increment(&dataConfig, false);
+    channel_config_set_write_increment(&dataConfig, true);
+    channel_config_set_dreq(&dataConfig, dreq);
+
+    auto sequenceConfig = dma_channel_get_default_config(sequenceChannel);
+    channel_config_set_chain_to(&sequenceConfig, selectChannel);
+    channel_config_set_transfer_data_size(&sequenceConfig, DMA_SIZE_8);
+    channel_config_set_read_increment(&sequenceConfig, true);
+    channel_config_set_write_increment(&sequenceConfig, false);
+    channel_config_set_ring(&sequenceConfig, false, std::bit_width(sequenceNumbers.size()) - 1u);
+
+    auto selectConfig = dma_channel_get_default_config(selectChannel);
+    channel_config_set_read_increment(&selectConfig, true);
+    channel_config_set_write_increment(&selectConfig, false);
+    channel_config_set_ring(&selectConfig, false,
+                            std::bit_width(2u * sizeof(uint32_t volatile*)) - 1u);
+
+    // the first sample goes to buffer 0, so the select channel starts on the address of buffer 1
+    dma_channel_configure(selectChannel, &selectConfig,
+                          &dma_hw->ch[dataChannel].al2_write_addr_trig, &addresses[1],
+                          dma_encode_transfer_count(1u), false);
+    dma_channel_configure(sequenceChannel, &sequenceConfig, sequence, sequenceNumbers.data(),
+                          dma_encode_transfer_count(1u), false);
+    dma_channel_configure(dataChannel, &dataConfig, firstBuffer, source,
+                          dma_encode_transfer_count(words), true);
+
+    return { dataChannel, sequenceChannel, selectChannel };
+}
+
+uint8_t SnapshotDma::restart(Channels const& channels, uint32_t volatile* const* addresses,
+                             uint8_t volatile const* sequence, size_t words) {
+    // an aborted channel can still trigger its chain, so the data channel chains to itself until
+    // it runs again
+    auto dataConfig = dma_get_channel_config(channels.data);
+    channel_config_set_chain_to(&dataConfig, channels.data);
+    dma_channel_set_config(channels.data, &dataConfig, false);
+    dma_channel_abort(channels.data);
+
+    // with the data channel stopped the sequence holds still. the sample under way goes to the
+    // buffer it does not name, and the select channel reads the address of the named one next
+    uint8_t const published = *sequence;
+    dma_channel_set_read_addr(channels.select, &addresses[published & 1u], false);
+
+    channel_config_set_chain_to(&dataConfig, channels.sequence);
+    dma_channel_set_config(channels.data, &dataConfig, false);
+    dma_channel_set_write_addr(channels.data, addresses[(published + 1u) & 1u], false);
+    dma_channel_set_transfer_count(channels.data, dma_encode_transfer_count(words), true);
+    return published;
+}
@@ -7,7 +7,8 @@ void Time::reset() {
     m_elapsedTime = 0.0f;
 }
 
-void Time::update() {
-    uint32_t const currentTime = time_us_32();
+void Time::update() { update(time_us_32()); }
+
+void Time::update(uint32_t currentTime) {
     m_elapsedTime = static_cast<float>(currentTime - m_startTime) * 1.0e-6f;
 }
@@ -2,15 +2,11 @@
 
 #include "filters/LagFilter.hpp"
 
-#include "Constants.hpp"
-
-#include <cmath>
+#include "dsp/Kernels.hpp"
 
 LagFilter::LagFilter(float k) : m_k{ k } {}
 
 float LagFilter::update(float input) {
-    float const output = m_k * input + (1.0f - m_k) * m_prevOutput;
-    m_prevOutput = output;
-
-    return output;
+    m_prevOutput = Dsp::lerp(m_prevOutput, input, m_k);
+    return m_prevOutput;
 }
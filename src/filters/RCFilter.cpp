@@ -2,15 +2,13 @@
 
 #include "Constants.hpp"
 
+#include "dsp/Kernels.hpp"
+
 static constexpr float K = 1.0f / 2.0f * Constants::PI;
 
-RCFilter::RCFilter(float cutoff, float dt)
-    : m_coefficient1{ dt / (dt + (K / cutoff)) },
-      m_coefficient2{ (K / cutoff) / (dt + (K / cutoff)) } {}
+RCFilter::RCFilter(float cutoff, float dt) : m_alpha{ dt / (dt + (K / cutoff)) } {}
 
 float RCFilter::update(float input) {
-    float const output = m_coefficient1 * input + m_coefficient2 * m_prevOutput;
-    m_prevOutput = output;
-
-    return output;
+    m_prevOutput = Dsp::lerp(m_prevOutput, input, m_alpha);
+    return m_prevOutput;
 }
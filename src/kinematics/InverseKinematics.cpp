@@ -2,7 +2,9 @@
 
 #include "Constants.hpp"
 
+#include "profiles/Robot.hpp"
+
 Vec2 InverseKinematics::update(float linearVelocity, float angularVelocity) {
-    float const edgeVelocity = angularVelocity * Chassis::AXLE_LENGTH / 2.0f;
+    float const edgeVelocity = angularVelocity * Robot::Chassis::AXLE_LENGTH / 2.0f;
     return { linearVelocity + edgeVelocity, linearVelocity - edgeVelocity };
 }
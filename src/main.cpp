@@ -1,5 +1,8 @@
 #include "Constants.hpp"
 
+#include "comms/CommandChannel.hpp"
+#include "comms/UsbTransport.hpp"
+
 #include "drivers/Battery.hpp"
 #include "drivers/Button.hpp"
 #include "drivers/Compass.hpp"
@@ -7,180 +10,350 @@
 #include "drivers/Gyroscope.hpp"
 #include "drivers/LedRGB.hpp"
 #include "drivers/Motors.hpp"
+#include "drivers/SensorConversion.hpp"
 #include "drivers/Time.hpp"
 
-#include "filters/RCFilter.hpp"
-
-#include "fusion/Fusion.hpp"
-
 #include "kinematics/ForwardKinematics.hpp"
 
-#include "managers/Follower.hpp"
+#include "loops/FastLoop.hpp"
+#include "loops/SlowLoop.hpp"
 
 #include "path/Competition.hpp"
+#include "path/Route.hpp"
+
+#include "profiling/StageTimer.hpp"
+#include "profiling/Stages.hpp"
+
+#include "recording/Recorder.hpp"
+#include "recording/Recording.hpp"
+
+#include "scheduling/Scheduler.hpp"
+#include "scheduling/Tasks.hpp"
+
+#include "startup/Startup.hpp"
 
-#include "regulators/CurrentRegulator.hpp"
-#include "regulators/VelocityRegulator.hpp"
+#include "storage/LogStore.hpp"
+#include "storage/PicoFlash.hpp"
+#include "storage/RouteRecord.hpp"
+
+#include "telemetry/Telemetry.hpp"
+#include "telemetry/TelemetryStream.hpp"
+
+#include "tuning/Parameters.hpp"
 
-#include "hardware/irq.h"
 #include "hardware/timer.h"
 
+#include "pico/flash.h"
 #include "pico/multicore.h"
 #include "pico/stdlib.h"
 #include "pico/time.h"
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <optional>
+#include <utility>
+
+// captureTime is when core1 read the sensors behind the state, so core0 can predict it forward to
+// its own tick. the fast loop count lets a recorded slow sample name the exact state it acted on
+struct PublishedState {
+    ForwardKinematics::State state{};
+    uint32_t captureTime{};
+    uint32_t fastCount{};
+};
 
-static std::atomic<ForwardKinematics::State> atomicForwardKinematicsState{};
+static std::atomic<PublishedState> atomicPublishedState{};
 
-enum CoreStatus : uint8_t {
-    INITIALIZING = 0u,
-    INITIALIZED = 1u,
-    CALIBRATING = 2u,
-    CALIBRATED = 3u,
-    STARTING = 4u,
-    RUNNING = 5u,
-    FINISHED = 6u,
-};
-static CoreStatus volatile core0Status = INITIALIZING;
-static CoreStatus volatile core1Status = INITIALIZING;
+static Route route{ Competition::COMMANDS, Competition::TARGET_TIME };
+static UsbTransport usbTransport{};
+static Startup startup{};
+static Recorder recorder{};
+static Scheduler scheduler{ Tasks::TABLE };
+static Stages::Profile profile{};
+static CommandChannel commandChannel{ usbTransport, route, startup, recorder, profile };
+static TelemetryStream telemetry{ usbTransport };
+
+static PicoFlash flash{};
+static LogStore<PicoFlash> store{ flash };
+
+// flash is only touched from core0, core1 gets the cached calibration and hands back a new one
+static std::optional<Gyroscope::Calibration> cachedCalibration{};
+static std::optional<Gyroscope::Calibration> newCalibration{};
+
+using Phase = Startup::Phase;
 
 void core0() {
+    startup.begin(Phase::CORE0_DRIVERS);
+
     Button button{ Pins::BUTTON };
     LedRGB ledRGB{ Pins::LedRGB::RED, Pins::LedRGB::GREEN, Pins::LedRGB::BLUE };
 
-    CurrentRegulator currentRegulator{};
-    VelocityRegulator velocityRegulator{ Integration::SLOW_LOOP_DT };
-    Follower follower{ Competition::PATH, Competition::TARGET_TIMES, Integration::SLOW_LOOP_DT };
-    
-    core0Status = INITIALIZED;
-    while (core1Status < INITIALIZED) tight_loop_contents();
+    uint16_t const builtInFingerprint = RouteRecord::fingerprint(route);
+    RouteRecord::load(store, route, builtInFingerprint);
+    cachedCalibration = store.load<Gyroscope::Calibration>(RecordType::CALIBRATION, 0u);
+    if (auto const record = store.load<Parameters::Record>(RecordType::TUNING, 0u))
+        Parameters::load(*record);
 
-    ledRGB.setRGB(Status::READY_FOR_MOTIONLESS_CALIBRATION);
-    button.waitForClick();
-    ledRGB.setRGB(Status::MOTIONLESS_CALIBRATING);
-    core0Status = CALIBRATING;
+    // flash work only happens here, while nothing is being controlled
+    auto const serviceCommands = [&]() {
+        commandChannel.poll();
 
+        if (commandChannel.takeRouteChanged()) RouteRecord::save(store, route, builtInFingerprint);
+        else if (commandChannel.takeParametersChanged())
+            store.store(RecordType::TUNING, 0u, Parameters::record());
+        else if (store.needsGarbageCollection()) store.collectGarbage();
+    };
+
+    startup.complete(Phase::CORE0_DRIVERS);
+
+    // the adc samples behind these only need the motors idle, not the robot still, so they run
+    // while core1 sets up the gyroscope instead of after the click. the battery goes first since
+    // the current sensor keeps the adc running
+    startup.begin(Phase::BATTERY);
     Battery battery{ Pins::Battery::VOLTAGE_SENSE };
+    startup.complete(Phase::BATTERY);
+
+    startup.begin(Phase::MOTORS);
     Motors motors{ Pins::Motors::LEFT_MOTOR_IN1,     Pins::Motors::LEFT_MOTOR_IN2,
                    Pins::Motors::RIGHT_MOTOR_IN1,    Pins::Motors::RIGHT_MOTOR_IN2,
-                   Pins::Motors::LEFT_MOTOR_CURRENT, Pins::Motors::RIGHT_MOTOR_CURRENT };
+                   Pins::Motors::LEFT_MOTOR_CURRENT, Pins::Motors::RIGHT_MOTOR_CURRENT,
+                   Pins::Battery::VOLTAGE_SENSE };
+    startup.complete(Phase::MOTORS);
 
-    core0Status = CALIBRATED;
-    while (core1Status < CALIBRATED) tight_loop_contents();
+    // core1 has to be able to park itself before serviceCommands touches the flash
+    startup.waitFor(Phase::CORE1_DRIVERS);
+
+    ledRGB.setRGB(Status::READY_FOR_MOTIONLESS_CALIBRATION);
+    startup.begin(Phase::CALIBRATION_CLICK);
+    button.waitForClick(serviceCommands);
+    startup.complete(Phase::CALIBRATION_CLICK);
+    ledRGB.setRGB(Status::MOTIONLESS_CALIBRATING);
+
+    // core1 times the gyroscope by counting its interrupts, which a flash write would hold off
+    startup.waitFor(Phase::GYROSCOPE_CALIBRATION, Phase::SAMPLE_PERIOD);
+
+    if (newCalibration) store.store(RecordType::CALIBRATION, 0u, *newCalibration);
 
     ledRGB.setRGB(Status::READY_TO_RUN);
-    button.waitForClick();
+    startup.begin(Phase::RUN_CLICK);
+    button.waitForClick(serviceCommands);
+    startup.complete(Phase::RUN_CLICK);
     ledRGB.setRGB(Status::RUNNING);
-    core0Status = STARTING;
+
+    startup.begin(Phase::RUN_SETUP);
+    commandChannel.lock();
+    recorder.setRoute(route);
+    recorder.setParameters(Parameters::record());
+    SlowLoop slowLoop{ route.path(), route.targetTimes(), Integration::SLOW_LOOP_DT,
+                       Integration::ADAPTIVE_FEEDFORWARD };
+
+    StageTimer stageTimer{ profile };
+    stageTimer.start();
 
     Time time{};
     time.reset();
 
-    core0Status = RUNNING;
+    bool volatile finished = false;
+    size_t slowCount = 0u;
+    startup.complete(Phase::RUN_SETUP);
 
     auto core0Loop = [&]() {
-        auto const state = atomicForwardKinematicsState.load(std::memory_order_relaxed);
-
-        time.update();
-        Vec2 const targetSpeeds = follower.update(state, time.elapsed());
-
-        velocityRegulator.setTargets(targetSpeeds.x, targetSpeeds.y);
-        Vec2 const targetVoltages = velocityRegulator.update(
-            state.velocity, state.angle, state.angularVelocity, battery.voltage());
-
-        currentRegulator.setTargetVoltage(targetVoltages);
-        Vec2 const motorVoltages = currentRegulator.update(state.wheelSpeeds, battery.voltage());
-        motors.spin(static_cast<int>(motorVoltages.x), static_cast<int>(motorVoltages.y));
-
-        if (follower.finished()) {
-            core0Status = FINISHED;
+        auto const published = stageTimer(Stages::STATE_LOAD, [] {
+            return atomicPublishedState.load(std::memory_order_relaxed);
+        });
+
+        // taken after the load so the state can never be from the future
+        uint32_t const now = time_us_32();
+        float const stateAge = static_cast<float>(now - published.captureTime) * 1.0e-6f;
+
+        // read once so both regulators and the recording see the same voltage, from the same
+        // round robin as the currents. the current is the motors' at the duty cycles the last
+        // tick set, which is what the pack gave them
+        auto const currentSample = motors.currentSample();
+        float const batteryVoltage = Integration::BATTERY_SAG_MODEL ? currentSample.voltage
+                                                                    : battery.voltage();
+        float const batteryCurrent = SensorConversion::batteryCurrent(motors.power(),
+                                                                      currentSample.currents);
+
+        time.update(now);
+        Vec2 const motorVoltages = slowLoop.update(published.state, stateAge, time.elapsed(),
+                                                   batteryVoltage, batteryCurrent, stageTimer);
+        stageTimer(Stages::MOTORS, [&] {
+            motors.spin(static_cast<int>(motorVoltages.x), static_cast<int>(motorVoltages.y));
+        });
+
+        stageTimer(Stages::SLOW_RECORDING, [&] {
+            recorder.recordSlow(
+                { published.fastCount, stateAge, time.elapsed(), batteryVoltage, batteryCurrent,
+                  motorVoltages });
+
+            if (slowCount++ % Telemetry::DECIMATION != 0u) return;
+            // index and dropped are stamped by the stream
+            ForwardKinematics::State const& state = published.state;
+            telemetry.push({ 0u, 0u, time.elapsed(), state.position, state.velocity, state.angle,
+                             state.angularVelocity, slowLoop.targetSpeeds(),
+                             slowLoop.targetVoltages(),
+                             static_cast<uint16_t>(slowLoop.segment()) });
+        });
+
+        if (slowLoop.finished()) {
+            finished = true;
             return false;
         }
         return true;
     };
 
-    auto thunk = [](repeating_timer_t* timer) {
-        return (*static_cast<decltype(core0Loop)*>(timer->user_data))();
-    };
-
-    alarm_pool_t* core0AlarmPool = alarm_pool_create_with_unused_hardware_alarm(1u);
-    irq_set_priority(hardware_alarm_get_irq_num(alarm_pool_hardware_alarm_num(core0AlarmPool)),
-                     0b11110000);
+    scheduler.bind(Tasks::SLOW_LOOP, core0Loop);
+    scheduler.start(0u);
 
-    repeating_timer_t timer{};
-    alarm_pool_add_repeating_timer_us(core0AlarmPool, -Integration::SLOW_LOOP_US, thunk, &core0Loop,
-                                      &timer);
-
-    while (core0Status < FINISHED) tight_loop_contents();
+    // the telemetry is streamed from thread mode, below every interrupt, so neither loop can ever
+    // wait on the link
+    while (!finished) telemetry.drain();
 
     motors.spin(0.0f);
     ledRGB.setRGB(Status::FINISHED);
+    recorder.finish();
 
     float const finalTime = time.elapsed();
-    sleep_ms(static_cast<uint32_t>(Integration::FINAL_STATE_MEASUREMENT_DELAY * 1000.0f));
+    absolute_time_t const measured = make_timeout_time_ms(
+        static_cast<uint32_t>(Integration::FINAL_STATE_MEASUREMENT_DELAY * 1000.0f));
+    while (!time_reached(measured)) telemetry.drain();
 
-    auto const& finalState = atomicForwardKinematicsState.load(std::memory_order_relaxed);
+    auto const& finalState = atomicPublishedState.load(std::memory_order_relaxed).state;
     Vec2 const finalPosition = finalState.position;
     float const finalAngle = finalState.angle;
 
+    // the next run starts from whatever feedforward this one settled on
+    if (auto const& estimator = slowLoop.feedforwardEstimator(); estimator && estimator->store())
+        store.store(RecordType::TUNING, 0u, Parameters::record());
+
     if (Competition::FAIL_RUN) {
         sleep_ms(static_cast<uint32_t>(Track::FAILED_RUN_DELAY * 1000.0f));
         motors.spin(-static_cast<int>(Track::FAILED_RUN_MOTOR_SPEED * Drivers::Motors::MAX_POWER),
                     static_cast<int>(Track::FAILED_RUN_MOTOR_SPEED * Drivers::Motors::MAX_POWER));
     }
 
+    // the recording is downloaded from here, so the channel is polled between reports
+    absolute_time_t nextReport = get_absolute_time();
     while (true) {
+        commandChannel.poll();
+        if (!time_reached(nextReport)) continue;
+
         std::printf("Finished with position (%.5f, %.5f), angle %.5f, and time %.5f.\n",
                     finalPosition.x, finalPosition.y, finalAngle, finalTime);
-        sleep_ms(1000);
+        std::printf("  telemetry: %lu samples sent, %lu dropped\n",
+                    static_cast<unsigned long>(telemetry.sent()),
+                    static_cast<unsigned long>(telemetry.dropped()));
+
+        for (size_t id = 0u; id < Tasks::COUNT; ++id) {
+            TaskSpec const& spec = scheduler.spec(id);
+            TaskStats const& stats = scheduler.stats(id);
+            std::printf("  %.*s: %lu runs, %lu overruns, max late %lu us, max run %lu us, load "
+                        "%.1f%%\n",
+                        static_cast<int>(spec.name.size()), spec.name.data(),
+                        static_cast<unsigned long>(stats.runs),
+                        static_cast<unsigned long>(stats.overruns),
+                        static_cast<unsigned long>(stats.maxLatenessUs),
+                        static_cast<unsigned long>(stats.maxDurationUs),
+                        stats.load(spec.periodUs) * 100.0f);
+        }
+
+        // the fast loop stages keep counting, core1 runs on after the slow loop stops
+        float const cyclesPerUs = static_cast<float>(profile.frequency) * 1.0e-6f;
+        for (size_t id = 0u; Integration::PROFILE_STAGES && id < Stages::COUNT; ++id) {
+            Stages::Info const& info = Stages::TABLE[id];
+            Stages::Stats const& stats = profile.stats[id];
+            std::printf("  core%u %.*s: %lu runs, min %lu, mean %.0f, max %lu cycles (mean %.2f "
+                        "us)\n",
+                        static_cast<unsigned>(info.core), static_cast<int>(info.name.size()),
+                        info.name.data(), static_cast<unsigned long>(stats.runs),
+                        static_cast<unsigned long>(stats.minCycles), stats.meanCycles(),
+                        static_cast<unsigned long>(stats.maxCycles),
+                        stats.meanCycles() / cyclesPerUs);
+        }
+        nextReport = make_timeout_time_ms(1000);
     }
 }
 
 void core1() {
+    startup.begin(Phase::CORE1_DRIVERS);
+    flash_safe_execute_core_init();
+
     Encoders encoders{ pio0, Pins::Encoders::CS_LEFT, Pins::Encoders::CS_RIGHT, Pins::Encoders::SCK,
                        Pins::Encoders::MISO };
-    Fusion fusion{ Integration::FAST_LOOP_DT };
-
-    core1Status = INITIALIZED;
-    while (core0Status < CALIBRATING) tight_loop_contents();
-    core1Status = CALIBRATING;
+    startup.complete(Phase::CORE1_DRIVERS);
 
-    sleep_ms(static_cast<uint32_t>(Integration::CALIBRATION_DELAY * 1000.0f));
-
-    ForwardKinematics forwardKinematics{ encoders.data(), Integration::FAST_LOOP_DT };
+    // register setup and the sensor start up time do not need the robot to be still
+    startup.begin(Phase::GYROSCOPE_SETUP);
     Gyroscope gyroscope{ pio0,
                          Pins::Gyroscope::CS,
                          Pins::Gyroscope::SCK,
                          Pins::Gyroscope::MISO,
                          Pins::Gyroscope::MOSI,
                          Pins::Gyroscope::INT };
+    startup.complete(Phase::GYROSCOPE_SETUP);
 
-    core1Status = CALIBRATED;
-    while (core0Status < RUNNING) tight_loop_contents();
+    startup.waitFor(Phase::CORE0_DRIVERS, Phase::CALIBRATION_CLICK);
+    startup.begin(Phase::GYROSCOPE_CALIBRATION);
 
-    auto core1Loop = [&]() {
-        float const angularVelocity = gyroscope.angularVelocity();
-        float const angle = fusion.update(angularVelocity);
+    // the verification doubles as the settling delay, it passes as soon as the robot is still
+    absolute_time_t const settled = make_timeout_time_ms(
+        static_cast<uint32_t>(Integration::CALIBRATION_DELAY * 1000.0f));
 
-        forwardKinematics.update(encoders.data(), angle, angularVelocity);
-        atomicForwardKinematicsState.store(forwardKinematics.state(), std::memory_order_relaxed);
-    };
+    bool verified = false;
+    while (cachedCalibration && !verified && !time_reached(settled))
+        verified = gyroscope.verify(*cachedCalibration);
+
+    if (!verified) {
+        sleep_until(settled);
+        gyroscope.calibrate();
+        newCalibration = gyroscope.calibration();
+    }
+    gyroscope.start();
+    startup.complete(Phase::GYROSCOPE_CALIBRATION);
 
-    auto thunk = [](repeating_timer_t* timer) {
-        (*static_cast<decltype(core1Loop)*>(timer->user_data))();
+    // flash work parks this core with its interrupts masked, so core0 keeps off the flash until
+    // this is done or the samples it coalesced would stretch the period
+    startup.begin(Phase::SAMPLE_PERIOD);
+    float const fastLoopDt = Integration::DATA_READY_FAST_LOOP ? gyroscope.measureSamplePeriod()
+                                                               : Integration::FAST_LOOP_DT;
+    startup.complete(Phase::SAMPLE_PERIOD);
+
+    Encoders::Sample const initialEncoders = encoders.sample();
+    FastLoop fastLoop{ Encoders::data(initialEncoders), fastLoopDt };
+    recorder.begin(fastLoopDt, gyroscope.calibration().bias, gyroscope.calibration().down,
+                   initialEncoders);
+
+    StageTimer stageTimer{ profile };
+    stageTimer.start();
+
+    startup.waitFor(Phase::RUN_SETUP);
+
+    uint32_t fastCount = 0u;
+    auto core1Loop = [&]() {
+        uint32_t const captureTime = time_us_32();
+        auto const [encoderSample, gyroscopeSample] = stageTimer(Stages::SENSORS, [&] {
+            return std::pair{ encoders.sample(), gyroscope.sample() };
+        });
+
+        auto const& state = fastLoop.update(Encoders::data(encoderSample),
+                                            gyroscope.angularVelocity(gyroscopeSample),
+                                            stageTimer);
+        stageTimer(Stages::FAST_RECORDING,
+                   [&] { recorder.recordFast({ encoderSample, gyroscopeSample }); });
+        stageTimer(Stages::PUBLISH, [&] {
+            atomicPublishedState.store({ state, captureTime, ++fastCount },
+                                       std::memory_order_relaxed);
+        });
         return true;
     };
 
-    alarm_pool_t* core1AlarmPool = alarm_pool_create_with_unused_hardware_alarm(1u);
-    irq_set_priority(hardware_alarm_get_irq_num(alarm_pool_hardware_alarm_num(core1AlarmPool)),
-                     0b11110000);
-
-    repeating_timer_t timer{};
-    alarm_pool_add_repeating_timer_us(core1AlarmPool, -Integration::FAST_LOOP_US, thunk, &core1Loop,
-                                      &timer);
+    scheduler.bind(Tasks::FAST_LOOP, core1Loop);
+    if constexpr (Integration::DATA_READY_FAST_LOOP)
+        gyroscope.setSampleCallback([](void*) { scheduler.trigger(Tasks::FAST_LOOP); }, nullptr,
+                                    Tasks::TABLE[Tasks::FAST_LOOP].priority);
+    scheduler.start(1u);
 
     while (true) tight_loop_contents();
 }
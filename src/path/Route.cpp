@@ -0,0 +1,92 @@
+#include "path/Route.hpp"
+
+#include "path/Compiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+bool Route::setCommands(std::span<Compiler::Command const> commands) {
+    if (commands.empty() || commands.size() > CAPACITY) return false;
+    if (!std::ranges::all_of(commands, [](auto const& command) { return isValid(command); }))
+        return false;
+
+    std::copy(commands.begin(), commands.end(), m_commands.begin());
+    m_size = commands.size();
+
+    compile();
+    return true;
+}
+
+bool Route::setTargetTime(float targetTime) {
+    if (!isValid(targetTime)) return false;
+
+    m_targetTime = targetTime;
+
+    compile();
+    return true;
+}
+
+bool Route::setIfFeasible(std::array<Compiler::Command, CAPACITY>& commands, size_t size,
+                          float targetTime) {
+    if (size == 0u || size > CAPACITY || !isValid(targetTime)) return false;
+    if (!std::all_of(commands.begin(), commands.begin() + size,
+                     [](auto const& command) { return isValid(command); }))
+        return false;
+
+    size_t const previousSize = m_size;
+    float const previousTargetTime = m_targetTime;
+    auto const exchange = [&]() {
+        size_t const count = std::max(size, previousSize);
+        std::swap_ranges(commands.begin(), commands.begin() + count, m_commands.begin());
+    };
+
+    exchange();
+    m_size = size;
+    m_targetTime = targetTime;
+    compile();
+    if (feasible()) return true;
+
+    exchange();
+    m_size = previousSize;
+    m_targetTime = previousTargetTime;
+    compile();
+    return false;
+}
+
+bool Route::setTargetTimeIfFeasible(float targetTime) {
+    float const previousTargetTime = m_targetTime;
+    if (!setTargetTime(targetTime)) return false;
+    if (feasible()) return true;
+
+    setTargetTime(previousTargetTime);
+    return false;
+}
+
+bool Route::feasible() const {
+    using namespace Compiler::Feasibility;
+
+    // a route with no length to share the time out over divides by zero, which the checks below
+    // would let through since nan compares false
+    return std::ranges::all_of(targetTimes(), [](float time) { return std::isfinite(time); }) &&
+           hasTimeToDrive(path(), targetTimes(), turnTimes()) &&
+           canStopInTime(path(), targetTimes(), turnTimes()) &&
+           withinMaxSpeed(path(), targetTimes(), turnTimes());
+}
+
+bool Route::isValid(Compiler::Command const& command) {
+    return std::isfinite(command.amount.x) && std::isfinite(command.amount.y) &&
+           std::isfinite(command.offset.x) && std::isfinite(command.offset.y) &&
+           std::isfinite(command.units) && (!command.targetTime || isValid(*command.targetTime));
+}
+
+bool Route::isValid(float targetTime) { return std::isfinite(targetTime) && targetTime > 0.0f; }
+
+void Route::compile() {
+    // the compiler writes straight into the members so nothing route sized lands on the stack
+    Compiler::compile(m_commands, m_path, m_size);
+    Compiler::TargetTime::getTurnTimes(m_path, m_turnTimes, m_size);
+    Compiler::getTargetTimes(m_commands, m_path, m_turnTimes, m_targetTime, m_targetTimes, m_size);
+}
@@ -0,0 +1,19 @@
+#include "startup/Startup.hpp"
+
+#include "hardware/timer.h"
+
+#include "pico/stdlib.h"
+
+#include <atomic>
+#include <cstdint>
+
+void Startup::begin(Phase phase) {
+    m_timings[static_cast<size_t>(phase)].start = time_us_32();
+}
+
+void Startup::complete(Phase phase) {
+    m_timings[static_cast<size_t>(phase)].end = time_us_32();
+    m_completed.fetch_or(bit(phase), std::memory_order_release);
+}
+
+void Startup::idle() { tight_loop_contents(); }
@@ -0,0 +1,59 @@
+#include "storage/PicoFlash.hpp"
+
+#include "Constants.hpp"
+
+#include "hardware/flash.h"
+
+#include "pico/flash.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+static_assert(Storage::PAGE_SIZE == FLASH_PAGE_SIZE);
+static_assert(Storage::SECTOR_SIZE == FLASH_SECTOR_SIZE);
+static_assert(Storage::REGION_SIZE <= PICO_FLASH_SIZE_BYTES);
+
+struct Operation {
+    uint32_t offset{};
+    uint8_t const* data{};
+    size_t size{};
+};
+
+static void programOperation(void* parameter) {
+    auto const& operation = *static_cast<Operation const*>(parameter);
+    flash_range_program(operation.offset, operation.data, operation.size);
+}
+
+static void eraseOperation(void* parameter) {
+    auto const& operation = *static_cast<Operation const*>(parameter);
+    flash_range_erase(operation.offset, operation.size);
+}
+
+PicoFlash::PicoFlash() : m_regionOffset{ PICO_FLASH_SIZE_BYTES - Storage::REGION_SIZE } {}
+
+bool PicoFlash::read(uint32_t offset, std::span<uint8_t> output) {
+    if (offset + output.size() > size()) return false;
+
+    uint8_t const* const start = reinterpret_cast<uint8_t const*>(XIP_BASE + m_regionOffset +
+                                                                  offset);
+    std::copy(start, start + output.size(), output.begin());
+    return true;
+}
+
+bool PicoFlash::program(uint32_t offset, std::span<uint8_t const> input) {
+    if (offset % Storage::PAGE_SIZE != 0u || input.size() % Storage::PAGE_SIZE != 0u ||
+        offset + input.size() > size())
+        return false;
+
+    Operation operation{ m_regionOffset + offset, input.data(), input.size() };
+    return flash_safe_execute(programOperation, &operation, Storage::LOCKOUT_TIMEOUT_MS) == PICO_OK;
+}
+
+bool PicoFlash::erase(uint32_t offset) {
+    if (offset % Storage::SECTOR_SIZE != 0u || offset + Storage::SECTOR_SIZE > size()) return false;
+
+    Operation operation{ m_regionOffset + offset, nullptr, Storage::SECTOR_SIZE };
+    return flash_safe_execute(eraseOperation, &operation, Storage::LOCKOUT_TIMEOUT_MS) == PICO_OK;
+}
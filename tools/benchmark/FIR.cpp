@@ -0,0 +1,158 @@
+#include "dsp/Kernels.hpp"
+
+#include "filters/FIRDesign.hpp"
+#include "filters/FIRFilter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    constexpr size_t DEFAULT_REPEATS = 5u;
+    constexpr size_t SAMPLES = 1u << 18u;
+
+    // what the taps are makes no difference to the timing, a low pass at the fast loop's rate
+    constexpr double CUTOFF = 100.0;
+    constexpr double SAMPLE_RATE = 3200.0;
+
+    // FIRFilter as it was before the mirrored delay line, kept as the baseline: a ring of N
+    // samples walked back from the newest with a decrement and a wrap on every tap
+    template <size_t N>
+    class RingFIRFilter {
+    public:
+        constexpr RingFIRFilter(std::array<float, N> const& impulseResponse)
+            : m_impulseResponse{ impulseResponse } {}
+
+        float update(float input) {
+            m_buffer[m_bufferIndex] = input;
+
+            ++m_bufferIndex;
+            m_bufferIndex %= N;
+
+            float output = 0.0f;
+            size_t sumIndex = m_bufferIndex;
+            for (size_t i = 0; i < N; ++i) {
+                if (sumIndex > 0) sumIndex--;
+                else sumIndex = N - 1;
+
+                output = Dsp::mac(output, m_impulseResponse[i], m_buffer[sumIndex]);
+            }
+
+            return output;
+        }
+
+    private:
+        std::array<float, N> m_impulseResponse{};
+        std::array<float, N> m_buffer{};
+        size_t m_bufferIndex{ 0u };
+    };
+
+    // the fastest of a few runs in ns a sample, a filter is only ever slowed down by the rest of
+    // the machine. every output goes through a volatile so none of the work can be dropped
+    template <typename Filter>
+    double measure(Filter filter, std::vector<float> const& input, size_t repeats) {
+        std::optional<double> best{};
+        for (size_t i = 0u; i < repeats; ++i) {
+            float volatile output = 0.0f;
+            auto const start = std::chrono::steady_clock::now();
+            for (float sample : input) output = filter.update(sample);
+            static_cast<void>(output);
+
+            double const elapsed = std::chrono::duration<double, std::nano>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count() /
+                                   static_cast<double>(input.size());
+            best = std::min(best.value_or(elapsed), elapsed);
+        }
+        return *best;
+    }
+
+    struct Row {
+        size_t taps{};
+        double ring{};
+        double mirrored{};
+        float difference{};
+        float tolerance{};
+    };
+
+    template <size_t N>
+    Row run(std::vector<float> const& input, size_t repeats) {
+        constexpr std::array<float, N> impulseResponse = FIRDesign::lowPass<N>(CUTOFF,
+                                                                               SAMPLE_RATE);
+
+        // the two only sum the taps in opposite orders, so on inputs within one they can differ
+        // by a rounding of every partial sum at most
+        RingFIRFilter<N> ring{ impulseResponse };
+        FIRFilter<N> mirrored{ impulseResponse };
+        float difference = 0.0f;
+        for (float sample : input)
+            difference = std::max(difference, std::fabs(ring.update(sample) -
+                                                        mirrored.update(sample)));
+
+        float gain = 0.0f;
+        for (float tap : impulseResponse) gain += std::fabs(tap);
+        float const tolerance = 2.0f * static_cast<float>(N) *
+                                std::numeric_limits<float>::epsilon() * gain;
+
+        return { N, measure(RingFIRFilter<N>{ impulseResponse }, input, repeats),
+                 measure(FIRFilter<N>{ impulseResponse }, input, repeats), difference,
+                 tolerance };
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-benchmark-fir [--repeats <n>]\n"
+                     "\n"
+                     "times FIRFilter against the ring buffer it replaced from 8 to 64 taps, the "
+                     "fastest\nof {} runs over {} samples by default, and fails if the two filters "
+                     "disagree by\nmore than summing the taps in a different order can explain",
+                     DEFAULT_REPEATS, SAMPLES);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    size_t repeats = DEFAULT_REPEATS;
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        if (argument == "--repeats" && i + 1u < arguments.size())
+            repeats = std::stoul(arguments[++i]);
+        if (argument != "--repeats" || repeats == 0u) {
+            usage();
+            return 1;
+        }
+    }
+
+    std::mt19937 random{ 1u };
+    std::uniform_real_distribution<float> uniform{ -1.0f, 1.0f };
+    std::vector<float> input(SAMPLES);
+    for (float& sample : input) sample = uniform(random);
+
+    std::array<Row, 6> const rows{ run<8>(input, repeats),  run<16>(input, repeats),
+                                   run<24>(input, repeats), run<32>(input, repeats),
+                                   run<48>(input, repeats), run<64>(input, repeats) };
+
+    bool passed = true;
+    std::println("{:>4} {:>10} {:>10} {:>8} {:>11}", "taps", "ring", "mirrored", "speedup",
+                 "difference");
+    for (Row const& row : rows) {
+        std::println("{:>4} {:>7.2f} ns {:>7.2f} ns {:>7.2f}x {:>11.2g}", row.taps, row.ring,
+                     row.mirrored, row.ring / row.mirrored, row.difference);
+        passed = passed && row.difference <= row.tolerance;
+    }
+
+    if (!passed) std::println(stderr, "the filters disagree by more than rounding");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+// compiled, never linked, by rotour-benchmark with -DROUTE_LENGTH=N. everything the firmware
+// works out for Competition::COMMANDS is worked out here at compile time for a route of N
+// commands, so the compiler's time is the cost of the constexpr pipeline
+
+#include "path/Compiler.hpp"
+#include "path/Path.hpp"
+
+#include "state/Vector.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef ROUTE_LENGTH
+#define ROUTE_LENGTH 128
+#endif
+
+namespace {
+    using namespace Compiler::Tokens;
+
+    constexpr size_t N = ROUTE_LENGTH;
+
+    // moves in every direction, with reverses and fixed times mixed in. nothing repeats, so the
+    // compiler cannot reuse one evaluation of the math for another
+    constexpr std::array<Compiler::Command, N> makeCommands() {
+        uint32_t seed = 1u;
+        auto const next = [&seed] {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8u) / 16777216.0f;
+        };
+
+        std::array<Compiler::Command, N> commands{};
+        for (size_t i = 0u; i < N; ++i) {
+            commands[i] = moveby({ next() * 4.0f - 2.0f, next() * 4.0f - 2.0f });
+            if (i % 5u == 3u) commands[i] = commands[i] & REVERSE;
+            if (i % 7u == 6u) commands[i] = commands[i] & TIME(6.0f);
+        }
+        return commands;
+    }
+
+    constexpr auto COMMANDS = makeCommands();
+    constexpr auto PATH = Compiler::compile(COMMANDS);
+    constexpr auto TURN_TIMES = Compiler::TargetTime::getTurnTimes(PATH);
+    constexpr auto TARGET_TIMES = Compiler::getTargetTimes(COMMANDS, PATH, 10.0f * N);
+
+    static_assert(Compiler::Feasibility::hasTimeToDrive(PATH, TARGET_TIMES, TURN_TIMES));
+    static_assert(Compiler::Feasibility::canStopInTime(PATH, TARGET_TIMES, TURN_TIMES));
+    static_assert(Compiler::Feasibility::withinMaxSpeed(PATH, TARGET_TIMES, TURN_TIMES));
+}
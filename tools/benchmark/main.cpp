@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    constexpr size_t DEFAULT_REPEATS = 3u;
+    constexpr size_t DEFAULT_LENGTHS[] = { 16u, 32u, 64u, 128u, 256u, 512u, 1024u };
+
+    // the fastest of a few runs, a compile is only ever slowed down by the rest of the machine
+    std::optional<double> measure(std::string const& compiler, size_t length, size_t repeats) {
+        std::string const command = std::format(
+            "\"{}\" -std=c++23 -fsyntax-only -I\"{}\" -DROUTE_LENGTH={} \"{}\"", compiler,
+            BENCHMARK_INCLUDE_DIR, length, BENCHMARK_SOURCE);
+
+        std::optional<double> best{};
+        for (size_t i = 0u; i < repeats; ++i) {
+            auto const start = std::chrono::steady_clock::now();
+            if (std::system(command.c_str()) != 0) return std::nullopt;
+
+            double const elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best.value_or(elapsed), elapsed);
+        }
+        return best;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-benchmark [--compiler <c++>] [--repeats <n>] [<length>...]\n"
+                     "\n"
+                     "times the compiler working out a route of each length at compile time, the\n"
+                     "way Competition::COMMANDS is, and fails if any length does not compile.\n"
+                     "defaults to the compiler the tools were built with and 16 to 1024 commands");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    std::string compiler{ BENCHMARK_COMPILER };
+    size_t repeats = DEFAULT_REPEATS;
+    std::vector<size_t> lengths{};
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        bool const hasValue = i + 1u < arguments.size();
+
+        if (argument == "--compiler" && hasValue) compiler = arguments[++i];
+        else if (argument == "--repeats" && hasValue) repeats = std::stoul(arguments[++i]);
+        else if (argument.starts_with("--") || repeats == 0u) {
+            usage();
+            return 1;
+        } else lengths.push_back(std::stoul(std::string{ argument }));
+    }
+
+    if (lengths.empty()) lengths.assign(std::begin(DEFAULT_LENGTHS), std::end(DEFAULT_LENGTHS));
+
+    // a one command route is the cost of the headers alone
+    auto const baseline = measure(compiler, 1u, repeats);
+    if (!baseline) {
+        std::println(stderr, "{} cannot compile {}", compiler, BENCHMARK_SOURCE);
+        return 1;
+    }
+
+    std::println("{:>8} {:>10} {:>10} {:>14}", "commands", "compile", "pipeline", "per command");
+    for (size_t length : lengths) {
+        auto const elapsed = measure(compiler, length, repeats);
+        if (!elapsed) {
+            std::println(stderr, "a route of {} commands does not compile", length);
+            return 1;
+        }
+
+        double const pipeline = std::max(*elapsed - *baseline, 0.0);
+        std::println("{:>8} {:>7.0f} ms {:>7.0f} ms {:>11.3f} ms", length, *elapsed * 1000.0,
+                     pipeline * 1000.0, pipeline * 1000.0 / static_cast<double>(length));
+    }
+    return 0;
+}
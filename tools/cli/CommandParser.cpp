@@ -0,0 +1,247 @@
+#include "cli/CommandParser.hpp"
+
+#include "path/Compiler.hpp"
+
+#include "state/Vector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using namespace Compiler::Tokens;
+
+    struct Value {
+        bool isVector{};
+        float scalar{};
+        Vec2 vector{};
+    };
+
+    class Parser {
+    public:
+        Parser(std::string_view source) : m_source{ source } {}
+
+        std::expected<std::vector<Compiler::Command>, std::string> parse() {
+            std::vector<Compiler::Command> commands{};
+
+            skipWhitespace();
+            while (m_position < m_source.size() && !m_error) {
+                auto const command = parseCommand();
+                if (!command) break;
+                commands.push_back(*command);
+
+                skipWhitespace();
+                if (!accept(',')) break;
+                skipWhitespace();
+            }
+
+            skipWhitespace();
+            if (!m_error && m_position < m_source.size()) fail("unexpected input");
+            if (m_error) return std::unexpected{ *m_error };
+            if (commands.empty()) return std::unexpected{ std::string{ "no commands" } };
+
+            return commands;
+        }
+
+    private:
+        std::optional<Compiler::Command> parseCommand() {
+            std::string_view const name = identifier();
+
+            std::optional<Compiler::Command> command{};
+            if (name == "FIRST_MOVE") command = FIRST_MOVE;
+            else if (name == "moveby" || name == "moveto") {
+                auto const amount = parseArgument(true);
+                if (!amount) return std::nullopt;
+                command = name == "moveby" ? moveby(amount->vector) : moveto(amount->vector);
+            } else return fail("expected moveby, moveto or FIRST_MOVE");
+
+            while (accept('&')) {
+                std::string_view const modifier = identifier();
+
+                if (modifier == "REVERSE") command = *command & REVERSE;
+                else if (modifier == "STOP") command = *command & STOP;
+                else if (modifier == "CENTIMETERS") command = *command & CENTIMETERS;
+                else if (modifier == "METERS") command = *command & METERS;
+                else if (modifier == "LAST_MOVE") command = *command & LAST_MOVE;
+                else if (modifier == "TIME") {
+                    auto const time = parseArgument(false);
+                    if (!time) return std::nullopt;
+                    command = *command & TIME(time->scalar);
+                } else if (modifier == "OFFSET_ONCE" || modifier == "OFFSET_ALL") {
+                    auto const offset = parseArgument(true);
+                    if (!offset) return std::nullopt;
+                    command = modifier == "OFFSET_ONCE" ? *command & OFFSET_ONCE(offset->vector)
+                                                        : *command & OFFSET_ALL(offset->vector);
+                } else return fail("unknown modifier");
+            }
+
+            return command;
+        }
+
+        std::optional<Value> parseArgument(bool vector) {
+            if (!accept('(')) return fail("expected (");
+            auto const value = parseExpression();
+            if (!value) return std::nullopt;
+            if (!accept(')')) return fail("expected )");
+            if (value->isVector != vector)
+                return fail(vector ? "expected a vector" : "expected a number");
+            return value;
+        }
+
+        std::optional<Value> parseExpression() {
+            auto left = parseTerm();
+            while (left) {
+                bool const add = accept('+');
+                if (!add && !accept('-')) break;
+
+                auto const right = parseTerm();
+                if (!right) return std::nullopt;
+                if (left->isVector != right->isVector)
+                    return fail("cannot add a number and a vector");
+
+                float const sign = add ? 1.0f : -1.0f;
+                left = Value{ left->isVector, left->scalar + sign * right->scalar,
+                              left->vector + sign * right->vector };
+            }
+            return left;
+        }
+
+        std::optional<Value> parseTerm() {
+            auto left = parseUnary();
+            while (left) {
+                bool const multiply = accept('*');
+                if (!multiply && !accept('/')) break;
+
+                auto const right = parseUnary();
+                if (!right) return std::nullopt;
+                if (right->isVector && (left->isVector || !multiply))
+                    return fail("vectors can only be scaled by numbers");
+
+                if (right->isVector) {
+                    left = Value{ true, 0.0f, left->scalar * right->vector };
+                    continue;
+                }
+
+                float const factor = multiply ? right->scalar : 1.0f / right->scalar;
+                left = Value{ left->isVector, left->scalar * factor, left->vector * factor };
+            }
+            return left;
+        }
+
+        std::optional<Value> parseUnary() {
+            if (!accept('-')) return parsePrimary();
+
+            auto const value = parseUnary();
+            if (!value) return std::nullopt;
+            return Value{ value->isVector, -value->scalar, -1.0f * value->vector };
+        }
+
+        std::optional<Value> parsePrimary() {
+            skipWhitespace();
+            if (m_position >= m_source.size()) return fail("unexpected end of input");
+
+            if (accept('(')) {
+                auto const value = parseExpression();
+                if (!accept(')')) return fail("expected )");
+                return value;
+            }
+
+            char const next = m_source[m_position];
+            if (next == '{') return parseVector();
+            if (std::isdigit(static_cast<unsigned char>(next)) || next == '.') return parseNumber();
+
+            std::string_view const name = identifier();
+            if (name == "Vec2") return parseVector();
+            if (name == "UP") return Value{ true, 0.0f, UP };
+            if (name == "DOWN") return Value{ true, 0.0f, DOWN };
+            if (name == "LEFT") return Value{ true, 0.0f, LEFT };
+            if (name == "RIGHT") return Value{ true, 0.0f, RIGHT };
+            if (name == "SQUARE_SIZE") return Value{ false, SQUARE_SIZE, {} };
+            if (name == "DOWEL_DISTANCE") return Value{ false, DOWEL_DISTANCE, {} };
+            return fail("unknown name");
+        }
+
+        std::optional<Value> parseVector() {
+            if (!accept('{')) return fail("expected {");
+            auto const x = parseExpression();
+            if (!x || !accept(',')) return fail("expected ,");
+            auto const y = parseExpression();
+            if (!y || !accept('}')) return fail("expected }");
+            if (x->isVector || y->isVector) return fail("vector components must be numbers");
+
+            return Value{ true, 0.0f, { x->scalar, y->scalar } };
+        }
+
+        std::optional<Value> parseNumber() {
+            float value{};
+            char const* const begin = m_source.data() + m_position;
+            char const* const last = m_source.data() + m_source.size();
+            auto const [end, error] = std::from_chars(begin, last, value);
+            if (error != std::errc{}) return fail("invalid number");
+
+            m_position += static_cast<size_t>(end - begin);
+            // allow the float suffix so commands can be pasted straight from Competition.hpp
+            if (m_position < m_source.size() && std::tolower(m_source[m_position]) == 'f')
+                ++m_position;
+
+            return Value{ false, value, {} };
+        }
+
+        std::string_view identifier() {
+            skipWhitespace();
+
+            size_t const start = m_position;
+            while (m_position < m_source.size() &&
+                   (std::isalnum(static_cast<unsigned char>(m_source[m_position])) ||
+                    m_source[m_position] == '_'))
+                ++m_position;
+
+            return m_source.substr(start, m_position - start);
+        }
+
+        bool accept(char character) {
+            skipWhitespace();
+            if (m_position >= m_source.size() || m_source[m_position] != character) return false;
+
+            ++m_position;
+            return true;
+        }
+
+        void skipWhitespace() {
+            while (m_position < m_source.size()) {
+                if (std::isspace(static_cast<unsigned char>(m_source[m_position]))) ++m_position;
+                else if (m_source.substr(m_position, 2u) == "//")
+                    m_position = std::min(m_source.find('\n', m_position), m_source.size());
+                else if (m_source.substr(m_position, 2u) == "/*") {
+                    size_t const end = m_source.find("*/", m_position + 2u);
+                    m_position = end == std::string_view::npos ? m_source.size() : end + 2u;
+                }
+                else break;
+            }
+        }
+
+        std::nullopt_t fail(std::string_view message) {
+            if (!m_error) {
+                auto const consumed = m_source.substr(0u, m_position);
+                auto const line = 1 + std::count(consumed.begin(), consumed.end(), '\n');
+                m_error = "line " + std::to_string(line) + ": " + std::string{ message };
+            }
+            return std::nullopt;
+        }
+
+        std::string_view m_source{};
+        size_t m_position{ 0u };
+        std::optional<std::string> m_error{};
+    };
+}
+
+std::expected<std::vector<Compiler::Command>, std::string> CommandParser::parse(
+    std::string_view source) {
+    return Parser{ source }.parse();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "path/Compiler.hpp"
+
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// parses the same token syntax as Competition::COMMANDS, e.g.
+//     FIRST_MOVE, moveby(2 * UP) & REVERSE & TIME(1.5f), moveto({ 1, 3 }) & LAST_MOVE
+// every token applies through Compiler::Tokens so an uploaded route means exactly what it would
+// mean compiled into the firmware
+namespace CommandParser {
+    std::expected<std::vector<Compiler::Command>, std::string> parse(std::string_view source);
+}
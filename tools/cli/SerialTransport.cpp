@@ -0,0 +1,46 @@
+#include "cli/SerialTransport.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+SerialTransport::SerialTransport(std::string const& device)
+    : m_fd{ ::open(device.c_str(), O_RDWR | O_NOCTTY) } {
+    if (m_fd < 0) return;
+
+    termios settings{};
+    tcgetattr(m_fd, &settings);
+    cfmakeraw(&settings);
+    settings.c_cc[VMIN] = 0;
+    settings.c_cc[VTIME] = 0;
+    tcsetattr(m_fd, TCSANOW, &settings);
+    tcflush(m_fd, TCIOFLUSH);
+}
+
+SerialTransport::~SerialTransport() {
+    if (m_fd >= 0) ::close(m_fd);
+}
+
+std::optional<uint8_t> SerialTransport::read() {
+    pollfd descriptor{ m_fd, POLLIN, 0 };
+    if (::poll(&descriptor, 1, 10) <= 0) return std::nullopt;
+
+    uint8_t byte{};
+    if (::read(m_fd, &byte, 1u) != 1) return std::nullopt;
+    return byte;
+}
+
+void SerialTransport::write(std::span<uint8_t const> data) {
+    size_t written = 0u;
+    while (written < data.size()) {
+        ssize_t const result = ::write(m_fd, data.data() + written, data.size() - written);
+        if (result <= 0) return;
+        written += static_cast<size_t>(result);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+class SerialTransport {
+public:
+    SerialTransport(std::string const& device);
+    ~SerialTransport();
+
+    SerialTransport(SerialTransport const&) = delete;
+    SerialTransport& operator=(SerialTransport const&) = delete;
+    SerialTransport(SerialTransport&&) = delete;
+    SerialTransport& operator=(SerialTransport&&) = delete;
+
+    bool isOpen() const { return m_fd >= 0; }
+
+    std::optional<uint8_t> read();
+    void write(std::span<uint8_t const> data);
+
+private:
+    int m_fd{ -1 };
+};
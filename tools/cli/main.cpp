@@ -0,0 +1,504 @@
+#include "Constants.hpp"
+
+#include "cli/CommandParser.hpp"
+#include "cli/SerialTransport.hpp"
+
+#include "comms/CommandChannel.hpp"
+#include "comms/Frame.hpp"
+#include "comms/LoopbackTransport.hpp"
+#include "comms/Protocol.hpp"
+#include "comms/Transport.hpp"
+
+#include "path/Competition.hpp"
+#include "path/Compiler.hpp"
+#include "path/Path.hpp"
+#include "path/Route.hpp"
+
+#include "profiling/Stages.hpp"
+
+#include "recording/Recorder.hpp"
+
+#include "startup/Startup.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <print>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using Protocol::Message;
+
+    constexpr auto REPLY_TIMEOUT = std::chrono::milliseconds{ 1000 };
+
+    struct Reply {
+        Message type{};
+        std::vector<uint8_t> payload{};
+    };
+
+    template <TransportType Transport, typename Idle>
+    class Client {
+    public:
+        Client(Transport& transport, Idle idle) : m_transport{ transport }, m_idle{ idle } {}
+
+        std::optional<Reply> request(Message type, auto const& writeBody) {
+            std::array<uint8_t, Comms::MAX_PAYLOAD_SIZE> payload{};
+            Protocol::Writer writer{ payload };
+            writer.write(static_cast<uint8_t>(type)).write(++m_sequence);
+            writeBody(writer);
+            if (writer.overflowed()) return std::nullopt;
+
+            std::array<uint8_t, Comms::MAX_FRAME_SIZE> frame{};
+            size_t const size = Frame::encode(writer.data(), frame);
+            m_transport.write({ frame.data(), size });
+
+            auto const deadline = std::chrono::steady_clock::now() + REPLY_TIMEOUT;
+            while (std::chrono::steady_clock::now() < deadline) {
+                m_idle();
+
+                while (auto const byte = m_transport.read()) {
+                    auto const received = m_decoder.push(*byte);
+                    if (!received || received->size() < Protocol::HEADER_SIZE) continue;
+                    if ((*received)[1] != m_sequence) continue;
+
+                    return Reply{ static_cast<Message>((*received)[0]),
+                                  { received->begin() + Protocol::HEADER_SIZE, received->end() } };
+                }
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        Transport& m_transport;
+        Idle m_idle;
+
+        Frame::Decoder m_decoder{};
+        uint8_t m_sequence{ 0u };
+    };
+
+    std::string_view describe(Protocol::Error error) {
+        using Protocol::Error;
+
+        switch (error) {
+        case Error::NONE: return "none";
+        case Error::MALFORMED: return "malformed request";
+        case Error::UNKNOWN_MESSAGE: return "unknown message";
+        case Error::OUT_OF_ORDER: return "upload chunk out of order";
+        case Error::TOO_LONG: return "route too long";
+        case Error::INVALID_ROUTE: return "invalid route, or one the robot cannot keep to";
+        case Error::BUSY: return "robot is calibrating or running";
+        case Error::INVALID_PARAMETER: return "unknown parameter or value out of bounds";
+        }
+        return "unknown error";
+    }
+
+    bool expectAck(std::optional<Reply> const& reply) {
+        if (!reply) {
+            std::println(stderr, "no reply");
+            return false;
+        }
+
+        if (reply->type == Message::NACK) {
+            auto const error = reply->payload.empty() ? Protocol::Error::NONE
+                                                      : Protocol::Error{ reply->payload[0] };
+            std::println(stderr, "rejected: {}", describe(error));
+            return false;
+        }
+
+        return reply->type == Message::ACK;
+    }
+
+    template <typename Client>
+    bool ping(Client& client) {
+        auto const start = std::chrono::steady_clock::now();
+        if (!expectAck(client.request(Message::PING, [](Protocol::Writer&) {}))) return false;
+
+        auto const elapsed = std::chrono::steady_clock::now() - start;
+        std::println("pong in {} us",
+                     std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        return true;
+    }
+
+    template <typename Client>
+    bool upload(Client& client, std::string const& filename) {
+        std::ifstream file{ filename };
+        if (!file) {
+            std::println(stderr, "cannot open {}", filename);
+            return false;
+        }
+
+        std::stringstream source{};
+        source << file.rdbuf();
+
+        auto const commands = CommandParser::parse(source.str());
+        if (!commands) {
+            std::println(stderr, "{}: {}", filename, commands.error());
+            return false;
+        }
+        if (commands->size() > Route::CAPACITY) {
+            std::println(stderr, "{}: {} commands, the robot holds at most {}", filename,
+                         commands->size(), Route::CAPACITY);
+            return false;
+        }
+
+        uint16_t const total = static_cast<uint16_t>(commands->size());
+        for (size_t index = 0u; index < commands->size(); index += Protocol::COMMANDS_PER_FRAME) {
+            size_t const end = std::min(commands->size(), index + Protocol::COMMANDS_PER_FRAME);
+
+            auto const writeChunk = [&](Protocol::Writer& writer) {
+                writer.write(static_cast<uint16_t>(index)).write(total);
+                for (size_t i = index; i < end; ++i) writer.write((*commands)[i]);
+            };
+            if (!expectAck(client.request(Message::UPLOAD_COMMANDS, writeChunk))) return false;
+        }
+
+        std::println("uploaded {} commands", total);
+        return true;
+    }
+
+    template <typename Client>
+    bool setTargetTime(Client& client, std::string const& argument) {
+        float const targetTime = std::stof(argument);
+        if (!expectAck(client.request(Message::SET_TARGET_TIME,
+                                      [&](Protocol::Writer& writer) { writer.write(targetTime); })))
+            return false;
+
+        std::println("target time set to {} s", targetTime);
+        return true;
+    }
+
+    // "default" puts the firmware's own value back
+    template <typename Client>
+    bool setParameter(Client& client, std::string_view name, std::string const& argument) {
+        auto const id = Parameters::find(name);
+        if (!id) {
+            std::println(stderr, "unknown parameter {}", name);
+            return false;
+        }
+
+        float const value = argument == "default" ? std::nanf("") : std::stof(argument);
+        auto const request = [&](Protocol::Writer& writer) {
+            writer.write(static_cast<uint8_t>(*id)).write(value);
+        };
+        if (!expectAck(client.request(Message::SET_PARAMETER, request))) return false;
+
+        std::println("{} set to {}", name, argument);
+        return true;
+    }
+
+    template <typename Client>
+    bool parameters(Client& client) {
+        auto const reply = client.request(Message::GET_PARAMETERS, [](Protocol::Writer&) {});
+        if (!reply || reply->type != Message::PARAMETERS) {
+            std::println(stderr, "no parameters");
+            return false;
+        }
+
+        Protocol::Reader reader{ reply->payload };
+        auto const fingerprint = reader.read<uint32_t>();
+        auto const count = reader.read<uint8_t>();
+        if (!count) return false;
+
+        // the names and bounds are this build's, which only describe the robot if the tables match
+        if (*fingerprint != Parameters::fingerprint() || *count != Parameters::COUNT) {
+            std::println(stderr, "the robot has a different parameter table, rebuild rotour-cli");
+            return false;
+        }
+
+        std::println("{:<28} {:>10} {:>10} {:>10} {:>10}", "parameter", "value", "default", "min",
+                     "max");
+        for (Parameters::Info const& info : Parameters::TABLE) {
+            auto const value = reader.read<float>();
+            if (!value) return false;
+
+            std::println("{:<28} {:>10.4g} {:>10.4g} {:>10.4g} {:>10.4g}{}", info.name, *value,
+                         info.defaultValue, info.min, info.max,
+                         *value != info.defaultValue ? " *" : "");
+        }
+
+        return true;
+    }
+
+    template <typename Client>
+    std::optional<Protocol::RouteInfo> getRouteInfo(Client& client) {
+        auto const reply = client.request(Message::GET_ROUTE_INFO, [](Protocol::Writer&) {});
+        if (!reply || reply->type != Message::ROUTE_INFO) {
+            std::println(stderr, "no route info");
+            return std::nullopt;
+        }
+
+        Protocol::Reader reader{ reply->payload };
+        return reader.readRouteInfo();
+    }
+
+    template <typename Client>
+    bool info(Client& client) {
+        auto const routeInfo = getRouteInfo(client);
+        if (!routeInfo) return false;
+
+        Vec2 const destination = routeInfo->destination / Track::SQUARE_SIZE;
+        std::println("{} segments, target time {} s, destination ({}, {}) squares",
+                     routeInfo->size, routeInfo->targetTime, destination.x, destination.y);
+        return true;
+    }
+
+    template <typename Client>
+    bool route(Client& client) {
+        auto const routeInfo = getRouteInfo(client);
+        if (!routeInfo) return false;
+
+        std::println("{:>4} {:>9} {:>9} {:>8} {:>8} {:>7}", "#", "x", "y", "target", "turn",
+                     "flags");
+
+        uint16_t index = 0u;
+        while (index < routeInfo->size) {
+            auto const reply = client.request(Message::GET_ROUTE, [&](Protocol::Writer& writer) {
+                writer.write(index).write(static_cast<uint16_t>(routeInfo->size - index));
+            });
+            if (!reply || reply->type != Message::ROUTE_SEGMENTS) {
+                std::println(stderr, "no route segments");
+                return false;
+            }
+
+            Protocol::Reader reader{ reply->payload };
+            if (reader.read<uint16_t>() != index) return false;
+
+            while (reader.remaining() > 0u) {
+                auto const segment = reader.readSegment();
+                if (!segment) return false;
+
+                std::println("{:>4} {:>9.2f} {:>9.2f} {:>8.3f} {:>8.3f} {}{}", index,
+                             segment->path.position.x, segment->path.position.y,
+                             segment->targetTime, segment->turnTime,
+                             segment->path.flags & Path::REVERSE ? 'R' : '-',
+                             segment->path.flags & Path::STOP ? 'S' : '-');
+                ++index;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Client>
+    bool startupTimes(Client& client) {
+        auto const reply = client.request(Message::GET_STARTUP_TIMES, [](Protocol::Writer&) {});
+        if (!reply || reply->type != Message::STARTUP_TIMES) {
+            std::println(stderr, "no startup times");
+            return false;
+        }
+
+        Protocol::Reader reader{ reply->payload };
+        auto const count = reader.read<uint8_t>();
+        if (!count) return false;
+
+        std::println("{:<22} {:>10} {:>10} {:>10}", "phase", "start ms", "end ms", "took ms");
+        for (size_t i = 0u; i < *count; ++i) {
+            auto const start = reader.read<uint32_t>();
+            auto const end = reader.read<uint32_t>();
+            if (!end) return false;
+
+            std::string_view const name = i < Startup::PHASE_COUNT ? Startup::PHASE_NAMES[i]
+                                                                    : "unknown";
+            if (*end == 0u) std::println("{:<22} {:>10}", name, "pending");
+            else
+                std::println("{:<22} {:>10.3f} {:>10.3f} {:>10.3f}", name, *start * 1.0e-3,
+                             *end * 1.0e-3, (*end - *start) * 1.0e-3);
+        }
+
+        return true;
+    }
+
+    template <typename Client>
+    bool stageTimes(Client& client) {
+        uint8_t index = 0u;
+        std::optional<uint8_t> count{};
+        while (!count || index < *count) {
+            auto const reply = client.request(
+                Message::GET_STAGE_TIMES, [&](Protocol::Writer& writer) { writer.write(index); });
+            if (!reply || reply->type != Message::STAGE_TIMES) {
+                std::println(stderr, "no stage times");
+                return false;
+            }
+
+            Protocol::Reader reader{ reply->payload };
+            auto const frequency = reader.read<uint32_t>();
+            count = reader.read<uint8_t>();
+            if (!frequency || !count || reader.read<uint8_t>() != index) return false;
+
+            // all zero if the firmware was built without Integration::PROFILE_STAGES
+            double const cyclesPerUs = std::max(*frequency * 1.0e-6, 1.0e-6);
+
+            if (index == 0u)
+                std::println("{:<20} {:>5} {:>10} {:>8} {:>8} {:>8} {:>9}", "stage", "core",
+                             "runs", "min", "mean", "max", "mean us");
+
+            uint8_t const first = index;
+            while (reader.remaining() > 0u) {
+                auto const stats = reader.readStageStats();
+                if (!stats) return false;
+
+                bool const known = index < Stages::COUNT;
+                std::string_view const name = known ? Stages::TABLE[index].name : "unknown";
+                std::string const core = known ? std::to_string(Stages::TABLE[index].core) : "?";
+                std::println("{:<20} {:>5} {:>10} {:>8} {:>8.0f} {:>8} {:>9.3f}", name, core,
+                             stats->runs, stats->minCycles, stats->meanCycles(),
+                             stats->maxCycles, stats->meanCycles() / cyclesPerUs);
+                ++index;
+            }
+
+            // a reply with nothing past where it was asked to start would never finish
+            if (index == first && index < *count) return false;
+        }
+
+        return true;
+    }
+
+    template <typename Client>
+    bool record(Client& client, std::string const& filename) {
+        std::vector<uint8_t> recording{};
+        size_t total = 0u;
+
+        do {
+            uint32_t const offset = static_cast<uint32_t>(recording.size());
+            auto const request = [&](Protocol::Writer& writer) {
+                writer.write(offset).write(
+                    static_cast<uint16_t>(Protocol::RECORDING_BYTES_PER_FRAME));
+            };
+
+            auto const reply = client.request(Message::GET_RECORDING, request);
+            if (!reply || reply->type != Message::RECORDING_DATA) {
+                std::println(stderr, "no recording data at offset {}", offset);
+                return false;
+            }
+
+            Protocol::Reader reader{ reply->payload };
+            auto const size = reader.read<uint32_t>();
+            if (reader.read<uint32_t>() != offset) return false;
+
+            total = *size;
+            if (total == 0u) {
+                std::println(stderr, "nothing recorded, the robot has not finished a run");
+                return false;
+            }
+            if (reader.remaining() == 0u && recording.size() < total) return false;
+
+            while (auto const byte = reader.read<uint8_t>()) recording.push_back(*byte);
+        } while (recording.size() < total);
+
+        std::ofstream file{ filename, std::ios::binary };
+        file.write(reinterpret_cast<char const*>(recording.data()),
+                   static_cast<std::streamsize>(recording.size()));
+        if (!file) {
+            std::println(stderr, "cannot write {}", filename);
+            return false;
+        }
+
+        std::println("saved {} bytes to {}", recording.size(), filename);
+        return true;
+    }
+
+    template <typename Client>
+    int run(Client& client, std::span<char const* const> arguments) {
+        for (size_t i = 0u; i < arguments.size(); ++i) {
+            std::string_view const command = arguments[i];
+            bool const hasArgument = i + 1u < arguments.size();
+
+            bool ok = false;
+            if (command == "ping") ok = ping(client);
+            else if (command == "info") ok = info(client);
+            else if (command == "route") ok = route(client);
+            else if (command == "startup") ok = startupTimes(client);
+            else if (command == "stages") ok = stageTimes(client);
+            else if (command == "upload" && hasArgument) ok = upload(client, arguments[++i]);
+            else if (command == "record" && hasArgument) ok = record(client, arguments[++i]);
+            else if (command == "target-time" && hasArgument)
+                ok = setTargetTime(client, arguments[++i]);
+            else if (command == "params") ok = parameters(client);
+            else if (command == "set" && i + 2u < arguments.size()) {
+                ok = setParameter(client, arguments[i + 1u], arguments[i + 2u]);
+                i += 2u;
+            }
+            else std::println(stderr, "unknown command {}", command);
+
+            if (!ok) return 1;
+        }
+
+        return 0;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-cli (--port <device> | --loopback) <command>...\n"
+                     "\n"
+                     "commands run in order:\n"
+                     "  ping                   check the robot is listening\n"
+                     "  upload <file>          upload commands written with the Compiler tokens\n"
+                     "  target-time <seconds>  change the target time\n"
+                     "  params                 print the tunable parameters, * where changed\n"
+                     "  set <name> <value>     change a parameter, or put it back with default.\n"
+                     "                         kept in flash, only accepted before the\n"
+                     "                         calibration click\n"
+                     "  info                   print the route size, target time and destination\n"
+                     "  route                  print the compiled path and target times\n"
+                     "  startup                print how long each startup phase took\n"
+                     "  stages                 print the cycles each loop stage takes, min,\n"
+                     "                         mean and max since the run started\n"
+                     "  record <file>          download the recording of the last run for\n"
+                     "                         rotour-replay"
+                     "\n"
+                     "--loopback runs the firmware command channel in process against the\n"
+                     "built in competition route");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+    if (arguments.size() < 2u) {
+        usage();
+        return 1;
+    }
+
+    std::string_view const mode = arguments[0];
+    if (mode == "--loopback") {
+        static Route deviceRoute{ Competition::COMMANDS, Competition::TARGET_TIME };
+        static LoopbackTransport::Link link{};
+        static Startup deviceStartup{};
+        static Recorder deviceRecorder{};
+        static Stages::Profile deviceProfile{};
+
+        auto deviceTransport = link.device();
+        auto hostTransport = link.host();
+        auto channel = std::make_unique<CommandChannel<LoopbackTransport>>(
+            deviceTransport, deviceRoute, deviceStartup, deviceRecorder, deviceProfile);
+
+        Client client{ hostTransport, [&]() { channel->poll(); } };
+        return run(client, arguments.subspan(1u));
+    }
+
+    if (mode == "--port" && arguments.size() >= 3u) {
+        SerialTransport transport{ arguments[1] };
+        if (!transport.isOpen()) {
+            std::println(stderr, "cannot open {}", arguments[1]);
+            return 1;
+        }
+
+        Client client{ transport, []() {} };
+        return run(client, arguments.subspan(2u));
+    }
+
+    usage();
+    return 1;
+}
@@ -0,0 +1,205 @@
+#include "Constants.hpp"
+
+#include "filters/BiquadDesign.hpp"
+#include "filters/RCFilter.hpp"
+
+#include "profiles/Robot.hpp"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <numbers>
+#include <print>
+#include <random>
+#include <span>
+#include <string_view>
+
+// the phase lag and noise behind ForwardKinematics' filters: each one it runs against the rc
+// filter it replaced and against the same design as a direct form ii transposed cascade, on the
+// wheel speed a 14 bit encoder gives when differenced every fast loop tick
+namespace {
+    constexpr double DT = 1.0 / static_cast<double>(Integration::TARGET_FAST_LOOP_HZ);
+
+    // the cutoffs the rc filters had, nominal since the constant in RCFilter is pi/2
+    constexpr float RC_VELOCITY_CUTOFF = 50.0f;
+    constexpr float RC_WHEEL_SPEED_CUTOFF = 100.0f;
+
+    // the lag is read off a sine at a frequency the robot actually moves at
+    constexpr double LAG_FREQUENCY = 5.0;
+    constexpr double LAG_PERIODS = 40.0;
+
+    // counts a wheel turn, and wheel speeds in rad/s from a crawl to a fast leg
+    constexpr double COUNTS = 16384.0;
+    constexpr std::array<double, 4> SPEEDS{ 7.3, 23.9, 37.31, 61.7 };
+
+    // a second a speed, the first third left out while the filters settle
+    constexpr size_t NOISE_TICKS = 96'000u;
+    constexpr size_t SETTLE_TICKS = 32'000u;
+
+    // the replacement may take a little more lag than the rc filter had for its roll off
+    constexpr double LAG_ALLOWANCE = 1.1;
+
+    // direct form ii transposed over the same bilinear sections as BiquadDesign, in float like
+    // the firmware would run it or in double to show what rounding costs
+    template <typename Real, BiquadDesign::Response R, size_t Order>
+    class DirectForm {
+    public:
+        DirectForm(double cutoff, double dt) {
+            for (size_t i = 0u; i < Order / 2u; ++i) {
+                auto const section = BiquadDesign::Detail::section<R, Order>(i);
+                double const g = std::tan(std::numbers::pi * cutoff * section.frequencyScale * dt);
+                double const norm = 1.0 / (1.0 + g / section.q + g * g);
+                m_sections[i] = { static_cast<Real>(g * g * norm),
+                                  static_cast<Real>(2.0 * (g * g - 1.0) * norm),
+                                  static_cast<Real>((1.0 - g / section.q + g * g) * norm) };
+            }
+        }
+
+        float update(float input) {
+            Real value = input;
+            for (Section& section : m_sections) {
+                Real const output = section.b0 * value + section.state1;
+                section.state1 = Real{ 2 } * section.b0 * value - section.a1 * output +
+                                 section.state2;
+                section.state2 = section.b0 * value - section.a2 * output;
+                value = output;
+            }
+            return static_cast<float>(value);
+        }
+
+    private:
+        // a low pass section has b1 = 2 b0 and b2 = b0
+        struct Section {
+            Real b0{};
+            Real a1{};
+            Real a2{};
+            Real state1{};
+            Real state2{};
+        };
+
+        std::array<Section, Order / 2u> m_sections{};
+    };
+
+    struct Row {
+        double lag{};
+        double gain{};
+        double noise{};
+        double bias{};
+    };
+
+    // the response to a sine by correlating the second half of the output against it, the first
+    // half left for the filter to settle
+    template <typename Filter>
+    std::complex<double> response(Filter filter, double frequency) {
+        size_t const ticks = static_cast<size_t>(LAG_PERIODS / frequency / DT);
+        std::complex<double> sum{};
+        for (size_t i = 0u; i < ticks; ++i) {
+            double const phase = 2.0 * std::numbers::pi * frequency * static_cast<double>(i) * DT;
+            float const output = filter.update(static_cast<float>(std::sin(phase)));
+            if (i >= ticks / 2u) sum += static_cast<double>(output) * std::polar(1.0, -phase);
+        }
+
+        // against sin rather than cos, so a quarter turn on
+        return sum * std::complex<double>{ 0.0, 2.0 } / static_cast<double>(ticks - ticks / 2u);
+    }
+
+    // constant speeds through an encoder that rounds down to a count after up to a count of
+    // jitter either way, differenced every tick the way ForwardKinematics does
+    template <typename Filter, typename Make>
+    Row row(Make const& make) {
+        std::complex<double> const atLag = response(make(), LAG_FREQUENCY);
+
+        double const count = 2.0 * std::numbers::pi / COUNTS;
+        double squares = 0.0;
+        double sum = 0.0;
+        size_t samples = 0u;
+        for (double speed : SPEEDS) {
+            Filter filter = make();
+            std::mt19937 random{ 3u };
+            std::uniform_real_distribution<double> jitter{ -1.0, 1.0 };
+
+            double previous = 0.0;
+            for (size_t i = 0u; i < NOISE_TICKS; ++i) {
+                double const time = static_cast<double>(i) * DT;
+                double const angle = std::floor(speed * time / count + jitter(random)) * count;
+                float const output = filter.update(static_cast<float>((angle - previous) / DT));
+                previous = angle;
+
+                if (i < SETTLE_TICKS) continue;
+                double const error = static_cast<double>(output) - speed;
+                squares += error * error;
+                sum += error;
+                ++samples;
+            }
+        }
+
+        return { -std::arg(atLag) / (2.0 * std::numbers::pi * LAG_FREQUENCY),
+                 std::abs(atLag), std::sqrt(squares / static_cast<double>(samples)),
+                 sum / static_cast<double>(samples) };
+    }
+
+    void print(std::string_view name, Row const& row) {
+        std::println("{:<24} {:>6.2f} ms {:>7.3f} {:>9.5f} {:>+9.5f}", name, row.lag * 1.0e3,
+                     row.gain, row.noise, row.bias);
+    }
+
+    // the filter ForwardKinematics runs on a signal against the rc filter it replaced and the
+    // same design in direct form. fails if it lags the rc filter by more than the allowance, or
+    // is noisier than either
+    template <BiquadDesign::Response R, size_t Order>
+    bool compare(std::string_view signal, float cutoff, float rcCutoff) {
+        using Shipped = BiquadFilter<R, Order>;
+        using Float = DirectForm<float, R, Order>;
+        using Double = DirectForm<double, R, Order>;
+
+        Row const rc = row<RCFilter>([&]() { return RCFilter{ rcCutoff, DT }; });
+        Row const shipped = row<Shipped>([&]() { return Shipped{ cutoff, DT }; });
+        Row const single = row<Float>([&]() { return Float{ cutoff, DT }; });
+        Row const exact = row<Double>([&]() { return Double{ cutoff, DT }; });
+
+        std::println("{}, {} Hz:", signal, cutoff);
+        print(std::format("  rc {} Hz (before)", rcCutoff), rc);
+        print("  state variable", shipped);
+        print("  direct form, float", single);
+        print("  direct form, double", exact);
+
+        return shipped.lag <= rc.lag * LAG_ALLOWANCE && shipped.noise < rc.noise &&
+               shipped.noise < single.noise;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-filters\n"
+                     "\n"
+                     "runs ForwardKinematics' velocity and wheel speed filters against the rc "
+                     "filters\nthey replaced and against direct form ii transposed cascades of "
+                     "the same design,\nfor the lag at {} Hz and the noise a 14 bit encoder with "
+                     "a count of jitter leaves\nat constant speeds. fails if a filter lags the rc "
+                     "filter by more than {}%, or\nis noisier than either",
+                     LAG_FREQUENCY, static_cast<int>(std::round((LAG_ALLOWANCE - 1.0) * 100.0)));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+    if (!arguments.empty()) {
+        usage();
+        return 1;
+    }
+
+    using Forward = Robot::Kinematics::Forward;
+    using BiquadDesign::Response;
+
+    std::println("{:<24} {:>9} {:>7} {:>9} {:>9}", "", "lag", "gain", "noise", "bias");
+    bool const velocity = compare<Response::BESSEL, 4u>(
+        "velocity", Forward::VELOCITY_CUTOFF_FREQUENCY, RC_VELOCITY_CUTOFF);
+    bool const wheelSpeed = compare<Response::BESSEL, 2u>(
+        "wheel speeds", Forward::WHEEL_SPEED_CUTOFF_FREQUENCY, RC_WHEEL_SPEED_CUTOFF);
+    std::println("noise and bias in rad/s");
+
+    return velocity && wheelSpeed ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include "dsp/Kernels.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+
+// checks the kernels against what the cortex-m33 instructions are specified to do, through the
+// Dsp entry points, which take whatever backend the build picks, and through Dsp::Reference
+namespace {
+    constexpr uint64_t DEFAULT_INPUTS = 10'000'000u;
+
+    struct Entry {
+        static float mac(float accumulator, float a, float b) {
+            return Dsp::mac(accumulator, a, b);
+        }
+        static float min(float a, float b) { return Dsp::min(a, b); }
+        static float max(float a, float b) { return Dsp::max(a, b); }
+    };
+
+    struct Reference {
+        static float mac(float accumulator, float a, float b) {
+            return Dsp::Reference::mac(accumulator, a, b);
+        }
+        static float min(float a, float b) { return Dsp::Reference::min(a, b); }
+        static float max(float a, float b) { return Dsp::Reference::max(a, b); }
+    };
+
+    bool same(float a, float b) {
+        return std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b) ||
+               (std::isnan(a) && std::isnan(b));
+    }
+
+    // vfma, a * b + accumulator rounded once. the product of two floats is exact in a double, and
+    // the sum rounded to odd in a double then rounds to the nearest float as if it had been exact,
+    // with no double rounding on the way
+    float fused(float accumulator, float a, float b) {
+        double const product = static_cast<double>(a) * static_cast<double>(b);
+        double sum = product + static_cast<double>(accumulator);
+
+        // the exact error of that addition, two-sum
+        double const part = sum - product;
+        double const error = (product - (sum - part)) + (static_cast<double>(accumulator) - part);
+        if (error != 0.0 && std::isfinite(sum) && (std::bit_cast<uint64_t>(sum) & 1u) == 0u)
+            sum = std::nextafter(sum, error > 0.0 ? std::numeric_limits<double>::infinity()
+                                                  : -std::numeric_limits<double>::infinity());
+        return static_cast<float>(sum);
+    }
+
+    // vminnm and vmaxnm, ieee 754-2008 minNum and maxNum with -0 below +0: one quiet nan gives
+    // the other operand, two give a nan
+    float minNum(float a, float b) {
+        if (std::isnan(a) && std::isnan(b)) return std::numeric_limits<float>::quiet_NaN();
+        if (std::isnan(a)) return b;
+        if (std::isnan(b)) return a;
+        if (a == 0.0f && b == 0.0f) return std::signbit(a) ? a : b;
+        return a < b ? a : b;
+    }
+
+    float maxNum(float a, float b) {
+        if (std::isnan(a) && std::isnan(b)) return std::numeric_limits<float>::quiet_NaN();
+        if (std::isnan(a)) return b;
+        if (std::isnan(b)) return a;
+        if (a == 0.0f && b == 0.0f) return std::signbit(a) ? b : a;
+        return a > b ? a : b;
+    }
+
+    // a third spread evenly, a third over twenty binades either side of one so the products
+    // and sums meet every alignment, and a third cancelling the accumulator against the rounded
+    // product, where a separate multiply and add lose everything the fused one keeps
+    std::array<float, 3> input(std::mt19937& random, uint64_t i) {
+        std::uniform_real_distribution<float> uniform{ -100.0f, 100.0f };
+        auto const scaled = [&]() {
+            float const mantissa = std::uniform_real_distribution<float>{ 1.0f, 2.0f }(random);
+            int const exponent = std::uniform_int_distribution<int>{ -20, 20 }(random);
+            return (random() & 1u ? -1.0f : 1.0f) * std::ldexp(mantissa, exponent);
+        };
+
+        switch (i % 3u) {
+        case 0u: return { uniform(random), uniform(random), uniform(random) };
+        case 1u: return { scaled(), scaled(), scaled() };
+        default: {
+            float const a = scaled();
+            float const b = scaled();
+            return { -(a * b), a, b };
+        }
+        }
+    }
+
+    template <typename Kernels>
+    bool check(std::string_view name, uint64_t inputs) {
+        std::mt19937 random{ 1u };
+        uint64_t macMismatches = 0u;
+        for (uint64_t i = 0u; i < inputs; ++i) {
+            auto const [accumulator, a, b] = input(random, i);
+            float const result = Kernels::mac(accumulator, a, b);
+            float const expected = fused(accumulator, a, b);
+            if (same(result, expected)) continue;
+
+            if (macMismatches++ == 0u)
+                std::println("{}: mac({:a}, {:a}, {:a}) gave {:a}, vfma gives {:a}", name,
+                             accumulator, a, b, result, expected);
+        }
+
+        float const nan = std::numeric_limits<float>::quiet_NaN();
+        float const infinity = std::numeric_limits<float>::infinity();
+        float const denormal = std::numeric_limits<float>::denorm_min();
+        float const largest = std::numeric_limits<float>::max();
+        std::array<float, 12> const values{ -0.0f,   0.0f,     1.0f,     -1.0f,
+                                            denormal, -denormal, largest, -largest,
+                                            infinity, -infinity, nan,     -nan };
+
+        uint64_t ruleMismatches = 0u;
+        for (float a : values) {
+            for (float b : values) {
+                bool const minimum = same(Kernels::min(a, b), minNum(a, b));
+                bool const maximum = same(Kernels::max(a, b), maxNum(a, b));
+                ruleMismatches += (minimum ? 0u : 1u) + (maximum ? 0u : 1u);
+
+                if (!minimum)
+                    std::println("{}: min({}, {}) gave {}, vminnm gives {}", name, a, b,
+                                 Kernels::min(a, b), minNum(a, b));
+                if (!maximum)
+                    std::println("{}: max({}, {}) gave {}, vmaxnm gives {}", name, a, b,
+                                 Kernels::max(a, b), maxNum(a, b));
+            }
+        }
+
+        std::println("{:<9} mac {} of {} inputs off vfma, min and max {} of {} pairs off vminnm "
+                     "and vmaxnm",
+                     name, macMismatches, inputs, ruleMismatches,
+                     2u * values.size() * values.size());
+        return macMismatches == 0u && ruleMismatches == 0u;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-kernels [--inputs <n>]\n"
+                     "\n"
+                     "checks the Dsp kernels against the m33 instructions they stand for: mac "
+                     "against\nan exact fused multiply-add over random inputs ({} by default), "
+                     "min and max\nagainst the vminnm and vmaxnm rules for zeros, nans and "
+                     "infinities",
+                     DEFAULT_INPUTS);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    uint64_t inputs = DEFAULT_INPUTS;
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        if (argument == "--inputs" && i + 1u < arguments.size())
+            inputs = std::stoull(arguments[++i]);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    bool const entry = check<Entry>("Dsp", inputs);
+    bool const reference = check<Reference>("Reference", inputs);
+    return entry && reference ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#include "Constants.hpp"
+
+#include "storage/LogStore.hpp"
+#include "storage/RamFlash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// cuts the power to a RamFlash under LogStore at every program and erase a workload of appends and
+// garbage collection makes, the way the firmware's idle loop drives it. after each cut the store
+// is mounted again and every key has to read back its newest completed record, or the record that
+// was being appended when the power went, and then keep working
+namespace {
+    constexpr size_t DEFAULT_STEPS = 400u;
+
+    // steps run after each remount, enough for the store to come round to every sector again
+    constexpr size_t RESUME_STEPS = 80u;
+
+    // how many failed cuts are described before they are only counted
+    constexpr size_t REPORTED_FAILURES = 5u;
+
+    struct Key {
+        RecordType type{};
+        uint8_t slot{};
+        size_t length{};
+    };
+
+    // from a record inside one page to one filling most of a sector
+    constexpr std::array<Key, 6> KEYS{ {
+        { RecordType::CALIBRATION, 0u, 48u },
+        { RecordType::TUNING, 0u, 300u },
+        { RecordType::ROUTE, 0u, 900u },
+        { RecordType::ROUTE, 1u, 600u },
+        { RecordType::RUN_LOG, 0u, 2000u },
+        { RecordType::RUN_LOG, 1u, 120u },
+    } };
+
+    // which key each step appends, the run logs often and the calibration rarely so some records
+    // sit still long enough to be relocated
+    constexpr std::array<size_t, 12> SCHEDULE{ 4u, 5u, 1u, 4u, 2u, 5u, 4u, 3u, 5u, 4u, 1u, 0u };
+
+    // every byte of every version of every key differs
+    std::vector<uint8_t> payload(size_t key, uint32_t version) {
+        std::vector<uint8_t> bytes(KEYS[key].length);
+        uint32_t state = version * 2654435761u + static_cast<uint32_t>(key) * 40503u + 1u;
+        for (uint8_t& byte : bytes) {
+            state ^= state << 13u;
+            state ^= state >> 17u;
+            state ^= state << 5u;
+            byte = static_cast<uint8_t>(state);
+        }
+        return bytes;
+    }
+
+    enum class Phase { APPEND, COLLECTION };
+
+    // what the store has been asked to keep: the version of each key's last append that returned,
+    // and the one under way if the power goes
+    struct Model {
+        std::array<std::optional<uint32_t>, KEYS.size()> completed{};
+        std::optional<size_t> pendingKey{};
+        uint32_t pendingVersion{};
+    };
+
+    // one step of the workload, false once the power has gone or if the store refused the record
+    bool step(LogStore<RamFlash>& store, RamFlash const& flash, Model& model, uint32_t version,
+              Phase& phase) {
+        size_t const key = SCHEDULE[version % SCHEDULE.size()];
+        std::vector<uint8_t> const data = payload(key, version);
+
+        phase = Phase::APPEND;
+        model.pendingKey = key;
+        model.pendingVersion = version;
+        bool const appended = store.append(KEYS[key].type, KEYS[key].slot, data);
+        if (!flash.powered()) return false;
+        model.pendingKey.reset();
+        if (!appended) return false;
+        model.completed[key] = version;
+
+        phase = Phase::COLLECTION;
+        if (store.needsGarbageCollection()) store.collectGarbage();
+        return flash.powered();
+    }
+
+    // every key against the model. the pending key may hold either version, and the model takes
+    // whichever survived so the run can go on from it
+    std::optional<std::string> verify(LogStore<RamFlash> const& store, Model& model) {
+        std::array<uint8_t, LogStore<RamFlash>::MAX_RECORD_SIZE> buffer{};
+        for (size_t key = 0u; key < KEYS.size(); ++key) {
+            auto const length = store.read(KEYS[key].type, KEYS[key].slot, buffer);
+            auto const holds = [&](std::optional<uint32_t> version) {
+                if (!version) return !length;
+                std::vector<uint8_t> const expected = payload(key, *version);
+                return length == expected.size() &&
+                       std::equal(expected.begin(), expected.end(), buffer.begin());
+            };
+
+            if (model.pendingKey == key && holds(model.pendingVersion)) {
+                model.completed[key] = model.pendingVersion;
+                continue;
+            }
+            if (holds(model.completed[key])) continue;
+
+            auto const version = model.completed[key];
+            return std::format("key {} lost version {}", key,
+                               version ? std::to_string(*version) : std::string{ "none" });
+        }
+
+        model.pendingKey.reset();
+        return std::nullopt;
+    }
+
+    size_t operations(RamFlash const& flash) {
+        auto const erases = flash.eraseCounts();
+        return flash.programCount() + std::accumulate(erases.begin(), erases.end(), size_t{ 0u });
+    }
+
+    struct Cut {
+        Phase phase{};
+        bool pendingKept{};
+        std::optional<std::string> failure{};
+    };
+
+    // the workload with the power cut at one operation, then a remount, a check, and a few more
+    // steps on the recovered store with a check after them
+    Cut cut(size_t operation, size_t steps) {
+        RamFlash flash{};
+        Model model{};
+        Cut result{};
+
+        uint32_t version = 0u;
+        {
+            LogStore<RamFlash> store{ flash };
+            flash.failAfter(operation);
+            while (version < steps && step(store, flash, model, version, result.phase)) ++version;
+        }
+        if (flash.powered())
+            return { result.phase, false,
+                     version < steps ? "the store refused a record" : "the power was never cut" };
+
+        flash.powerOn();
+        LogStore<RamFlash> store{ flash };
+
+        std::optional<size_t> const pendingKey = model.pendingKey;
+        uint32_t const pendingVersion = model.pendingVersion;
+        if (auto const failure = verify(store, model)) return { result.phase, false, failure };
+        result.pendingKept = pendingKey && model.completed[*pendingKey] == pendingVersion;
+
+        Phase phase{};
+        for (size_t i = 0u; i < RESUME_STEPS; ++i) {
+            if (!step(store, flash, model, ++version, phase))
+                return { result.phase, result.pendingKept,
+                         "the store refused a record after recovery" };
+        }
+        if (auto const failure = verify(store, model))
+            return { result.phase, result.pendingKept, "after recovery, " + *failure };
+
+        return result;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-logstore [--steps <n>]\n"
+                     "\n"
+                     "runs appends and garbage collection over a RamFlash ({} steps by default) "
+                     "and\ncuts the power at each program and erase in turn. after every cut the "
+                     "store is\nmounted again, each key has to hold its newest completed record "
+                     "or the one being\nappended, and {} more steps have to run and read back",
+                     DEFAULT_STEPS, RESUME_STEPS);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    size_t steps = DEFAULT_STEPS;
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        if (argument == "--steps" && i + 1u < arguments.size())
+            steps = std::stoul(arguments[++i]);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    // the uncut run counts the operations to cut at, and has to pass the same check
+    size_t total = 0u;
+    {
+        RamFlash flash{};
+        LogStore<RamFlash> store{ flash };
+        Model model{};
+        Phase phase{};
+        for (uint32_t version = 0u; version < steps; ++version) {
+            if (!step(store, flash, model, version, phase)) {
+                std::println("uncut run: the store refused step {}", version);
+                return 1;
+            }
+        }
+        if (auto const failure = verify(store, model)) {
+            std::println("uncut run: {}", *failure);
+            return 1;
+        }
+
+        total = operations(flash);
+        std::println("{} steps, {} programs and erases, the most worn sector erased {} times",
+                     steps, total, std::ranges::max(flash.eraseCounts()));
+    }
+
+    std::array<size_t, 2> cuts{};
+    size_t pendingKept = 0u;
+    size_t failures = 0u;
+    for (size_t operation = 0u; operation < total; ++operation) {
+        Cut const result = cut(operation, steps);
+        ++cuts[static_cast<size_t>(result.phase)];
+        pendingKept += result.pendingKept ? 1u : 0u;
+        if (!result.failure) continue;
+
+        if (failures++ < REPORTED_FAILURES)
+            std::println("cut at operation {}, in {}: {}", operation,
+                         result.phase == Phase::APPEND ? "an append" : "a collection",
+                         *result.failure);
+    }
+
+    std::println("{} cuts, {} in an append and {} in a collection, the append under way kept {} "
+                 "times, {} failed",
+                 total, cuts[0], cuts[1], pendingKept, failures);
+    return failures == 0u ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+#include "Constants.hpp"
+
+#include "drivers/SensorConversion.hpp"
+
+#include "kinematics/ForwardKinematics.hpp"
+
+#include "loops/FastLoop.hpp"
+#include "loops/SlowLoop.hpp"
+
+#include "path/Competition.hpp"
+#include "path/Route.hpp"
+
+#include "recording/Recording.hpp"
+
+#include "state/Vector.hpp"
+
+#include "storage/RouteRecord.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    struct Samples {
+        Recording::Header header{};
+        std::span<uint8_t const> route{};
+        std::vector<Recording::FastSample> fast{};
+        std::vector<Recording::SlowSample> slow{};
+    };
+
+    struct Result {
+        size_t compared{ 0u };
+        float maxError{ 0.0f };
+        std::optional<size_t> firstDivergence{};
+        float duration{ 0.0f };
+        double replayTime{ 0.0 };
+    };
+
+    template <typename T>
+    std::vector<T> readArray(std::span<uint8_t const> bytes, size_t count) {
+        std::vector<T> values(count);
+        for (size_t i = 0u; i < count; ++i) {
+            std::array<uint8_t, sizeof(T)> value{};
+            std::copy_n(bytes.begin() + i * sizeof(T), sizeof(T), value.begin());
+            values[i] = std::bit_cast<T>(value);
+        }
+        return values;
+    }
+
+    std::optional<Samples> parse(std::span<uint8_t const> bytes) {
+        if (bytes.size() < sizeof(Recording::Header)) return std::nullopt;
+
+        Samples samples{};
+        std::array<uint8_t, sizeof(Recording::Header)> header{};
+        std::copy_n(bytes.begin(), header.size(), header.begin());
+        samples.header = std::bit_cast<Recording::Header>(header);
+
+        Recording::Header const& h = samples.header;
+        if (h.magic != Recording::MAGIC || h.version != Recording::VERSION) return std::nullopt;
+
+        size_t const fastOffset = sizeof(Recording::Header) + h.routeSize;
+        size_t const slowOffset = fastOffset + h.fastCount * sizeof(Recording::FastSample);
+        if (bytes.size() != slowOffset + h.slowCount * sizeof(Recording::SlowSample))
+            return std::nullopt;
+
+        samples.route = bytes.subspan(sizeof(Recording::Header), h.routeSize);
+        samples.fast = readArray<Recording::FastSample>(bytes.subspan(fastOffset), h.fastCount);
+        samples.slow = readArray<Recording::SlowSample>(bytes.subspan(slowOffset), h.slowCount);
+        return samples;
+    }
+
+    // the replay reruns the fast loop up to the sample each slow iteration saw, then compares the
+    // motor voltages the slow loop produces against the recorded ones
+    Result replay(Samples const& samples, Route const& route, std::FILE* csv) {
+        Recording::Header const& header = samples.header;
+        auto const start = std::chrono::steady_clock::now();
+
+        FastLoop fastLoop{ SensorConversion::wheelAngles(header.encoders), header.fastLoopDt };
+        SlowLoop slowLoop{ route.path(), route.targetTimes(), Integration::SLOW_LOOP_DT,
+                           Integration::ADAPTIVE_FEEDFORWARD };
+
+        ForwardKinematics::State state{};
+        size_t fastIndex = 0u;
+
+        Result result{};
+        for (Recording::SlowSample const& slow : samples.slow) {
+            for (; fastIndex < slow.fastCount; ++fastIndex) {
+                Recording::FastSample const& fast = samples.fast[fastIndex];
+                state = fastLoop.update(
+                    SensorConversion::wheelAngles(fast.encoders),
+                    SensorConversion::angularVelocity(fast.gyroscope, header.bias, header.down));
+            }
+
+            Vec2 const motorVoltages = slowLoop.update(state, slow.stateAge, slow.elapsed,
+                                                       slow.batteryVoltage, slow.batteryCurrent);
+            float const error = std::max(std::abs(motorVoltages.x - slow.motorVoltages.x),
+                                         std::abs(motorVoltages.y - slow.motorVoltages.y));
+
+            if (error != 0.0f && !result.firstDivergence) result.firstDivergence = result.compared;
+            result.maxError = std::max(result.maxError, error);
+            result.duration = slow.elapsed;
+
+            if (csv)
+                std::println(csv, "{},{},{},{},{}", slow.elapsed, slow.motorVoltages.x,
+                             slow.motorVoltages.y, motorVoltages.x, motorVoltages.y);
+
+            ++result.compared;
+        }
+
+        result.replayTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                                .count();
+        return result;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-replay [--tolerance <volts>] [--csv <file>] <recording>...\n"
+                     "\n"
+                     "replays recordings downloaded with rotour-cli record through the firmware\n"
+                     "loops and compares the motor voltages, failing if any differ by more than\n"
+                     "the tolerance (0 by default, the replay is expected to be exact)\n"
+                     "\n"
+                     "--csv writes the recorded and replayed voltages of the last recording");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    float tolerance = 0.0f;
+    std::string csvFilename{};
+    std::vector<std::string> filenames{};
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        bool const hasValue = i + 1u < arguments.size();
+
+        if (argument == "--tolerance" && hasValue) tolerance = std::stof(arguments[++i]);
+        else if (argument == "--csv" && hasValue) csvFilename = arguments[++i];
+        else if (argument.starts_with("--")) {
+            usage();
+            return 1;
+        } else filenames.emplace_back(argument);
+    }
+
+    if (filenames.empty()) {
+        usage();
+        return 1;
+    }
+
+    // the route is too big for the stack
+    static Route route{ Competition::COMMANDS, Competition::TARGET_TIME };
+
+    bool passed = true;
+    for (std::string const& filename : filenames) {
+        std::ifstream file{ filename, std::ios::binary };
+        std::vector<uint8_t> const bytes{ std::istreambuf_iterator<char>{ file },
+                                          std::istreambuf_iterator<char>{} };
+
+        auto const samples = parse(bytes);
+        if (!samples || !RouteRecord::deserialize(samples->route, route)) {
+            std::println(stderr, "{}: not a recording", filename);
+            passed = false;
+            continue;
+        }
+
+        // the loops read their parameters when they are built, so these have to go in first
+        if (!Parameters::load(samples->header.parameters)) {
+            std::println(stderr, "{}: recorded with a different parameter table", filename);
+            passed = false;
+            continue;
+        }
+
+        std::FILE* csv = nullptr;
+        if (!csvFilename.empty() && filename == filenames.back()) {
+            csv = std::fopen(csvFilename.c_str(), "w");
+            if (csv) std::println(csv, "time,recorded left,recorded right,left,right");
+        }
+
+        Result const result = replay(*samples, route, csv);
+        if (csv) std::fclose(csv);
+
+        bool const ok = result.maxError <= tolerance;
+        passed = passed && ok;
+
+        std::println("{}: {} {} slow samples over {:.3f} s, replayed {:.0f}x faster than real "
+                     "time",
+                     filename, ok ? "ok" : "FAILED", result.compared, result.duration,
+                     result.duration / std::max(result.replayTime, 1.0e-9));
+        if (result.firstDivergence)
+            std::println("    first divergence at sample {} ({:.6f} s), max error {} V",
+                         *result.firstDivergence,
+                         samples->slow[*result.firstDivergence].elapsed, result.maxError);
+    }
+
+    return passed ? 0 : 1;
+}
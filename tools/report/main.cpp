@@ -0,0 +1,133 @@
+#include "Constants.hpp"
+
+#include "cli/CommandParser.hpp"
+
+#include "path/Competition.hpp"
+#include "path/Compiler.hpp"
+#include "path/Path.hpp"
+#include "path/Route.hpp"
+
+#include "profiles/Robot.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+    using Compiler::Feasibility::Segment;
+
+    std::string_view problem(Segment const& segment) {
+        constexpr float MAX_LINEAR_SPEED = Robot::Manager::Straight::MAX_LINEAR_SPEED;
+
+        auto const speed = Compiler::Feasibility::getRequiredSpeed(segment);
+        if (segment.driveTime <= 0.0f) return "no time after the turn";
+        else if (!speed) return "cannot stop in time";
+        else if (*speed > MAX_LINEAR_SPEED) return "over MAX_LINEAR_SPEED";
+        else return "";
+    }
+
+    // prints every segment and the time budget, true if the straight manager can keep to it
+    bool report(Route const& route) {
+        std::println("{:>4} {:>9} {:>8} {:>8} {:>8} {:>9} {:>5}", "#", "distance", "target", "turn",
+                     "drive", "speed", "flags");
+
+        float distance = 0.0f;
+        float turnTime = 0.0f;
+        float forcedTime = 0.0f;
+        bool feasible = true;
+        for (size_t i = 0u; i < route.size(); ++i) {
+            Segment const segment = Compiler::Feasibility::getSegment(
+                route.path(), route.targetTimes(), route.turnTimes(), i);
+            auto const speed = Compiler::Feasibility::getRequiredSpeed(segment);
+            std::string_view const note = problem(segment);
+
+            uint const flags = route.path()[i].flags;
+            std::println("{:>4} {:>6.1f} cm {:>6.3f} s {:>6.3f} s {:>6.3f} s {:>9} {}{}{}  {}", i,
+                         segment.distance, segment.targetTime, segment.turnTime, segment.driveTime,
+                         speed ? std::format("{:.1f} cm/s", *speed) : "-",
+                         flags & Path::REVERSE ? 'R' : '-', flags & Path::STOP ? 'S' : '-',
+                         route.commands()[i].targetTime ? 'T' : '-', note);
+
+            distance += segment.distance;
+            turnTime += segment.turnTime;
+            if (route.commands()[i].targetTime) forcedTime += *route.commands()[i].targetTime;
+            feasible = feasible && note.empty();
+        }
+
+        float const driveTime = route.targetTime() - turnTime - forcedTime;
+        std::println("\n{:.1f} cm in {:.2f} s: {:.2f} s of turns, {:.2f} s set by TIME, {:.2f} s "
+                     "left to drive",
+                     distance, route.targetTime(), turnTime, forcedTime, driveTime);
+        std::println("{}", feasible ? "feasible" : "NOT feasible, the robot will run late");
+        return feasible;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-report [--target-time <s>] [<commands>]\n"
+                     "\n"
+                     "compiles a route, Competition::COMMANDS unless a file in the same syntax\n"
+                     "is given, and prints the distance, target time, turn budget and the speed\n"
+                     "each segment needs. fails if any segment is beyond the robot profile's\n"
+                     "limits\n"
+                     "\n"
+                     "flags are R reverse, S stop and T a fixed TIME");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    std::optional<float> targetTime{};
+    std::optional<std::string> filename{};
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        bool const hasValue = i + 1u < arguments.size();
+
+        if (argument == "--target-time" && hasValue) targetTime = std::stof(arguments[++i]);
+        else if (argument.starts_with("--") || filename) {
+            usage();
+            return 1;
+        } else filename = argument;
+    }
+
+    // the route is too big for the stack
+    static Route route{ Competition::COMMANDS, Competition::TARGET_TIME };
+
+    if (filename) {
+        std::ifstream file{ *filename };
+        if (!file) {
+            std::println(stderr, "cannot open {}", *filename);
+            return 1;
+        }
+
+        std::stringstream source{};
+        source << file.rdbuf();
+
+        auto const commands = CommandParser::parse(source.str());
+        if (!commands) {
+            std::println(stderr, "{}: {}", *filename, commands.error());
+            return 1;
+        }
+        if (!route.setCommands(*commands)) {
+            std::println(stderr, "{}: {} commands, the robot holds between 1 and {}", *filename,
+                         commands->size(), Route::CAPACITY);
+            return 1;
+        }
+    }
+
+    if (targetTime && !route.setTargetTime(*targetTime)) {
+        std::println(stderr, "target time must be positive");
+        return 1;
+    }
+
+    return report(route) ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "route/Grid.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using Grid::Cell;
+    using Grid::Direction;
+
+    uint8_t bit(Direction direction) {
+        return static_cast<uint8_t>(1u << static_cast<int>(direction));
+    }
+
+    std::vector<std::string_view> drawingLines(std::string_view source) {
+        std::vector<std::string_view> lines{};
+        while (!source.empty()) {
+            size_t const end = std::min(source.find('\n'), source.size());
+            std::string_view line = source.substr(0u, end);
+            source.remove_prefix(std::min(end + 1u, source.size()));
+
+            if (line.ends_with('\r')) line.remove_suffix(1u);
+            if (line.starts_with('#')) continue;
+            if (line.find_first_not_of(' ') == std::string_view::npos) continue;
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+Cell Grid::Cell::step(Direction direction) const {
+    switch (direction) {
+    case Direction::UP: return { x, y + 1 };
+    case Direction::RIGHT: return { x + 1, y };
+    case Direction::DOWN: return { x, y - 1 };
+    case Direction::LEFT: return { x - 1, y };
+    }
+    return *this;
+}
+
+Cell Grid::Course::cell(size_t index) const {
+    return { static_cast<int>(index) % m_width, static_cast<int>(index) / m_width };
+}
+
+bool Grid::Course::open(Cell cell, Direction direction) const {
+    return (m_walls[index(cell)] & bit(direction)) == 0u;
+}
+
+std::expected<Grid::Course, std::string> Grid::parse(std::string_view source) {
+    std::vector<std::string_view> const lines = drawingLines(source);
+    size_t width = 0u;
+    for (std::string_view line : lines) width = std::max(width, line.size());
+
+    if (lines.size() < 3u || lines.size() % 2u == 0u || width < 3u)
+        return std::unexpected{ std::string{ "the drawing needs a wall line above and below "
+                                             "every row of squares" } };
+
+    // lines may stop short of the right hand wall, anything missing is open
+    auto const at = [&](size_t row, size_t column) {
+        return column < lines[row].size() ? lines[row][column] : ' ';
+    };
+
+    Course course{};
+    course.m_width = static_cast<int>((width - 1u) / 2u);
+    course.m_height = static_cast<int>((lines.size() - 1u) / 2u);
+    course.m_squares.resize(static_cast<size_t>(course.m_width * course.m_height));
+    course.m_walls.resize(course.m_squares.size());
+
+    std::optional<Cell> target{};
+    std::optional<Cell> start{};
+    for (int y = 0; y < course.m_height; ++y) {
+        for (int x = 0; x < course.m_width; ++x) {
+            Cell const cell{ x, y };
+            size_t const row = static_cast<size_t>(2 * (course.m_height - 1 - y) + 1);
+            size_t const column = static_cast<size_t>(2 * x + 1);
+
+            Square square{};
+            switch (at(row, column)) {
+            case '.':
+            case ' ': square = Square::OPEN; break;
+            case 'G': square = Square::GATE; break;
+            case 'P': square = Square::PENALTY; break;
+            case 'T': square = Square::TARGET; break;
+            default:
+                return std::unexpected{ std::format("unknown square '{}' at line {}, column {}",
+                                                    at(row, column), row + 1u, column + 1u) };
+            }
+            course.m_squares[course.index(cell)] = square;
+
+            if (square == Square::GATE) course.m_gates.push_back(cell);
+            if (square == Square::TARGET) {
+                if (target) return std::unexpected{ std::string{ "more than one target" } };
+                target = cell;
+            }
+
+            // the edge of the track is always a wall, an S on it marks the way in instead
+            auto const wall = [&](Direction direction, size_t wallRow, size_t wallColumn,
+                                  bool edge) -> std::optional<std::string> {
+                char const mark = at(wallRow, wallColumn);
+                if (mark == 'S') {
+                    if (!edge)
+                        return std::format("start inside the track at line {}", wallRow + 1u);
+                    if (start) return std::string{ "more than one start" };
+
+                    start = cell;
+                    // the robot drives in against the side it starts on
+                    course.m_entry = Grid::DIRECTIONS[(static_cast<size_t>(direction) + 2u) % 4u];
+                }
+                if (edge || mark != ' ') course.m_walls[course.index(cell)] |= bit(direction);
+                return std::nullopt;
+            };
+
+            for (auto const& error :
+                 { wall(Direction::UP, row - 1u, column, y == course.m_height - 1),
+                   wall(Direction::DOWN, row + 1u, column, y == 0),
+                   wall(Direction::LEFT, row, column - 1u, x == 0),
+                   wall(Direction::RIGHT, row, column + 1u, x == course.m_width - 1) })
+                if (error) return std::unexpected{ *error };
+        }
+    }
+
+    if (!target) return std::unexpected{ std::string{ "no target" } };
+    if (!start) return std::unexpected{ std::string{ "no start on the edge of the track" } };
+
+    course.m_target = *target;
+    course.m_start = *start;
+    return course;
+}
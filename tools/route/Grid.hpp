@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// the track drawn as text, one character per square with the walls between them, e.g.
+//     +-+-+-+-+
+//     |G . . .|
+//     + +-+ + +
+//     |. .|P T|
+//     + + + + +
+//     |. . . .|
+//     +-+S+-+-+
+// . is an open square, G a gate the route has to drive through, P a penalty zone and T the
+// target. - and | are walls, the S on the border is where the robot drives in. lines starting
+// with # are comments
+namespace Grid {
+    enum class Direction : uint8_t { UP, RIGHT, DOWN, LEFT };
+    inline constexpr std::array<Direction, 4> DIRECTIONS{ Direction::UP, Direction::RIGHT,
+                                                          Direction::DOWN, Direction::LEFT };
+
+    enum class Square : uint8_t { OPEN, GATE, PENALTY, TARGET };
+
+    // x to the right and y up from the bottom left square, like the Compiler tokens
+    struct Cell {
+        int x{};
+        int y{};
+
+        Cell step(Direction direction) const;
+        bool operator==(Cell const&) const = default;
+    };
+
+    class Course {
+    public:
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        size_t size() const { return m_squares.size(); }
+
+        size_t index(Cell cell) const { return static_cast<size_t>(cell.y * m_width + cell.x); }
+        Cell cell(size_t index) const;
+
+        Square square(Cell cell) const { return m_squares[index(cell)]; }
+        // false for walls and the edge of the track
+        bool open(Cell cell, Direction direction) const;
+
+        // the square the robot drives into from the start and the direction it is going
+        Cell start() const { return m_start; }
+        Direction entry() const { return m_entry; }
+
+        Cell target() const { return m_target; }
+        std::vector<Cell> const& gates() const { return m_gates; }
+
+    private:
+        friend std::expected<Course, std::string> parse(std::string_view source);
+
+        int m_width{};
+        int m_height{};
+        std::vector<Square> m_squares{};
+        // a bit per direction, set where a wall blocks it
+        std::vector<uint8_t> m_walls{};
+
+        Cell m_start{};
+        Direction m_entry{};
+        Cell m_target{};
+        std::vector<Cell> m_gates{};
+    };
+
+    std::expected<Course, std::string> parse(std::string_view source);
+}
@@ -0,0 +1,535 @@
+#include "route/Solver.hpp"
+
+#include "Constants.hpp"
+
+#include "profiles/Robot.hpp"
+
+#include "route/Grid.hpp"
+
+#include "state/Radians.hpp"
+#include "state/Vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Grid::Cell;
+    using Grid::Direction;
+    using Solver::Move;
+
+    constexpr size_t MASK_BITS = 32u;
+    constexpr size_t MAX_GATES = MASK_BITS;
+
+    // for the potentials on the gates, the first step is a square's drive time
+    constexpr size_t POTENTIAL_ITERATIONS = 200u;
+    constexpr float POTENTIAL_STEP_DECAY = 0.97f;
+
+    // a direction forwards or in reverse
+    constexpr size_t MOVES = 2u * Grid::DIRECTIONS.size();
+    constexpr float UNREACHED = std::numeric_limits<float>::infinity();
+    constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    size_t index(Move move) {
+        return static_cast<size_t>(move.direction) * 2u + (move.reverse ? 1u : 0u);
+    }
+
+    Move move(size_t index) { return { Grid::DIRECTIONS[index / 2u], (index & 1u) != 0u }; }
+
+    Vec2 vector(Direction direction) {
+        switch (direction) {
+        case Direction::UP: return { 0.0f, 1.0f };
+        case Direction::RIGHT: return { 1.0f, 0.0f };
+        case Direction::DOWN: return { 0.0f, -1.0f };
+        case Direction::LEFT: return { -1.0f, 0.0f };
+        }
+        return {};
+    }
+
+    // the time to every square from one without turning, penalties counted for every square
+    // entered, UNREACHED past the walls. the same path back pays the penalty of the square it
+    // left instead of the one it reached
+    template <typename Penalty>
+    std::vector<float> distances(Grid::Course const& course, Cell from, float squareTime,
+                                 Penalty const& penalty) {
+        std::vector<float> distance(course.size(), UNREACHED);
+        std::priority_queue<std::pair<float, size_t>, std::vector<std::pair<float, size_t>>,
+                            std::greater<>>
+            open{};
+
+        distance[course.index(from)] = 0.0f;
+        open.push({ 0.0f, course.index(from) });
+        while (!open.empty()) {
+            auto const [cost, square] = open.top();
+            open.pop();
+            if (cost > distance[square]) continue;
+
+            Cell const cell = course.cell(square);
+            for (Direction direction : Grid::DIRECTIONS) {
+                if (!course.open(cell, direction)) continue;
+
+                size_t const next = course.index(cell.step(direction));
+                float const nextCost = cost + squareTime + penalty(next);
+                if (nextCost >= distance[next]) continue;
+
+                distance[next] = nextCost;
+                open.push({ nextCost, next });
+            }
+        }
+        return distance;
+    }
+
+    // the quickest drive from one square and move to every square and move, square * MOVES +
+    // move, with the way back and the gates it drives through. the square it starts on is
+    // already paid for
+    struct Segments {
+        std::vector<float> costs{};
+        std::vector<uint32_t> parents{};
+        std::vector<uint32_t> gates{};
+    };
+
+    struct Node {
+        float cost{ UNREACHED };
+        uint32_t parent{ NONE };
+        bool closed{ false };
+    };
+
+    struct Open {
+        float estimate{};
+        float cost{};
+        uint32_t at{};
+
+        // among equal estimates the one furthest along first, or the plateaus of equally good
+        // gate orders would all be opened before any of them finished
+        bool operator>(Open const& other) const {
+            return estimate > other.estimate || (estimate == other.estimate && cost < other.cost);
+        }
+    };
+
+    // the moves of the segment that ends on at, the first move after from to at itself
+    void unwind(Segments const& segments, size_t from, size_t at, std::vector<Move>& moves) {
+        std::vector<Move> segment{};
+        for (; at != from; at = segments.parents[at]) segment.push_back(move(at % MOVES));
+        moves.insert(moves.end(), segment.rbegin(), segment.rend());
+    }
+}
+
+float Solver::turnTime(Move previous, Move next) {
+    constexpr float MAX_SPEED = Robot::Manager::Rotation::MAX_SPEED;
+    constexpr float TURN_TIME_OFFSET = Robot::Manager::Rotation::TURN_TIME_OFFSET;
+
+    // Compiler::compile only stops, and so only turns on the spot, where the direction reverses
+    // or the robot switches between driving forwards and in reverse
+    Vec2 const previousVector = vector(previous.direction);
+    Vec2 const nextVector = vector(next.direction);
+    if (Vec2::dot(previousVector, nextVector) >= 0.0f && previous.reverse == next.reverse)
+        return 0.0f;
+
+    Radians angle1{ nextVector.angle() };
+    Radians angle2{ previousVector.angle() };
+
+    if (next.reverse) angle1 += Constants::PI;
+    if (previous.reverse) angle2 += Constants::PI;
+
+    float angle = angle1 - angle2;
+    if (angle < 0.0f) angle = -angle;
+
+    return angle > 1.0e-6f ? angle / MAX_SPEED + TURN_TIME_OFFSET : 0.0f;
+}
+
+std::optional<Solver::Solution> Solver::solve(Grid::Course const& course, Costs const& costs) {
+    std::vector<Cell> const& gates = course.gates();
+    if (gates.size() > MAX_GATES) return std::nullopt;
+
+    uint32_t const allGates = gates.size() == MAX_GATES ? ~0u : (1u << gates.size()) - 1u;
+    std::vector<uint32_t> gateBits(course.size(), 0u);
+    for (size_t i = 0u; i < gates.size(); ++i) gateBits[course.index(gates[i])] = 1u << i;
+
+    auto const penalty = [&](size_t square) {
+        return course.square(course.cell(square)) == Grid::Square::PENALTY ? costs.penaltyTime
+                                                                           : 0.0f;
+    };
+
+    // the gates and then the target, with the time from each of them to every square
+    size_t const points = gates.size() + 1u;
+    auto const point = [&](size_t i) { return i < gates.size() ? gates[i] : course.target(); };
+
+    std::vector<std::vector<float>> fromPoints{};
+    for (size_t i = 0u; i < points; ++i)
+        fromPoints.push_back(distances(course, point(i), costs.squareTime, penalty));
+
+    // and back, from a square to one of them
+    std::vector<std::vector<float>> toPoints(points, std::vector<float>(course.size()));
+    for (size_t i = 0u; i < points; ++i)
+        for (size_t square = 0u; square < course.size(); ++square)
+            toPoints[i][square] = fromPoints[i][square] - penalty(square) +
+                                  penalty(course.index(point(i)));
+    auto const toPoint = [&](size_t square, size_t i) { return toPoints[i][square]; };
+
+    // the quicker way between every pair, a lower bound on a segment either way
+    std::vector<float> between(points * points, 0.0f);
+    for (size_t i = 0u; i < points; ++i)
+        for (size_t j = 0u; j < points; ++j)
+            between[i * points + j] = std::min(fromPoints[i][course.index(point(j))],
+                                               toPoint(course.index(point(i)), j));
+
+    // after the first gate it owes, a route still has to join the rest of them up and then
+    // leave one of them for the target, so their minimum spanning tree and the quickest way
+    // from any of them to the target bound what is left. every gate owed also carries a
+    // potential, added to each way in or out of it and taken back twice since the route
+    // passes through it, which leaves the bound valid whatever the potentials are. prim, once
+    // per gate set reached, counting how often each gate is used when asked
+    std::vector<float> potentials(gates.size(), 0.0f);
+    auto const weight = [&](size_t from, size_t to) {
+        return between[from * points + to] + potentials[from] +
+               (to < gates.size() ? potentials[to] : 0.0f);
+    };
+
+    auto const tree = [&](uint32_t owed, std::vector<int>* degrees) -> std::optional<float> {
+        if (owed == 0u) return 0.0f;
+
+        std::vector<size_t> members{};
+        std::optional<size_t> last{};
+        float total = 0.0f;
+        for (uint32_t rest = owed; rest != 0u; rest &= rest - 1u) {
+            members.push_back(std::countr_zero(rest));
+            if (!last || weight(members.back(), gates.size()) < weight(*last, gates.size()))
+                last = members.back();
+            total -= 2.0f * potentials[members.back()];
+        }
+
+        if (!(between[*last * points + gates.size()] < UNREACHED)) return std::nullopt;
+        total += weight(*last, gates.size());
+        if (degrees) ++(*degrees)[*last];
+
+        std::vector<float> reach(members.size(), UNREACHED);
+        std::vector<size_t> parents(members.size(), 0u);
+        std::vector<bool> joined(members.size(), false);
+        joined[0] = true;
+        for (size_t i = 1u; i < members.size(); ++i)
+            if (between[members[0] * points + members[i]] < UNREACHED)
+                reach[i] = weight(members[0], members[i]);
+
+        for (size_t added = 1u; added < members.size(); ++added) {
+            std::optional<size_t> nearest{};
+            for (size_t i = 1u; i < members.size(); ++i)
+                if (!joined[i] && reach[i] < UNREACHED && (!nearest || reach[i] < reach[*nearest]))
+                    nearest = i;
+
+            if (!nearest) return std::nullopt;
+            joined[*nearest] = true;
+            total += reach[*nearest];
+            if (degrees) {
+                ++(*degrees)[members[*nearest]];
+                ++(*degrees)[members[parents[*nearest]]];
+            }
+
+            for (size_t i = 1u; i < members.size(); ++i) {
+                if (joined[i] || !(between[members[*nearest] * points + members[i]] < UNREACHED))
+                    continue;
+                float const distance = weight(members[*nearest], members[i]);
+                if (distance < reach[i]) {
+                    reach[i] = distance;
+                    parents[i] = *nearest;
+                }
+            }
+        }
+        return total;
+    };
+
+    // the potentials that make the bound from the start tightest, found by pushing gates the
+    // bound passes through other than twice up or down, held-karp style. fixed from then on, so
+    // the bound stays consistent across every set
+    {
+        size_t const from = course.index(course.start());
+        uint32_t const owed = allGates & ~gateBits[from];
+        std::vector<float> best = potentials;
+        std::optional<float> bestBound{};
+        float step = costs.squareTime;
+        for (size_t iteration = 0u; owed != 0u && iteration < POTENTIAL_ITERATIONS; ++iteration) {
+            std::vector<int> degrees(gates.size(), 0);
+            auto bound = tree(owed, &degrees);
+            std::optional<size_t> first{};
+            for (uint32_t rest = owed; rest != 0u; rest &= rest - 1u) {
+                size_t const gate = std::countr_zero(rest);
+                if (toPoint(from, gate) < UNREACHED &&
+                    (!first || toPoint(from, gate) + potentials[gate] <
+                                   toPoint(from, *first) + potentials[*first]))
+                    first = gate;
+            }
+            if (!bound || !first) break;
+            *bound += toPoint(from, *first) + potentials[*first];
+            ++degrees[*first];
+
+            if (!bestBound || *bound > *bestBound) {
+                bestBound = bound;
+                best = potentials;
+            }
+
+            bool path = true;
+            for (uint32_t rest = owed; rest != 0u; rest &= rest - 1u) {
+                size_t const gate = std::countr_zero(rest);
+                potentials[gate] += step * static_cast<float>(degrees[gate] - 2);
+                path = path && degrees[gate] == 2;
+            }
+            if (path) break;
+            step *= POTENTIAL_STEP_DECAY;
+        }
+        potentials = best;
+    }
+
+    std::array<std::array<float, MOVES>, MOVES> turns{};
+    for (size_t i = 0u; i < MOVES; ++i)
+        for (size_t j = 0u; j < MOVES; ++j) turns[i][j] = turnTime(move(i), move(j));
+
+    // the most arriving one way can cost over another in the turn before the next move,
+    // whichever it is. the next segment only depends on the arrival through that turn
+    std::array<std::array<float, MOVES>, MOVES> excess{};
+    for (size_t i = 0u; i < MOVES; ++i) {
+        for (size_t j = 0u; j < MOVES; ++j) {
+            excess[i][j] = turns[i][0] - turns[j][0];
+            for (size_t next = 1u; next < MOVES; ++next)
+                excess[i][j] = std::max(excess[i][j], turns[i][next] - turns[j][next]);
+        }
+    }
+
+    // dijkstra over (square, move), every turn and penalty priced
+    auto const drive = [&](size_t from) {
+        Segments segments{ std::vector<float>(course.size() * MOVES, UNREACHED),
+                           std::vector<uint32_t>(course.size() * MOVES, NONE),
+                           std::vector<uint32_t>(course.size() * MOVES, 0u) };
+        std::priority_queue<Open, std::vector<Open>, std::greater<>> open{};
+
+        segments.costs[from] = 0.0f;
+        open.push({ 0.0f, 0.0f, static_cast<uint32_t>(from) });
+        while (!open.empty()) {
+            Open const top = open.top();
+            open.pop();
+            if (top.cost > segments.costs[top.at]) continue;
+
+            Cell const cell = course.cell(top.at / MOVES);
+            for (Direction direction : Grid::DIRECTIONS) {
+                if (!course.open(cell, direction)) continue;
+                size_t const square = course.index(cell.step(direction));
+
+                for (bool reverse : { false, true }) {
+                    size_t const at = square * MOVES + index({ direction, reverse });
+                    float const cost = top.cost + costs.squareTime +
+                                       turns[top.at % MOVES][at % MOVES] + penalty(square);
+                    if (cost >= segments.costs[at]) continue;
+
+                    segments.costs[at] = cost;
+                    segments.parents[at] = top.at;
+                    segments.gates[at] = segments.gates[top.at] | gateBits[square];
+                    open.push({ cost, cost, static_cast<uint32_t>(at) });
+                }
+            }
+        }
+        return segments;
+    };
+
+    // the search itself runs over (gates visited, point, move), where a point is a gate, the
+    // start or the target, and a step is the quickest segment to a gate still owed, counting
+    // every gate it drives through. following the quickest route, each step can only get to
+    // the next gate it owes at least as soon, so nothing is lost. nodes are kept a block of
+    // moves per gate set and point, in the order they are reached, since most sets only ever
+    // get to a few of the points
+    size_t const startPoint = gates.size();
+    size_t const goalPoint = gates.size() + 1u;
+    size_t const searchPoints = gates.size() + 2u;
+
+    size_t const startSquare = course.index(course.start());
+    auto const square = [&](size_t point) {
+        return point == startPoint ? startSquare
+                                   : course.index(point == goalPoint ? course.target()
+                                                                     : gates[point]);
+    };
+
+    // the gates from every point but the target, nearest first
+    std::vector<std::vector<size_t>> nearest(goalPoint);
+    for (size_t point = 0u; point < goalPoint; ++point) {
+        for (size_t gate = 0u; gate < gates.size(); ++gate)
+            if (toPoint(square(point), gate) < UNREACHED) nearest[point].push_back(gate);
+        std::sort(nearest[point].begin(), nearest[point].end(), [&](size_t a, size_t b) {
+            return toPoint(square(point), a) + potentials[a] <
+                   toPoint(square(point), b) + potentials[b];
+        });
+    }
+
+    size_t const startFrom = startSquare * MOVES + index({ course.entry(), false });
+    Segments const fromStart = drive(startFrom);
+    std::vector<std::optional<Segments>> fromGateMoves(gates.size() * MOVES);
+
+    // every step reaches a new gate set, so a set keeps its tree and where its blocks are
+    // and the step only looks it up once
+    std::unordered_map<uint32_t, uint32_t> sets{};
+    std::vector<uint32_t> setGates{};
+    std::vector<std::optional<float>> setTrees{};
+    std::vector<uint32_t> setBlocks{};
+    auto const set = [&](uint32_t visited) {
+        auto const [found, inserted] = sets.try_emplace(
+            visited, static_cast<uint32_t>(setGates.size()));
+        if (inserted) {
+            setGates.push_back(visited);
+            setTrees.push_back(tree(allGates & ~visited, nullptr));
+            setBlocks.resize(setBlocks.size() + searchPoints, NONE);
+        }
+        return found->second;
+    };
+
+    std::vector<Node> nodes{};
+    std::vector<std::pair<uint32_t, size_t>> blockKeys{};
+    auto const node = [&](uint32_t set, size_t point, size_t move) {
+        uint32_t& block = setBlocks[set * searchPoints + point];
+        if (block == NONE) {
+            block = static_cast<uint32_t>(blockKeys.size());
+            blockKeys.emplace_back(set, point);
+            nodes.resize(nodes.size() + MOVES);
+        }
+        return static_cast<uint32_t>(block * MOVES + move);
+    };
+
+    // the nearest gate still owed, then the tree through them and on to the target, all without
+    // turning. consistent, since a segment to a gate takes at least as long as the nearest gate
+    // and reaching it leaves a tree at least as long as the one it was part of
+    auto const heuristic = [&](uint32_t set, size_t point) -> std::optional<float> {
+        uint32_t const owed = allGates & ~setGates[set];
+        if (owed == 0u) {
+            float const last = toPoint(square(point), gates.size());
+            if (!(last < UNREACHED)) return std::nullopt;
+            return last;
+        }
+
+        auto const first = std::find_if(nearest[point].begin(), nearest[point].end(),
+                                        [&](size_t gate) { return (owed & 1u << gate) != 0u; });
+        if (first == nearest[point].end() || !setTrees[set]) return std::nullopt;
+        return toPoint(square(point), *first) + potentials[*first] + *setTrees[set];
+    };
+
+    std::priority_queue<Open, std::vector<Open>, std::greater<>> open{};
+    auto const relax = [&](uint32_t at, float cost, float estimate, uint32_t parent) {
+        Node& next = nodes[at];
+        if (next.closed || next.cost <= cost) return;
+        next = { cost, parent };
+        open.push({ cost + estimate, cost, at });
+    };
+
+    // the drive in is the same for every route, only the square it reaches costs anything here
+    uint32_t const startSet = set(gateBits[startSquare]);
+    uint32_t const start = node(startSet, startPoint, startFrom % MOVES);
+    if (auto const estimate = heuristic(startSet, startPoint))
+        relax(start, penalty(startSquare), *estimate, start);
+
+    size_t expanded = 0u;
+    std::optional<uint32_t> goal{};
+    while (!open.empty()) {
+        Open const top = open.top();
+        open.pop();
+
+        if (nodes[top.at].closed || top.cost > nodes[top.at].cost) continue;
+        nodes[top.at].closed = true;
+        ++expanded;
+
+        auto const [current, point] = blockKeys[top.at / MOVES];
+        uint32_t const visited = setGates[current];
+        size_t const move = top.at % MOVES;
+        if (point == goalPoint) {
+            goal = top.at;
+            break;
+        }
+
+        size_t const from = point == startPoint ? startFrom : square(point) * MOVES + move;
+        if (point != startPoint && !fromGateMoves[point * MOVES + move])
+            fromGateMoves[point * MOVES + move] = drive(from);
+        Segments const& segments = point == startPoint ? fromStart
+                                                       : *fromGateMoves[point * MOVES + move];
+
+        // LAST_MOVE has to be driven forwards
+        if (visited == allGates) {
+            for (Direction direction : Grid::DIRECTIONS) {
+                size_t const last = index({ direction, false });
+                float const cost = segments.costs[square(goalPoint) * MOVES + last];
+                if (cost < UNREACHED)
+                    relax(node(current, goalPoint, last), top.cost + cost, 0.0f, top.at);
+            }
+            continue;
+        }
+
+        uint32_t const owed = allGates & ~visited;
+        for (uint32_t rest = owed; rest != 0u; rest &= rest - 1u) {
+            size_t const gate = std::countr_zero(rest);
+            uint32_t const next = set(visited | 1u << gate);
+            auto const estimate = heuristic(next, gate);
+            if (!estimate) continue;
+
+            // driving through another gate owed on the way is never quicker than stopping there
+            // first, and an arrival is only worth it if no other one gets there soon enough to
+            // make up for any turn it leaves. ties keep the first, so one of them always stays
+            size_t const arrivals = square(gate) * MOVES;
+            auto const through = [&](size_t arrival) {
+                return (segments.gates[arrivals + arrival] & owed & ~(1u << gate)) != 0u;
+            };
+            auto const dominated = [&](size_t arrival) {
+                float const cost = segments.costs[arrivals + arrival];
+                for (size_t other = 0u; other < MOVES; ++other) {
+                    if (other == arrival || through(other)) continue;
+                    float const instead = segments.costs[arrivals + other] + excess[other][arrival];
+                    if (instead < cost || (instead == cost && other < arrival)) return true;
+                }
+                return false;
+            };
+
+            std::optional<uint32_t> block{};
+            for (size_t arrival = 0u; arrival < MOVES; ++arrival) {
+                float const cost = segments.costs[arrivals + arrival];
+                if (!(cost < UNREACHED) || through(arrival) || dominated(arrival)) continue;
+
+                if (!block) block = node(next, gate, 0u);
+                relax(*block + arrival, top.cost + cost, *estimate, top.at);
+            }
+        }
+    }
+
+    if (!goal) return std::nullopt;
+
+    std::vector<uint32_t> chain{};
+    for (uint32_t at = *goal; at != start; at = nodes[at].parent) chain.push_back(at);
+    std::reverse(chain.begin(), chain.end());
+
+    Solution solution{};
+    solution.expanded = expanded;
+    solution.moves.push_back({ course.entry(), false });
+
+    size_t from = startFrom;
+    Segments const* segments = &fromStart;
+    for (uint32_t at : chain) {
+        size_t const point = blockKeys[at / MOVES].second;
+        size_t const to = square(point) * MOVES + at % MOVES;
+        unwind(*segments, from, to, solution.moves);
+
+        from = to;
+        if (point != goalPoint) segments = &*fromGateMoves[point * MOVES + at % MOVES];
+    }
+
+    Cell cell = course.start();
+    solution.penaltyTime = penalty(startSquare);
+    for (size_t i = 1u; i < solution.moves.size(); ++i) {
+        float const turn = turnTime(solution.moves[i - 1u], solution.moves[i]);
+        solution.turns += turn > 0.0f ? 1u : 0u;
+        solution.turnTime += turn;
+
+        cell = cell.step(solution.moves[i].direction);
+        solution.penaltyTime += penalty(course.index(cell));
+        solution.driveTime += costs.squareTime;
+    }
+    return solution;
+}
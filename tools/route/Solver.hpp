@@ -0,0 +1,46 @@
+#pragma once
+
+#include "route/Grid.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// a* over (gates visited, gate last reached, last move), stepping along the quickest drive to
+// each gate still owed. a drive is a dijkstra over (square, last move) run once per gate and
+// arrival, where moves are one square in a direction, forwards or in reverse, and cost the drive
+// time plus the turn the firmware would stop for, priced exactly like
+// Compiler::TargetTime::getTurnTimes. the heuristic is a held-karp style bound on the gates
+// still owed that ignores turns, so it never overestimates since turns only add
+namespace Solver {
+    struct Costs {
+        // drive time for one square
+        float squareTime{};
+        // added every time the route enters a penalty zone
+        float penaltyTime{};
+    };
+
+    struct Move {
+        Grid::Direction direction{};
+        bool reverse{};
+
+        bool operator==(Move const&) const = default;
+    };
+
+    struct Solution {
+        // the first entry is the drive in from the start
+        std::vector<Move> moves{};
+        size_t turns{ 0u };
+        float driveTime{ 0.0f };
+        float turnTime{ 0.0f };
+        float penaltyTime{ 0.0f };
+        size_t expanded{ 0u };
+    };
+
+    // what getTurnTimes charges between two consecutive moves
+    float turnTime(Move previous, Move next);
+
+    // nothing when the target or a gate cannot be reached. the route has to end driving forwards
+    // so LAST_MOVE can stop the dowel on the target
+    std::optional<Solution> solve(Grid::Course const& course, Costs const& costs);
+}
@@ -0,0 +1,282 @@
+#include "Constants.hpp"
+
+#include "cli/CommandParser.hpp"
+
+#include "path/Competition.hpp"
+#include "path/Route.hpp"
+
+#include "route/Grid.hpp"
+#include "route/Solver.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <numeric>
+#include <print>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+    // a square a second, only the balance between driving and turning matters to the search
+    constexpr float DEFAULT_SPEED = 50.0f;
+    constexpr float DEFAULT_PENALTY_TIME = 5.0f;
+
+    // the size a track gets once the gates outnumber what anyone would draw by hand
+    struct BenchmarkCase {
+        size_t width{};
+        size_t height{};
+        size_t gates{};
+        uint32_t seed{};
+    };
+
+    constexpr BenchmarkCase BENCHMARK_CASES[]{
+        { 12u, 12u, 20u, 2u },  { 12u, 12u, 20u, 11u }, { 16u, 16u, 20u, 7u },
+        { 20u, 20u, 20u, 11u }, { 24u, 24u, 24u, 3u },  { 24u, 24u, 24u, 5u },
+        { 32u, 32u, 12u, 1u },  { 32u, 32u, 20u, 1u },  { 32u, 32u, 20u, 7u },
+    };
+    constexpr double BENCHMARK_LIMIT_MS = 1000.0;
+
+    std::string_view name(Grid::Direction direction) {
+        switch (direction) {
+        case Grid::Direction::UP: return "UP";
+        case Grid::Direction::RIGHT: return "RIGHT";
+        case Grid::Direction::DOWN: return "DOWN";
+        case Grid::Direction::LEFT: return "LEFT";
+        }
+        return "";
+    }
+
+    // the same tokens Competition::COMMANDS and rotour-cli upload take, runs in one direction
+    // merged into one command since the follower does not stop between them anyway
+    std::string commands(std::vector<Solver::Move> const& moves) {
+        std::vector<std::string> lines{};
+
+        Grid::Direction const entry = moves.front().direction;
+        if (entry == Grid::Direction::UP) lines.emplace_back("FIRST_MOVE");
+        else
+            lines.push_back(std::format("moveby((SQUARE_SIZE / 2.0f + DOWEL_DISTANCE) * {}) & "
+                                        "CENTIMETERS",
+                                        name(entry)));
+
+        for (size_t i = 1u; i < moves.size();) {
+            size_t run = 1u;
+            while (i + run < moves.size() && moves[i + run] == moves[i]) ++run;
+
+            std::string line = run == 1u ? std::format("moveby({})", name(moves[i].direction))
+                                         : std::format("moveby({}.0f * {})", run,
+                                                       name(moves[i].direction));
+            if (moves[i].reverse) line += " & REVERSE";
+            lines.push_back(line);
+            i += run;
+        }
+        lines.back() += " & LAST_MOVE";
+
+        std::string text{};
+        for (size_t i = 0u; i < lines.size(); ++i)
+            text += lines[i] + (i + 1u < lines.size() ? ",\n" : "\n");
+        return text;
+    }
+
+    // a walled in grid with a fifth of the inner walls up, the target, the gates and as many
+    // penalty zones as the grid is wide scattered over it, and the start bottom left. the
+    // generator is used raw so the same seed draws the same track on every standard library
+    std::string generate(BenchmarkCase const& benchmarkCase) {
+        std::mt19937 random{ benchmarkCase.seed };
+        size_t const columns = 2u * benchmarkCase.width + 1u;
+        size_t const rows = 2u * benchmarkCase.height + 1u;
+
+        std::vector<std::string> lines(rows, std::string(columns, ' '));
+        for (size_t row = 0u; row < rows; ++row) {
+            for (size_t column = 0u; column < columns; ++column) {
+                bool const edge = row == 0u || row + 1u == rows || column == 0u ||
+                                  column + 1u == columns;
+                bool const wall = edge || random() % 5u == 0u;
+                if (row % 2u == 0u && column % 2u == 0u) lines[row][column] = '+';
+                else if (row % 2u == 0u) lines[row][column] = wall ? '-' : ' ';
+                else if (column % 2u == 0u) lines[row][column] = wall ? '|' : ' ';
+                else lines[row][column] = '.';
+            }
+        }
+
+        std::vector<std::pair<size_t, size_t>> squares{};
+        for (size_t row = 1u; row < rows; row += 2u)
+            for (size_t column = 1u; column < columns; column += 2u)
+                squares.emplace_back(row, column);
+        for (size_t i = squares.size() - 1u; i > 0u; --i)
+            std::swap(squares[i], squares[random() % (i + 1u)]);
+
+        size_t const placed = 1u + benchmarkCase.gates + benchmarkCase.width;
+        for (size_t i = 0u; i < placed && i < squares.size(); ++i)
+            lines[squares[i].first][squares[i].second] =
+                i == 0u ? 'T' : i <= benchmarkCase.gates ? 'G' : 'P';
+        lines.back()[1] = 'S';
+
+        std::string text{};
+        for (std::string const& line : lines) text += line + "\n";
+        return text;
+    }
+
+    // fails when any of them takes longer than BENCHMARK_LIMIT_MS, a track with no route
+    // through every gate only reports it
+    int benchmark(Solver::Costs const& costs) {
+        bool passed = true;
+        for (BenchmarkCase const& benchmarkCase : BENCHMARK_CASES) {
+            std::string const name = std::format("{}x{}, {} gates, seed {}", benchmarkCase.width,
+                                                 benchmarkCase.height, benchmarkCase.gates,
+                                                 benchmarkCase.seed);
+            auto const course = Grid::parse(generate(benchmarkCase));
+            if (!course) {
+                std::println(stderr, "{}: {}", name, course.error());
+                return 1;
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            auto const solution = Solver::solve(*course, costs);
+            double const elapsed = std::chrono::duration<double, std::milli>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count();
+
+            passed = passed && elapsed <= BENCHMARK_LIMIT_MS;
+            if (solution)
+                std::println("{:<28} {:>6} squares {:>9} states {:>9.1f} ms", name,
+                             solution->moves.size(), solution->expanded, elapsed);
+            else std::println("{:<28} {:>6} no route {:>16} {:>9.1f} ms", name, "", "", elapsed);
+        }
+
+        if (!passed) std::println(stderr, "a search took longer than {} ms", BENCHMARK_LIMIT_MS);
+        return passed ? 0 : 1;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-route [--speed <cm/s>] [--penalty <s>] [--output <file>] "
+                     "<grid>\n"
+                     "       rotour-route [--speed <cm/s>] [--penalty <s>] --benchmark\n"
+                     "\n"
+                     "finds the quickest route through every gate to the target of a track drawn "
+                     "as\ntext and prints it as commands for Competition::COMMANDS or rotour-cli "
+                     "upload:\n"
+                     "\n"
+                     "    +-+-+-+-+\n"
+                     "    |G . . .|    . open square    G gate\n"
+                     "    + +-+ + +    P penalty zone   T target\n"
+                     "    |. .|P T|    - | walls        S where the robot drives in\n"
+                     "    + + + + +\n"
+                     "    |. . . .|\n"
+                     "    +-+S+-+-+\n"
+                     "\n"
+                     "--speed is the cruise speed the drive time is estimated with ({} cm/s by "
+                     "default)\n--penalty is the time a penalty zone is worth ({} s by default)\n"
+                     "--benchmark times the search on generated tracks with many gates and fails "
+                     "if\nany takes longer than {} ms",
+                     DEFAULT_SPEED, DEFAULT_PENALTY_TIME, BENCHMARK_LIMIT_MS);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    float speed = DEFAULT_SPEED;
+    float penaltyTime = DEFAULT_PENALTY_TIME;
+    std::string outputFilename{};
+    std::string gridFilename{};
+    bool benchmarking = false;
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        bool const hasValue = i + 1u < arguments.size();
+
+        if (argument == "--speed" && hasValue) speed = std::stof(arguments[++i]);
+        else if (argument == "--penalty" && hasValue) penaltyTime = std::stof(arguments[++i]);
+        else if (argument == "--output" && hasValue) outputFilename = arguments[++i];
+        else if (argument == "--benchmark") benchmarking = true;
+        else if (argument.starts_with("--") || !gridFilename.empty() || !(speed > 0.0f)) {
+            usage();
+            return 1;
+        } else gridFilename = argument;
+    }
+
+    Solver::Costs const costs{ Track::SQUARE_SIZE / speed, penaltyTime };
+    if (benchmarking && gridFilename.empty() && outputFilename.empty()) return benchmark(costs);
+
+    if (gridFilename.empty() || benchmarking) {
+        usage();
+        return 1;
+    }
+
+    std::ifstream file{ gridFilename };
+    if (!file) {
+        std::println(stderr, "cannot open {}", gridFilename);
+        return 1;
+    }
+    std::stringstream source{};
+    source << file.rdbuf();
+
+    auto const course = Grid::parse(source.str());
+    if (!course) {
+        std::println(stderr, "{}: {}", gridFilename, course.error());
+        return 1;
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const solution = Solver::solve(*course, costs);
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!solution) {
+        std::println(stderr, "{}: no route reaches the target through every gate", gridFilename);
+        return 1;
+    }
+
+    std::string const text = commands(solution->moves);
+
+    // compiled the way the robot will, so the turns are the firmware's and not only the search's
+    auto const parsed = CommandParser::parse(text);
+    static Route route{ Competition::COMMANDS, Competition::TARGET_TIME };
+    if (!parsed || parsed->size() > Route::CAPACITY || !route.setCommands(*parsed)) {
+        std::println(stderr, "{}: the route does not fit in the robot", gridFilename);
+        return 1;
+    }
+
+    float const compiledTurnTime = std::accumulate(route.turnTimes().begin(),
+                                                   route.turnTimes().end(), 0.0f);
+    if (std::fabs(compiledTurnTime - solution->turnTime) > 1.0e-3f) {
+        std::println(stderr, "the search priced the turns at {} s but they compile to {} s",
+                     solution->turnTime, compiledTurnTime);
+        return 1;
+    }
+
+    // the drive in reaches the middle of the first square and LAST_MOVE leaves half of the last
+    float const driveTime = solution->driveTime + 0.5f * costs.squareTime;
+    std::println(stderr,
+                 "{} squares, {} turns, {} commands: about {:.2f} s driving at {} cm/s and {:.2f} "
+                 "s turning{}",
+                 solution->moves.size(), solution->turns, parsed->size(), driveTime, speed,
+                 compiledTurnTime,
+                 solution->penaltyTime > 0.0f
+                     ? std::format(", {:.0f} s of penalties", solution->penaltyTime)
+                     : std::string{});
+    std::println(stderr, "searched {} states in {:.1f} ms", solution->expanded,
+                 std::chrono::duration<double, std::milli>(elapsed).count());
+
+    if (outputFilename.empty()) {
+        std::print("{}", text);
+        return 0;
+    }
+
+    std::ofstream output{ outputFilename };
+    output << text;
+    if (!output) {
+        std::println(stderr, "cannot write {}", outputFilename);
+        return 1;
+    }
+    return 0;
+}
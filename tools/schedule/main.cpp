@@ -0,0 +1,248 @@
+#include "Constants.hpp"
+
+#include "drivers/PwmTiming.hpp"
+
+#include "profiles/Robot.hpp"
+
+#include "scheduling/Simulation.hpp"
+#include "scheduling/Task.hpp"
+#include "scheduling/Tasks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace {
+    constexpr uint64_t DEFAULT_HORIZON_MS = 1000u;
+
+    // 56 bits at 40 ns through the pio plus the dma, then the interrupt entry when data ready
+    // drives the loop
+    constexpr double GYROSCOPE_LATENCY_US = 3.0;
+    constexpr double INTERRUPT_LATENCY_US = 0.5;
+
+    // a quarter second turn at the follower's turning speed with 50 ms ramps either side
+    constexpr double TURN_RAMP_TIME = 0.05;
+    constexpr double TURN_HOLD_TIME = 0.2;
+    constexpr double TURN_DURATION_US = (4.0 * TURN_RAMP_TIME + TURN_HOLD_TIME) * 1.0e6;
+
+    double turn(double time) {
+        double const speed = Robot::Manager::Straight::TURN_ANGULAR_SPEED;
+        double const up = (time - TURN_RAMP_TIME) / TURN_RAMP_TIME;
+        double const down = (3.0 * TURN_RAMP_TIME + TURN_HOLD_TIME - time) / TURN_RAMP_TIME;
+        return speed * std::clamp(std::min(up, down), 0.0, 1.0);
+    }
+
+    // how the fast loop sees the gyroscope under each mode over the same turn
+    int aliasing() {
+        double const samplePeriodUs = 1.0e6 / Integration::TARGET_FAST_LOOP_HZ;
+        double const timerPeriodUs = static_cast<double>(Integration::FAST_LOOP_US);
+
+        std::println("{:<11} {:>7} {:>7} {:>7} {:>9} {:>9} {:>14}", "mode", "ticks", "reused",
+                     "skipped", "mean age", "max age", "heading error");
+
+        auto const print = [](std::string_view mode, Simulation::Sampling const& sampling) {
+            std::println("{:<11} {:>7} {:>7} {:>7} {:>6.2f} us {:>6.2f} us {:>10.3g} rad", mode,
+                         sampling.ticks, sampling.reused, sampling.skipped, sampling.meanAgeUs,
+                         sampling.maxAgeUs, sampling.headingError);
+        };
+
+        print("timer", Simulation::sample(samplePeriodUs, timerPeriodUs, 0.0, GYROSCOPE_LATENCY_US,
+                                          TURN_DURATION_US, turn));
+        print("data ready", Simulation::sample(samplePeriodUs, samplePeriodUs,
+                                               GYROSCOPE_LATENCY_US + INTERRUPT_LATENCY_US,
+                                               GYROSCOPE_LATENCY_US, TURN_DURATION_US, turn));
+        return 0;
+    }
+
+    // the rp2350's default clk_sys, and the conversions the current sensor paces each period
+    constexpr uint32_t SYS_CLOCK_HZ = 150'000'000u;
+    constexpr uint32_t CONVERSIONS = 3u;
+
+    struct PacedPeriod {
+        double centre{};
+        std::optional<uint64_t> start{};
+        std::optional<uint64_t> stop{};
+    };
+
+    // steps the motor and both pacing slices count by count from the edge that enables them, for
+    // the first few periods. the drive pulse is where the motor count is at or above the level,
+    // a pacing slice wraps when its count goes from sampleWrap back to 0
+    std::array<PacedPeriod, 3> stepCounters(PwmTiming::Timing const& timing, uint16_t wrap,
+                                            uint32_t level) {
+        std::array<PacedPeriod, 3> periods{};
+        std::array<std::optional<uint64_t>, 3> pulseStarts{};
+        uint32_t start = timing.startCounter;
+        uint32_t stop = timing.stopCounter;
+
+        for (uint64_t count = 0u; count < periods.size() * timing.periodCounts; ++count) {
+            size_t const period = count / timing.periodCounts;
+            uint32_t const phase = count % timing.periodCounts;
+            uint32_t const motor = phase <= wrap ? phase : timing.periodCounts - 1u - phase;
+
+            if (motor >= level && !pulseStarts[period]) pulseStarts[period] = count;
+            if (motor >= level) periods[period].centre = (*pulseStarts[period] + count) / 2.0;
+
+            start = start == timing.sampleWrap ? 0u : start + 1u;
+            stop = stop == timing.sampleWrap ? 0u : stop + 1u;
+            if (start == 0u) periods[period].start = count + 1u;
+            if (stop == 0u) periods[period].stop = count + 1u;
+        }
+        return periods;
+    }
+
+    // where the paced conversions land against the drive pulses for a spread of pwm frequencies
+    // and wraps, the firmware's starred. the counts are stepped through rather than trusted, and
+    // every combination the hardware can count has to put the currents within a count of the
+    // centre and the stop inside the last conversion
+    int pwm() {
+        constexpr std::array<uint32_t, 5> FREQUENCIES{ 2'000u, 4'000u, 8'000u, 16'000u, 20'000u };
+        constexpr std::array<uint16_t, 4> WRAPS{ 16383u, 4095u, 1023u, 255u };
+
+        std::println("{:>7} {:>6} {:>8} {:>9} {:>6} {:>6} {:>9} {:>9} {:>8}  {}", "target", "wrap",
+                     "divider", "actual", "start", "stop", "left", "right", "stop at", "result");
+
+        bool failed = false;
+        for (uint32_t frequency : FREQUENCIES) {
+            for (uint16_t wrap : WRAPS) {
+                bool const firmware = frequency == Drivers::Motors::PWM_FREQUENCY &&
+                                      wrap == Drivers::Motors::PWM_WRAP;
+                uint32_t const divider = PwmTiming::divider(
+                    SYS_CLOCK_HZ, frequency * (static_cast<uint32_t>(wrap) + 1u));
+                auto const timing = PwmTiming::timing(SYS_CLOCK_HZ, divider, wrap, CONVERSIONS);
+
+                std::string const name = std::format("{}{}", frequency, firmware ? "*" : "");
+                if (!timing) {
+                    std::println("{:>7} {:>6} {:>8}  {}", name, wrap, "-",
+                                 divider == 0u ? "clk_sys does not divide to it" : "cannot pace");
+                    failed |= firmware;
+                    continue;
+                }
+
+                double const countHz = SYS_CLOCK_HZ * 16.0 / divider;
+                double const countUs = 1.0e6 / countHz;
+                double const conversion = PwmTiming::CONVERSION_CYCLES * countHz /
+                                          PwmTiming::ADC_CLOCK_HZ;
+
+                // a quarter duty, the pulse centre does not move with it
+                uint32_t const level = (static_cast<uint32_t>(wrap) + 1u) * 3u / 4u;
+                auto const periods = stepCounters(*timing, wrap, level);
+
+                double left{};
+                double right{};
+                double stopAt{};
+                bool ok = true;
+                for (PacedPeriod const& period : periods) {
+                    if (!period.start || !period.stop || *period.stop < *period.start) {
+                        ok = false;
+                        break;
+                    }
+                    left = static_cast<double>(*period.start) - period.centre;
+                    right = left + conversion;
+                    stopAt = static_cast<double>(*period.stop - *period.start) / conversion;
+                    ok &= std::fabs((left + right) / 2.0) <= 1.0;
+                    ok &= stopAt > CONVERSIONS - 1u && stopAt < CONVERSIONS;
+                }
+                failed |= !ok;
+
+                std::println("{:>7} {:>6} {:>8.4f} {:>6.0f} Hz {:>6} {:>6} {:>6.2f} us {:>6.2f} us "
+                             "{:>8.2f}  {}",
+                             name, wrap, divider / 16.0, countHz / timing->periodCounts,
+                             timing->startCounter, timing->stopCounter, left * countUs,
+                             right * countUs, stopAt, ok ? "ok" : "FAILED");
+            }
+        }
+        return failed ? 1 : 0;
+    }
+
+    std::optional<size_t> find(std::string_view name) {
+        for (size_t i = 0u; i < Tasks::COUNT; ++i)
+            if (Tasks::TABLE[i].name == name) return i;
+        return std::nullopt;
+    }
+
+    void usage() {
+        std::println(stderr, "usage: rotour-schedule [--duration <ms>] <task>=<us>...\n"
+                             "       rotour-schedule --aliasing\n"
+                             "       rotour-schedule --pwm\n\n"
+                             "simulates the firmware task table with the given worst case run "
+                             "times and fails\nif any task overruns, compares how the timer "
+                             "and data ready fast loops\nsample the gyroscope, or checks where "
+                             "the pwm paced current samples land for\na spread of pwm "
+                             "frequencies and wraps. tasks:");
+        for (TaskSpec const& spec : Tasks::TABLE)
+            std::println(stderr, "  {:<12} every {} us on core {}", spec.name, spec.periodUs,
+                         spec.core);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+    if (arguments.size() == 1u && std::string_view{ arguments[0] } == "--aliasing")
+        return aliasing();
+    if (arguments.size() == 1u && std::string_view{ arguments[0] } == "--pwm") return pwm();
+
+    uint64_t horizonMs = DEFAULT_HORIZON_MS;
+    std::array<uint32_t, Tasks::COUNT> durations{};
+    std::array<bool, Tasks::COUNT> given{};
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+
+        if (argument == "--duration" && i + 1u < arguments.size()) {
+            horizonMs = std::stoull(arguments[++i]);
+            continue;
+        }
+
+        size_t const separator = argument.find('=');
+        auto const id = find(argument.substr(0u, separator));
+        if (separator == std::string_view::npos || !id) {
+            usage();
+            return 1;
+        }
+
+        std::string const duration{ argument.substr(separator + 1u) };
+        durations[*id] = static_cast<uint32_t>(std::stoul(duration));
+        given[*id] = true;
+    }
+
+    for (size_t i = 0u; i < Tasks::COUNT; ++i) {
+        if (given[i]) continue;
+        std::println(stderr, "no run time for {}", Tasks::TABLE[i].name);
+        usage();
+        return 1;
+    }
+
+    auto const stats = Simulation::run(Tasks::TABLE, durations, horizonMs * 1000u);
+
+    std::println("{:<12} {:>4} {:>7} {:>6} {:>5} {:>8} {:>8} {:>9} {:>6}", "task", "core",
+                 "period", "phase", "run", "runs", "overruns", "worst rsp", "load");
+
+    bool passed = true;
+    std::array<float, 2> coreLoad{};
+    for (size_t i = 0u; i < Tasks::COUNT; ++i) {
+        TaskSpec const& spec = Tasks::TABLE[i];
+        float const load = stats[i].load(spec.periodUs);
+
+        std::println("{:<12} {:>4} {:>7} {:>6} {:>5} {:>8} {:>8} {:>9} {:>5.1f}%", spec.name,
+                     spec.core, spec.periodUs, spec.phaseUs, durations[i], stats[i].runs,
+                     stats[i].overruns, stats[i].maxLatenessUs + stats[i].maxDurationUs,
+                     load * 100.0f);
+
+        coreLoad[spec.core] += static_cast<float>(durations[i]) / static_cast<float>(spec.periodUs);
+        passed = passed && stats[i].overruns == 0u;
+    }
+
+    for (size_t core = 0u; core < coreLoad.size(); ++core)
+        std::println("core {} demand {:.1f}%", core, coreLoad[core] * 100.0f);
+
+    return passed ? 0 : 1;
+}
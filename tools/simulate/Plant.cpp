@@ -0,0 +1,133 @@
+#include "simulate/Plant.hpp"
+
+#include "Constants.hpp"
+
+#include "state/Vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // the friction torque comes in over this wheel speed instead of as a step at standstill
+    constexpr float FRICTION_SPEED = 0.5f;
+    // the tyre force saturates at the friction over this much sliding in m/s, and counts as a slip
+    // once it has
+    constexpr float SLIP_SPEED = 0.01f;
+    constexpr float SATURATED_SLIP_SPEED = 3.0f * SLIP_SPEED;
+
+    constexpr float GRAVITY = 9.81f;
+
+    // copper gains about 0.4 % per kelvin, this is a motor 75 k warmer
+    constexpr float RESISTANCE_DRIFT = 0.3f;
+    constexpr float FREE_CURRENT_DRIFT = 1.0f;
+
+    constexpr float ENCODER_STEP = 2.0f * Constants::PI / 16384.0f;
+    // a 12 bit adc over 3.3 v, through the divider for the battery and at 5 a/v for the currents
+    constexpr float ADC_STEP = 3.3f / 4095.0f;
+    constexpr float VOLTAGE_STEP = ADC_STEP / Drivers::Battery::DIVIDER_VALUE;
+    constexpr float CURRENT_STEP = ADC_STEP * 5.0f;
+
+    constexpr float CENTIMETERS = 100.0f;
+}
+
+Plant::Plant(Model const& model, float batteryVoltage, float batteryResistance, float friction)
+    : m_model{ model },
+      m_resistance{ model.resistance },
+      m_freeCurrent{ model.freeCurrent },
+      m_batteryVoltage{ batteryVoltage },
+      m_batteryResistance{ batteryResistance },
+      m_friction{ friction },
+      m_terminalVoltage{ batteryVoltage } {}
+
+void Plant::step(Vec2 const& power, float dt) {
+    // each wheel carries half the weight
+    float const grip = m_friction * m_model.mass * GRAVITY / 2.0f;
+
+    auto const duty = [](float motorPower) {
+        return std::clamp(motorPower / static_cast<float>(Drivers::Motors::MAX_POWER), -1.0f,
+                          1.0f);
+    };
+    auto const friction = [](float freeCurrent, float speed) {
+        return freeCurrent * std::tanh(speed / FRICTION_SPEED);
+    };
+    auto const traction = [&](float slipSpeed) { return grip * std::tanh(slipSpeed / SLIP_SPEED); };
+
+    // each motor draws duty (duty terminal - emf) / resistance from the pack, which sags by its
+    // resistance times their sum, linear in the terminal voltage so solved for it directly
+    Vec2 const duties = Vec2::transform(duty, power);
+    Vec2 const emfs = m_wheelSpeeds / m_model.kv;
+    m_terminalVoltage = (m_batteryVoltage +
+                         m_batteryResistance * Vec2::dot(duties, emfs / m_resistance)) /
+                        (1.0f + m_batteryResistance * Vec2::dot(duties, duties / m_resistance));
+
+    // the gearbox is folded into kv, so the torque constant at the wheel is its inverse
+    m_current = (duties * m_terminalVoltage - emfs) / m_resistance;
+    Vec2 const torques = (m_current - Vec2::transform(friction, m_freeCurrent, m_wheelSpeeds)) /
+                         m_model.kv;
+    Vec2 const forces = Vec2::transform(traction, slipSpeeds());
+
+    // where the copper losses would settle each winding, lagged by its time constant
+    Vec2 const settled = m_current * m_current * m_resistance * m_model.thermalResistance;
+    m_temperatures += (settled - m_temperatures) * (dt / m_model.thermalTimeConstant);
+
+    m_wheelSpeeds += (torques - forces * m_model.wheelRadius) / m_model.wheelInertia * dt;
+    m_linearVelocity += (forces.x + forces.y) / m_model.mass * dt;
+    m_angularVelocity += (forces.y - forces.x) * m_model.halfAxle / m_model.yawInertia * dt;
+
+    m_heading += m_angularVelocity * dt;
+    m_position += Vec2{ std::cos(m_heading), std::sin(m_heading) } * m_linearVelocity *
+                  CENTIMETERS * dt;
+
+    // kept to a turn so the small steps are not lost against a large angle
+    m_wheelAngles += m_wheelSpeeds * dt;
+    m_wheelAngles.transform(
+        [](float angle) { return std::remainder(angle, 2.0f * Constants::PI); });
+}
+
+void Plant::setDrift(float drift) {
+    m_resistance = m_model.resistance * (1.0f + RESISTANCE_DRIFT * drift);
+    m_freeCurrent = m_model.freeCurrent * (1.0f + FREE_CURRENT_DRIFT * drift);
+}
+
+// both wheels averaged. kS holds the friction current, kV the back emf and kA the current for the
+// torque that speeds up the chassis and the wheels
+Feedforward Plant::linearFeedforward() const {
+    float const resistance = (m_resistance.x + m_resistance.y) / 2.0f;
+    float const kv = (m_model.kv.x + m_model.kv.y) / 2.0f;
+    float const freeCurrent = (m_freeCurrent.x + m_freeCurrent.y) / 2.0f;
+    float const wheelRadius = m_model.wheelRadius;
+
+    float const torquePerAccel = m_model.mass * wheelRadius / 2.0f +
+                                 m_model.wheelInertia / wheelRadius;
+    return { freeCurrent * resistance, 1.0f / (kv * wheelRadius * CENTIMETERS),
+             torquePerAccel * kv * resistance / CENTIMETERS };
+}
+
+bool Plant::slipping() const {
+    Vec2 const slipSpeeds = this->slipSpeeds();
+    return std::max(std::abs(slipSpeeds.x), std::abs(slipSpeeds.y)) > SATURATED_SLIP_SPEED;
+}
+
+Vec2 Plant::slipSpeeds() const {
+    return { m_wheelSpeeds.x * m_model.wheelRadius -
+                 (m_linearVelocity - m_angularVelocity * m_model.halfAxle),
+             m_wheelSpeeds.y * m_model.wheelRadius -
+                 (m_linearVelocity + m_angularVelocity * m_model.halfAxle) };
+}
+
+Plant::Sensors Plant::sensors() const {
+    // 14 bit absolute encoders and the gyroscope's least significant bit
+    auto const encoder = [](float angle) {
+        return std::floor(angle / ENCODER_STEP) * ENCODER_STEP;
+    };
+    float const resolution = Drivers::Gyroscope::RESOLUTION;
+    // the current sense amplifiers only see the magnitude
+    auto const current = [](float current) {
+        return std::round(std::abs(current) / CURRENT_STEP) * CURRENT_STEP;
+    };
+
+    return { Vec2::transform(encoder, m_wheelAngles),
+             std::round(m_angularVelocity * resolution) / resolution,
+             std::floor(m_terminalVoltage / VOLTAGE_STEP) * VOLTAGE_STEP,
+             Vec2::transform(current, m_current) };
+}
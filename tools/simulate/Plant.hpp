@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include "control/feedforward/Feedforward.hpp"
+
+#include "profiles/Profile.hpp"
+
+#include "state/Vector.hpp"
+
+// the robot as the firmware sees it from outside: two dc motors driving a differential drive
+// chassis through tyres that slip past the friction the floor gives them, with encoders and a
+// gyroscope quantised like the real sensors. lengths in cm as in the firmware, the dynamics in si
+// underneath
+class Plant {
+public:
+    // the chassis and motors of a profile in si units
+    struct Model {
+        float wheelRadius{};
+        float halfAxle{};
+        float mass{};
+        float yawInertia{};
+        // a wheel and the motor's rotor through the gearbox, about the axle
+        float wheelInertia{};
+
+        Vec2 resistance{};
+        Vec2 kv{};
+        Vec2 freeCurrent{};
+
+        // each winding to the air around it
+        float thermalResistance{};
+        float thermalTimeConstant{};
+    };
+
+    template <RobotProfileType Profile>
+    static constexpr Model model() {
+        constexpr float CENTIMETERS = 100.0f;
+        // a 15 cm square plate with the whole mass of the chassis
+        constexpr float PLATE_SIZE = 0.15f;
+        // an n20 rotor through a 1:35 gearbox and a 30 g wheel
+        constexpr float WHEEL_INERTIA = 7.5e-5f;
+
+        using Chassis = Profile::Chassis;
+        using Current = Profile::Regulators::Current;
+
+        return { Chassis::WHEEL_RADIUS / CENTIMETERS,
+                 Chassis::AXLE_LENGTH / CENTIMETERS / 2.0f,
+                 Chassis::MASS,
+                 Chassis::MASS * PLATE_SIZE * PLATE_SIZE / 6.0f,
+                 WHEEL_INERTIA,
+                 Current::RESISTANCE,
+                 Current::KV,
+                 Current::FREE_CURRENT,
+                 Current::Thermal::RESISTANCE,
+                 Current::Thermal::TIME_CONSTANT };
+    }
+
+    struct Sensors {
+        // the wheel angles after SensorConversion::wheelAngles, forwards is positive on both
+        Vec2 wheelAngles{};
+        float angularVelocity{};
+        // as Motors reads them off the adc
+        float batteryVoltage{};
+        Vec2 motorCurrents{};
+    };
+
+    // the battery is an open circuit batteryVoltage behind batteryResistance, friction is the
+    // coefficient between the tyres and the floor
+    Plant(Model const& model, float batteryVoltage, float batteryResistance, float friction);
+
+    // power is what the slow loop hands Motors::spin, held for dt
+    void step(Vec2 const& power, float dt);
+
+    Sensors sensors() const;
+
+    Vec2 position() const { return m_position; }
+    float heading() const { return m_heading; }
+    Vec2 current() const { return m_current; }
+    // each winding in kelvin over the air around it, heated by the current it actually drew
+    Vec2 temperatures() const { return m_temperatures; }
+    // whether either tyre is sliding over the floor rather than rolling on it
+    bool slipping() const;
+
+    // from 0, the motors as they were characterised, to 1 after a run's worth of warming up
+    // over a floor that gets dustier
+    void setDrift(float drift);
+
+    // the voltage the regulator's linear axis would need for a speed in cm/s, without its right
+    // wheel offset
+    Feedforward linearFeedforward() const;
+
+private:
+    // how fast each contact patch moves over the floor, positive when the wheel spins ahead
+    Vec2 slipSpeeds() const;
+
+    Model const m_model{};
+    Vec2 m_resistance{};
+    Vec2 m_freeCurrent{};
+    float const m_batteryVoltage{};
+    float const m_batteryResistance{};
+    float const m_friction{};
+
+    Vec2 m_position{ 0.0f, 0.0f };
+    float m_heading{ Constants::PI / 2.0f };
+
+    float m_linearVelocity{};
+    float m_angularVelocity{};
+    float m_terminalVoltage{};
+
+    Vec2 m_wheelSpeeds{};
+    Vec2 m_wheelAngles{};
+    Vec2 m_current{};
+    Vec2 m_temperatures{};
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "profiles/Profile.hpp"
+#include "profiles/RobotTourV2.hpp"
+
+#include "state/Vector.hpp"
+
+// robots that only exist on the host, simulated next to the build's own so the control code is
+// known to work for a profile other than the one it was written against
+namespace Profiles {
+    // a heavier chassis on larger wheels with faster, lower resistance motors. the feedforward is
+    // rescaled for the extra speed per volt, everything else is the v2's
+    struct Heavy : RobotTourV2 {
+        struct Chassis : RobotTourV2::Chassis {
+            static constexpr float WHEEL_RADIUS = 3.5f;
+            static constexpr float MASS = 1.1f;
+        };
+
+        struct Regulators : RobotTourV2::Regulators {
+            struct Current : RobotTourV2::Regulators::Current {
+                static constexpr Vec2 RESISTANCE{ 2.8f, 2.8f };
+                static constexpr Vec2 FREE_ANGULAR_VEL{ 110.0f, 110.0f };
+                static constexpr Vec2 FREE_CURRENT{ 0.07f, 0.07f };
+
+                static constexpr Vec2 KV = FREE_ANGULAR_VEL /
+                                           (FREE_VOLTAGE - FREE_CURRENT * RESISTANCE);
+            };
+
+            struct Velocity : RobotTourV2::Regulators::Velocity {
+                struct Linear : RobotTourV2::Regulators::Velocity::Linear {
+                    static constexpr float kV = 0.027f;
+                };
+
+                struct Angular : RobotTourV2::Regulators::Velocity::Angular {
+                    static constexpr float kV = 0.51f;
+                };
+            };
+        };
+    };
+
+    static_assert(RobotProfileType<Heavy>);
+}
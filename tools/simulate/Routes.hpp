@@ -0,0 +1,129 @@
+#pragma once
+
+#include "path/Compiler.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+// the routes every change to the managers and regulators is measured against. each covers one
+// thing the follower has to get right, with a target time it can keep to
+namespace Routes {
+    using namespace Compiler::Tokens;
+
+    struct Canonical {
+        std::string_view name{};
+        std::span<Compiler::Command const> commands{};
+        float targetTime{};
+    };
+
+    template <size_t N>
+    constexpr bool isFeasible(std::array<Compiler::Command, N> const& commands, float targetTime) {
+        auto const path = Compiler::compile(commands);
+        auto const turnTimes = Compiler::TargetTime::getTurnTimes(path);
+
+        std::array<float, N> targetTimes{};
+        Compiler::getTargetTimes(commands, path, turnTimes, targetTime, targetTimes);
+
+        return Compiler::Feasibility::hasTimeToDrive(path, targetTimes, turnTimes) &&
+               Compiler::Feasibility::canStopInTime(path, targetTimes, turnTimes) &&
+               Compiler::Feasibility::withinMaxSpeed(path, targetTimes, turnTimes);
+    }
+
+    inline constexpr auto STRAIGHT = std::to_array<Compiler::Command>({
+        // clang-format off
+
+        FIRST_MOVE,
+        moveby(3.0f * UP) & LAST_MOVE
+
+        // clang-format on
+    });
+    inline constexpr float STRAIGHT_TIME = 5.0f;
+
+    // corners taken on the move, no stops until the end
+    inline constexpr auto ZIGZAG = std::to_array<Compiler::Command>({
+        // clang-format off
+
+        FIRST_MOVE,
+        moveby(RIGHT),
+        moveby(UP),
+        moveby(LEFT),
+        moveby(UP),
+        moveby(RIGHT),
+        moveby(UP),
+        moveby(LEFT),
+        moveby(UP),
+        moveby(RIGHT),
+        moveby(UP) & LAST_MOVE
+
+        // clang-format on
+    });
+    inline constexpr float ZIGZAG_TIME = 16.0f;
+
+    // every change of direction is a stop, and half of them turn on the spot as well
+    inline constexpr auto REVERSING = std::to_array<Compiler::Command>({
+        // clang-format off
+
+        FIRST_MOVE,
+        moveby(2.0f * UP),
+        moveby(DOWN) & REVERSE,
+        moveby(RIGHT),
+        moveby(LEFT) & REVERSE,
+        moveby(2.0f * UP),
+        moveby(2.0f * DOWN) & REVERSE,
+        moveby(LEFT),
+        moveby(UP) & LAST_MOVE
+
+        // clang-format on
+    });
+    inline constexpr float REVERSING_TIME = 24.0f;
+
+    // gate bonuses reached off the square centres, the way the competition macros write them
+    inline constexpr auto OFFSETS = std::to_array<Compiler::Command>({
+        // clang-format off
+
+        FIRST_MOVE,
+        moveby(UP) & OFFSET_ONCE(25.0f * DOWN),
+        moveby(0.0001f * RIGHT),
+        moveby(RIGHT) & OFFSET_ONCE(25.0f * LEFT),
+        moveby(0.0001f * UP),
+        moveby(UP),
+        moveby(LEFT) & OFFSET_ONCE(25.0f * RIGHT),
+        moveby(0.0001f * UP),
+        moveby(UP) & LAST_MOVE
+
+        // clang-format on
+    });
+    inline constexpr float OFFSETS_TIME = 14.0f;
+
+    // a serpentine across a five by five track and back down the side, as long as routes get
+    inline constexpr auto LONG = [] {
+        std::array<Compiler::Command, 26u> commands{};
+        size_t size = 0u;
+
+        commands[size++] = FIRST_MOVE;
+        for (size_t row = 0u; row < 5u; ++row) {
+            for (size_t column = 0u; column < 4u; ++column)
+                commands[size++] = moveby(row % 2u == 0u ? RIGHT : LEFT);
+            if (row < 4u) commands[size++] = moveby(UP);
+        }
+        commands[size++] = moveby(4.0f * DOWN) & LAST_MOVE;
+        return commands;
+    }();
+    inline constexpr float LONG_TIME = 40.0f;
+
+    static_assert(isFeasible(STRAIGHT, STRAIGHT_TIME));
+    static_assert(isFeasible(ZIGZAG, ZIGZAG_TIME));
+    static_assert(isFeasible(REVERSING, REVERSING_TIME));
+    static_assert(isFeasible(OFFSETS, OFFSETS_TIME));
+    static_assert(isFeasible(LONG, LONG_TIME));
+
+    inline constexpr std::array<Canonical, 5u> ALL{ {
+        { "straight", STRAIGHT, STRAIGHT_TIME },
+        { "zigzag", ZIGZAG, ZIGZAG_TIME },
+        { "reversing", REVERSING, REVERSING_TIME },
+        { "offsets", OFFSETS, OFFSETS_TIME },
+        { "long", LONG, LONG_TIME },
+    } };
+}
@@ -0,0 +1,383 @@
+#include "Constants.hpp"
+
+#include "control/feedforward/Feedforward.hpp"
+
+#include "drivers/SensorConversion.hpp"
+
+#include "kinematics/ForwardKinematics.hpp"
+
+#include "loops/FastLoop.hpp"
+#include "loops/SlowLoop.hpp"
+
+#include "path/Competition.hpp"
+#include "path/Route.hpp"
+
+#include "profiles/Profile.hpp"
+#include "profiles/Robot.hpp"
+
+#include "regulators/ThermalModel.hpp"
+
+#include "simulate/Plant.hpp"
+#include "simulate/Profiles.hpp"
+#include "simulate/Routes.hpp"
+
+#include "state/Vector.hpp"
+
+#include "tuning/Parameters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    constexpr float DEFAULT_BATTERY_VOLTAGE = 11.1f;
+    // a 3s lipo a few dozen cycles in, with its leads and switch
+    constexpr float DEFAULT_BATTERY_RESISTANCE = 0.3f;
+    // rubber on a dry classroom floor
+    constexpr float DEFAULT_FRICTION = 0.8f;
+
+    // past this the route is counted as never arriving
+    constexpr float TIMEOUT_FACTOR = 2.0f;
+    constexpr float TIMEOUT_MARGIN = 5.0f;
+
+    constexpr double TAIL = 0.99;
+
+    // a tick's cost on this machine. the mean and the 99th percentile are what a change to the
+    // loops moves, the maximum is whatever the operating system did at the time
+    struct Cost {
+        std::vector<double> ticks{};
+
+        void add(double seconds) { ticks.push_back(seconds); }
+
+        double mean() const {
+            if (ticks.empty()) return 0.0;
+            return std::accumulate(ticks.begin(), ticks.end(), 0.0) /
+                   static_cast<double>(ticks.size());
+        }
+
+        double percentile(double fraction) {
+            if (ticks.empty()) return 0.0;
+            double const index = fraction * static_cast<double>(ticks.size() - 1u);
+            auto const nth = ticks.begin() + static_cast<ptrdiff_t>(index);
+            std::nth_element(ticks.begin(), nth, ticks.end());
+            return *nth;
+        }
+    };
+
+    // what every route is driven under
+    struct Conditions {
+        float batteryVoltage{};
+        float batteryResistance{};
+        float friction{};
+        // the plant drifts from as characterised to warmed up over the route's target time
+        bool drift{};
+        bool adaptFeedforward{};
+    };
+
+    // the feedforward the loop ended on next to what the plant needed by then
+    struct Adaptation {
+        Feedforward settled{};
+        Feedforward plant{};
+    };
+
+    struct Result {
+        std::optional<float> arrivalTime{};
+        float positionError{ 0.0f };
+        float peakCurrent{ 0.0f };
+        // how long the tyres slid and how long the fast loop said they did
+        float slipTime{ 0.0f };
+        float detectedSlipTime{ 0.0f };
+        // the hottest either winding got as a share of its budget, and what the current limit
+        // thought it got to
+        float heat{ 0.0f };
+        float modelledHeat{ 0.0f };
+        std::optional<Adaptation> adaptation{};
+        Cost fastCost{};
+        Cost slowCost{};
+    };
+
+    template <typename F>
+    double timed(F&& f) {
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // both loops run off the same clock as on the robot, the fast loop at its own rate publishing a
+    // state the slow loop picks up stateAge later. the plant is stepped up to each tick with the
+    // power the slow loop last set, and held at zero for the final measurement like main does
+    template <RobotProfileType Profile>
+    Result simulate(Route const& route, Conditions const& conditions) {
+        using Integration::FINAL_STATE_MEASUREMENT_DELAY;
+        using Integration::SLOW_LOOP_DT;
+        using Integration::TARGET_FAST_LOOP_DT;
+
+        constexpr Vec2 MAX_TEMPERATURES = BasicThermalModel<Profile>::maxTemperatures();
+        auto const heat = [&](Vec2 const& temperatures) {
+            Vec2 const shares = temperatures / MAX_TEMPERATURES;
+            return std::max(shares.x, shares.y);
+        };
+
+        Plant plant{ Plant::model<Profile>(), conditions.batteryVoltage,
+                     conditions.batteryResistance, conditions.friction };
+        BasicFastLoop<Profile> fastLoop{ plant.sensors().wheelAngles, TARGET_FAST_LOOP_DT };
+        BasicSlowLoop<Profile> slowLoop{ route.path(), route.targetTimes(), SLOW_LOOP_DT,
+                                         conditions.adaptFeedforward };
+
+        typename BasicFastLoop<Profile>::State state{};
+        Vec2 power{};
+
+        size_t fastTicks = 0u;
+        size_t slowTicks = 0u;
+        double now = 0.0;
+        double captureTime = 0.0;
+
+        Result result{};
+        auto const advance = [&](double time) {
+            float const dt = static_cast<float>(time - now);
+            if (conditions.drift)
+                plant.setDrift(std::min(static_cast<float>(time) / route.targetTime(), 1.0f));
+            plant.step(power, dt);
+            now = time;
+
+            if (plant.slipping()) result.slipTime += dt;
+            if (state.slipping) result.detectedSlipTime += dt;
+
+            Vec2 const current = plant.current();
+            result.peakCurrent = std::max({ result.peakCurrent, std::abs(current.x),
+                                            std::abs(current.y) });
+            result.heat = std::max(result.heat, heat(plant.temperatures()));
+        };
+
+        double const timeout = route.targetTime() * TIMEOUT_FACTOR + TIMEOUT_MARGIN;
+
+        while (!result.arrivalTime && now < timeout) {
+            double const nextFast = static_cast<double>(fastTicks) * TARGET_FAST_LOOP_DT;
+            double const nextSlow = static_cast<double>(slowTicks) * SLOW_LOOP_DT;
+
+            if (nextFast <= nextSlow) {
+                advance(nextFast);
+                Plant::Sensors const sensors = plant.sensors();
+
+                result.fastCost.add(timed([&] {
+                    state = fastLoop.update(sensors.wheelAngles, sensors.angularVelocity);
+                }));
+                captureTime = now;
+                ++fastTicks;
+                continue;
+            }
+
+            advance(nextSlow);
+            float const stateAge = static_cast<float>(now - captureTime);
+            float const elapsed = static_cast<float>(now);
+
+            // as main reads them, the boot voltage standing in for the pack at rest without the
+            // sag model
+            Plant::Sensors const sensors = plant.sensors();
+            float const batteryVoltage = Integration::BATTERY_SAG_MODEL
+                                             ? sensors.batteryVoltage
+                                             : conditions.batteryVoltage;
+            float const batteryCurrent = SensorConversion::batteryCurrent(
+                power / static_cast<float>(Drivers::Motors::MAX_POWER), sensors.motorCurrents);
+
+            Vec2 motorPower{};
+            result.slowCost.add(timed([&] {
+                motorPower = slowLoop.update(state, stateAge, elapsed, batteryVoltage,
+                                             batteryCurrent);
+            }));
+            // truncated to the duty cycle the way motors.spin takes it
+            power = { static_cast<float>(static_cast<int>(motorPower.x)),
+                      static_cast<float>(static_cast<int>(motorPower.y)) };
+
+            result.modelledHeat = std::max(result.modelledHeat,
+                                           heat(slowLoop.motorTemperatures()));
+
+            if (slowLoop.finished()) result.arrivalTime = elapsed;
+            ++slowTicks;
+        }
+
+        power = {};
+        double const settled = now + FINAL_STATE_MEASUREMENT_DELAY;
+        while (now < settled) advance(std::min(now + TARGET_FAST_LOOP_DT, settled));
+
+        result.positionError = (plant.position() - route.destination()).length();
+        if (auto const& estimator = slowLoop.feedforwardEstimator())
+            result.adaptation = { estimator->feedforward(), plant.linearFeedforward() };
+        return result;
+    }
+
+    // the build's own robot, tunable with --set, and the host only ones built next to it
+    struct Simulated {
+        std::string_view name{};
+        Result (*simulate)(Route const&, Conditions const&){};
+    };
+
+    constexpr std::array<Simulated, 2> PROFILES{ {
+        { "robot", simulate<Robot> },
+        { "heavy", simulate<Profiles::Heavy> },
+    } };
+
+    // name=value, the same bounds the robot enforces
+    bool setParameter(std::string_view assignment) {
+        size_t const separator = assignment.find('=');
+        if (separator == std::string_view::npos) return false;
+
+        auto const id = Parameters::find(assignment.substr(0u, separator));
+        std::string const value{ assignment.substr(separator + 1u) };
+        return id && Parameters::set(*id, std::stof(value));
+    }
+
+    void printAdaptation(Adaptation const& adaptation) {
+        auto const& [settled, plant] = adaptation;
+        std::println("{:>18} kS {:.3f} ({:.3f}) kV {:.4f} ({:.4f}) kA {:.5f} ({:.5f})", "linear",
+                     settled.kS, plant.kS, settled.kV, plant.kV, settled.kA, plant.kA);
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-simulate [--battery <volts>] [--battery-resistance <ohms>]\n"
+                     "                       [--friction <coefficient>] [--drift] [--adapt]\n"
+                     "                       [--csv <file>]\n"
+                     "                       [--profile <name>]... [--set <name>=<value>]...\n"
+                     "                       [<route>...]\n"
+                     "\n"
+                     "drives the canonical routes through the firmware loops against a simulated\n"
+                     "robot and reports how far off the end it stopped, how late it arrived, the\n"
+                     "peak motor current, how long the tyres slipped against how long the robot\n"
+                     "noticed, how much of its heat budget the hotter winding used against what\n"
+                     "the current limit modelled, and what each loop tick cost on this machine\n"
+                     "(mean/99th percentile). fails if a route never finishes\n"
+                     "\n"
+                     "routes: straight, zigzag, reversing, offsets, long (all by default)\n"
+                     "profiles: robot (the one the tools were built for), heavy (all by default)\n"
+                     "--battery is the open circuit voltage of the pack, 11.1 by default, and\n"
+                     "--battery-resistance what it sags by per amp, 0.3 by default\n"
+                     "--friction is between the tyres and the floor, 0.8 by default\n"
+                     "--drift warms the motors up and dusts the floor over each route\n"
+                     "--adapt refines the linear feedforward as it drives and prints what it\n"
+                     "settled on next to what the plant needed at the end\n"
+                     "--csv writes the same results one route per line\n"
+                     "--set changes a tunable parameter of robot, rotour-cli params lists them");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    Conditions conditions{ DEFAULT_BATTERY_VOLTAGE, DEFAULT_BATTERY_RESISTANCE, DEFAULT_FRICTION,
+                           false, false };
+    std::string csvFilename{};
+    std::vector<Routes::Canonical> routes{};
+    std::vector<Simulated> profiles{};
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        bool const hasValue = i + 1u < arguments.size();
+
+        auto const canonical = std::ranges::find(Routes::ALL, argument, &Routes::Canonical::name);
+
+        if (argument == "--battery" && hasValue)
+            conditions.batteryVoltage = std::stof(arguments[++i]);
+        else if (argument == "--battery-resistance" && hasValue)
+            conditions.batteryResistance = std::stof(arguments[++i]);
+        else if (argument == "--friction" && hasValue)
+            conditions.friction = std::stof(arguments[++i]);
+        else if (argument == "--drift") conditions.drift = true;
+        else if (argument == "--adapt") conditions.adaptFeedforward = true;
+        else if (argument == "--csv" && hasValue) csvFilename = arguments[++i];
+        else if (argument == "--profile" && hasValue) {
+            std::string_view const name = arguments[++i];
+            auto const profile = std::ranges::find(PROFILES, name, &Simulated::name);
+            if (profile == PROFILES.end()) {
+                usage();
+                return 1;
+            }
+            profiles.push_back(*profile);
+        }
+        else if (argument == "--set" && hasValue) {
+            if (!setParameter(arguments[++i])) {
+                std::println(stderr, "cannot set {}", arguments[i]);
+                return 1;
+            }
+        } else if (canonical != Routes::ALL.end()) routes.push_back(*canonical);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (routes.empty()) routes.assign(Routes::ALL.begin(), Routes::ALL.end());
+    if (profiles.empty()) profiles.assign(PROFILES.begin(), PROFILES.end());
+
+    std::FILE* csv = nullptr;
+    if (!csvFilename.empty()) {
+        csv = std::fopen(csvFilename.c_str(), "w");
+        if (!csv) {
+            std::println(stderr, "cannot write {}", csvFilename);
+            return 1;
+        }
+        std::println(csv, "profile,route,target time,arrival time,time error,position error,"
+                          "peak current,slip time,detected slip time,heat,modelled heat,"
+                          "fast mean us,fast p99 us,slow mean us,slow p99 us");
+    }
+
+    // the route is too big for the stack
+    static Route route{ Competition::COMMANDS, Competition::TARGET_TIME };
+
+    std::println("{:<7} {:<10} {:>9} {:>9} {:>9} {:>8} {:>11} {:>11} {:>13} {:>13}", "profile",
+                 "route", "arrival", "late", "error", "current", "slip/seen", "heat/model",
+                 "fast tick", "slow tick");
+
+    bool passed = true;
+    for (Simulated const& profile : profiles) {
+        for (Routes::Canonical const& canonical : routes) {
+            route.setCommands(canonical.commands);
+            route.setTargetTime(canonical.targetTime);
+
+            Result result = profile.simulate(route, conditions);
+            passed = passed && result.arrivalTime.has_value();
+
+            // nan marks a route that never arrived, so it cannot pass for a good time in the csv
+            float const arrivalTime = result.arrivalTime.value_or(NAN);
+            float const timeError = arrivalTime - canonical.targetTime;
+
+            double const microseconds = 1.0e6;
+            double const fastMean = result.fastCost.mean() * microseconds;
+            double const fastTail = result.fastCost.percentile(TAIL) * microseconds;
+            double const slowMean = result.slowCost.mean() * microseconds;
+            double const slowTail = result.slowCost.percentile(TAIL) * microseconds;
+
+            double const percent = 100.0;
+            double const heat = result.heat * percent;
+            double const modelledHeat = result.modelledHeat * percent;
+
+            std::println("{:<7} {:<10} {:>7.3f} s {:>+7.3f} s {:>6.2f} cm {:>6.2f} A "
+                         "{:>4.2f}/{:>4.2f} s {:>4.0f}/{:>4.0f} % {:>5.2f}/{:>5.2f} us "
+                         "{:>5.2f}/{:>5.2f} us",
+                         profile.name, canonical.name, arrivalTime, timeError, result.positionError,
+                         result.peakCurrent, result.slipTime, result.detectedSlipTime, heat,
+                         modelledHeat, fastMean, fastTail, slowMean, slowTail);
+            if (result.adaptation) printAdaptation(*result.adaptation);
+
+            if (csv)
+                std::println(csv, "{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}", profile.name,
+                             canonical.name, canonical.targetTime, arrivalTime, timeError,
+                             result.positionError, result.peakCurrent, result.slipTime,
+                             result.detectedSlipTime, result.heat, result.modelledHeat, fastMean,
+                             fastTail, slowMean, slowTail);
+        }
+    }
+
+    if (csv) std::fclose(csv);
+    return passed ? 0 : 1;
+}
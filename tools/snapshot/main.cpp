@@ -0,0 +1,235 @@
+#include "drivers/Snapshot.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// checks Snapshot against the channel chain SnapshotDma::start sets up, with the channels stepped
+// in software. the host has to keep each thread's stores in order the way the dma does, which
+// x86 does and the fences between channels ask for elsewhere
+namespace {
+    constexpr size_t WORDS = 3u;
+    constexpr uint64_t DEFAULT_SAMPLES = 2'000'000u;
+
+    // the sequence wraps twice over
+    constexpr uint64_t ORDER_SAMPLES = 600u;
+
+    // how far the channels may run ahead of the last whole read. a reader stalled for 256
+    // samples is the one case Snapshot cannot catch, and a host thread can be descheduled for
+    // that long, so the channels wait for it the way a 1 kHz source would never need to
+    constexpr uint64_t MAX_LEAD = 128u;
+
+    // how often the channels let a reader sharing their core in between one another
+    constexpr uint64_t PAUSE_EVERY = 16u;
+
+    enum class Channel { DATA, SEQUENCE, SELECT };
+    using Order = std::array<Channel, 3>;
+
+    // the chain_to order SnapshotDma::start configures
+    constexpr Order CHAIN{ Channel::DATA, Channel::SEQUENCE, Channel::SELECT };
+
+    constexpr std::array<Order, 6> ORDERS{ {
+        { Channel::DATA, Channel::SEQUENCE, Channel::SELECT },
+        { Channel::DATA, Channel::SELECT, Channel::SEQUENCE },
+        { Channel::SEQUENCE, Channel::DATA, Channel::SELECT },
+        { Channel::SEQUENCE, Channel::SELECT, Channel::DATA },
+        { Channel::SELECT, Channel::DATA, Channel::SEQUENCE },
+        { Channel::SELECT, Channel::SEQUENCE, Channel::DATA },
+    } };
+
+    std::string_view name(Channel channel) {
+        switch (channel) {
+        case Channel::DATA: return "data";
+        case Channel::SEQUENCE: return "sequence";
+        case Channel::SELECT: return "select";
+        }
+        return "";
+    }
+
+    // every word of every sample differs, and a whole sample counts up from its first word
+    uint32_t word(uint64_t sample, size_t i) { return static_cast<uint32_t>(sample * WORDS + i); }
+
+    // the three channels as SnapshotDma::start leaves them: the data channel on buffer 0, the
+    // sequence channel on number 0 and the select channel on the address of buffer 1, the last
+    // two reading in their rings
+    class Chain {
+    public:
+        explicit Chain(Snapshot<WORDS>& snapshot)
+            : m_snapshot{ snapshot }, m_write{ snapshot.buffer(0u) } {}
+
+        // one sample through the channels in order, yielding after each when asked to pause.
+        // false if the data channel wrote the buffer the sequence pointed readers at, or the
+        // sequence moved onto a buffer not holding the sample it numbers
+        bool step(Order const& order, uint64_t sample, bool pause = false) {
+            bool consistent = true;
+            for (Channel channel : order) {
+                switch (channel) {
+                case Channel::DATA:
+                    for (size_t i = 0u; i < WORDS; ++i) {
+                        consistent = consistent && m_write != published();
+                        m_write[i] = word(sample, i);
+                    }
+                    break;
+                case Channel::SEQUENCE:
+                    *m_snapshot.sequence() = m_sequence++;
+                    for (size_t i = 0u; i < WORDS; ++i)
+                        consistent = consistent && published()[i] == word(sample, i);
+                    break;
+                case Channel::SELECT:
+                    m_write = m_snapshot.addresses()[m_select];
+                    m_select ^= 1u;
+                    break;
+                }
+
+                // a channel only chains once its writes are done
+                std::atomic_thread_fence(std::memory_order_release);
+                if (pause) std::this_thread::yield();
+            }
+            return consistent;
+        }
+
+    private:
+        uint32_t volatile* published() { return m_snapshot.buffer(*m_snapshot.sequence() & 1u); }
+
+        Snapshot<WORDS>& m_snapshot;
+        uint32_t volatile* m_write;
+        uint8_t m_sequence{ 0u };
+        size_t m_select{ 1u };
+    };
+
+    bool consistent(Order const& order) {
+        Snapshot<WORDS> snapshot{};
+        Chain chain{ snapshot };
+        for (uint64_t sample = 0u; sample < ORDER_SAMPLES; ++sample)
+            if (!chain.step(order, sample)) return false;
+        return true;
+    }
+
+    // every order of the channels stepped alone. the chain has to come out whole, and so that
+    // the check can fail at all, no order publishing before the data may
+    bool orders() {
+        bool passed = true;
+        std::println("{:<28} {}", "order", "result");
+        for (Order const& order : ORDERS) {
+            bool const whole = consistent(order);
+            bool const early = order[0] == Channel::SEQUENCE ||
+                               (order[0] == Channel::SELECT && order[1] == Channel::SEQUENCE);
+
+            std::println("{:<28} {}{}",
+                         std::string{ name(order[0]) } + ", " + std::string{ name(order[1]) } +
+                             ", " + std::string{ name(order[2]) },
+                         whole ? "whole" : "torn", order == CHAIN ? "  <- SnapshotDma" : "");
+            if (order == CHAIN) passed = passed && whole;
+            if (early) passed = passed && !whole;
+        }
+        return passed;
+    }
+
+    struct Reads {
+        uint64_t count{ 0u };
+        uint64_t torn{ 0u };
+        uint64_t backwards{ 0u };
+        uint64_t mismatched{ 0u };
+    };
+
+    // the channels on one thread and Snapshot::read spinning on another
+    Reads stress(Order const& order, uint64_t samples) {
+        Snapshot<WORDS> snapshot{};
+        std::atomic<uint64_t> lastRead{ 0u };
+        std::atomic<bool> done{ false };
+
+        std::thread channels{ [&]() {
+            Chain chain{ snapshot };
+            for (uint64_t sample = 0u; sample < samples; ++sample) {
+                while (sample > lastRead.load(std::memory_order_acquire) + MAX_LEAD)
+                    std::this_thread::yield();
+                chain.step(order, sample, sample % PAUSE_EVERY == 0u);
+            }
+            done.store(true, std::memory_order_release);
+        } };
+
+        Reads reads{};
+        std::optional<uint64_t> last{};
+        while (!done.load(std::memory_order_acquire)) {
+            uint8_t sequence{};
+            std::array<uint32_t, WORDS> const sample = snapshot.read(sequence);
+            ++reads.count;
+
+            // zeros under 0xff until the first sample is published, and never after
+            if (sample == std::array<uint32_t, WORDS>{}) {
+                if (last || sequence != 0xffu) ++reads.torn;
+                continue;
+            }
+
+            bool whole = true;
+            for (size_t i = 1u; i < WORDS; ++i) whole = whole && sample[i] == sample[0] + i;
+            if (!whole) {
+                ++reads.torn;
+                continue;
+            }
+
+            uint64_t const number = sample[0] / WORDS;
+            if (static_cast<uint8_t>(number) != sequence) ++reads.mismatched;
+            if (last && number < *last) ++reads.backwards;
+
+            // nothing new, so let the channels run if they share the core
+            if (last == number) std::this_thread::yield();
+            last = number;
+            lastRead.store(number, std::memory_order_release);
+        }
+
+        channels.join();
+        return reads;
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-snapshot [--samples <n>]\n"
+                     "\n"
+                     "steps SnapshotDma's three channels in software, first in every order to "
+                     "show\nonly the chain publishes whole samples, then against Snapshot::read "
+                     "on another\nthread ({} samples by default). fails on a torn read, a read "
+                     "older than the\none before, or a sequence number for another sample, and "
+                     "if the same reads\nmiss a chain that publishes before the data",
+                     DEFAULT_SAMPLES);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    uint64_t samples = DEFAULT_SAMPLES;
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        if (argument == "--samples" && i + 1u < arguments.size())
+            samples = std::stoull(arguments[++i]);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    bool passed = orders();
+
+    auto const print = [&](std::string_view chain, Reads const& reads) {
+        std::println("{}: {} reads over {} samples, {} torn, {} out of order, {} on another "
+                     "sample's sequence",
+                     chain, reads.count, samples, reads.torn, reads.backwards, reads.mismatched);
+        return reads.torn + reads.backwards + reads.mismatched;
+    };
+
+    // and the same against a chain publishing first, which the reads have to catch
+    passed = print("SnapshotDma", stress(CHAIN, samples)) == 0u && passed;
+    passed = print("sequence first",
+                   stress({ Channel::SEQUENCE, Channel::DATA, Channel::SELECT }, samples)) > 0u &&
+             passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "Constants.hpp"
+
+#include "cli/SerialTransport.hpp"
+
+#include "comms/Frame.hpp"
+#include "comms/Protocol.hpp"
+
+#include "telemetry/Telemetry.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace {
+    constexpr double DEFAULT_IDLE_TIME = 2.0;
+
+    struct Totals {
+        size_t received{ 0u };
+        std::optional<Telemetry::Sample> first{};
+        std::optional<Telemetry::Sample> last{};
+    };
+
+    double now() {
+        return std::chrono::duration<double>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // the indices count every sample the robot took, so whatever is missing between the first and
+    // the last that the robot did not drop was lost on the link
+    void report(Totals const& totals) {
+        if (!totals.first) {
+            std::println("no telemetry received");
+            return;
+        }
+
+        size_t const taken = totals.last->index - totals.first->index + 1u;
+        size_t const dropped = totals.last->dropped - totals.first->dropped;
+        size_t const lost = taken - dropped - totals.received;
+
+        std::println("{} samples received over {:.3f} s, {} dropped by the robot, {} lost on the "
+                     "link",
+                     totals.received, totals.last->elapsed - totals.first->elapsed, dropped, lost);
+    }
+
+    void usage() {
+        std::println(stderr,
+                     "usage: rotour-telemetry --port <device> [--csv <file>] [--idle <seconds>]\n"
+                     "\n"
+                     "receives the telemetry the robot streams while it drives and reports how\n"
+                     "many samples were dropped on the robot or lost on the way. waits for the\n"
+                     "run to start and stops once nothing has arrived for the idle time (2 s)\n"
+                     "\n"
+                     "--csv writes every sample with the unix time it was received");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::span<char const* const> arguments{ argv + 1, static_cast<size_t>(argc - 1) };
+
+    std::string port{};
+    std::string csvFilename{};
+    double idleTime = DEFAULT_IDLE_TIME;
+
+    for (size_t i = 0u; i < arguments.size(); ++i) {
+        std::string_view const argument = arguments[i];
+        bool const hasValue = i + 1u < arguments.size();
+
+        if (argument == "--port" && hasValue) port = arguments[++i];
+        else if (argument == "--csv" && hasValue) csvFilename = arguments[++i];
+        else if (argument == "--idle" && hasValue) idleTime = std::stod(arguments[++i]);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (port.empty()) {
+        usage();
+        return 1;
+    }
+
+    SerialTransport transport{ port };
+    if (!transport.isOpen()) {
+        std::println(stderr, "cannot open {}", port);
+        return 1;
+    }
+
+    std::FILE* csv = nullptr;
+    if (!csvFilename.empty()) {
+        csv = std::fopen(csvFilename.c_str(), "w");
+        if (!csv) {
+            std::println(stderr, "cannot write {}", csvFilename);
+            return 1;
+        }
+        std::println(csv, "received,index,dropped,elapsed,x,y,velocity x,velocity y,angle,"
+                          "angular velocity,target left,target right,voltage left,voltage right,"
+                          "segment");
+    }
+
+    Frame::Decoder decoder{};
+    Totals totals{};
+    double lastReceived = now();
+
+    // the robot prints text over the same port once it has finished, which never decodes
+    while (!totals.first || now() - lastReceived < idleTime) {
+        auto const byte = transport.read();
+        if (!byte) continue;
+
+        auto const payload = decoder.push(*byte);
+        if (!payload) continue;
+
+        Protocol::Reader reader{ *payload };
+        auto const type = reader.read<uint8_t>();
+        auto const sequence = reader.read<uint8_t>();
+        if (!sequence || static_cast<Protocol::Message>(*type) != Protocol::Message::TELEMETRY)
+            continue;
+
+        auto const sample = reader.readTelemetrySample();
+        if (!sample) continue;
+
+        lastReceived = now();
+        ++totals.received;
+        if (!totals.first) totals.first = sample;
+        totals.last = sample;
+
+        if (csv)
+            std::println(csv, "{:.6f},{},{},{},{},{},{},{},{},{},{},{},{},{},{}", lastReceived,
+                         sample->index, sample->dropped, sample->elapsed, sample->position.x,
+                         sample->position.y, sample->velocity.x, sample->velocity.y,
+                         sample->angle, sample->angularVelocity, sample->targetSpeeds.x,
+                         sample->targetSpeeds.y, sample->targetVoltages.x,
+                         sample->targetVoltages.y, sample->segment);
+    }
+
+    if (csv) std::fclose(csv);
+    report(totals);
+    return totals.first ? 0 : 1;
+}